@@ -0,0 +1,624 @@
+#include "epd_reader.hpp"
+#include "newline_scan.hpp"
+#include "nnue.hpp"
+#include "packed_position.hpp"
+#include "parallel_search.hpp"
+#include "perft.hpp"
+#include "perft_cache.hpp"
+#include "pgn_reader.hpp"
+#include "position.hpp"
+#include "search.hpp"
+#include "slider_attacks.hpp"
+#include "slider_fill.hpp"
+#include "thread_pool.hpp"
+#include "transposition_table.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace po = boost::program_options;
+
+using SearchConfiguration = std::pair<std::string, SearchOptions>;
+
+namespace
+{
+const std::vector<std::string> DEFAULT_FENS{
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+void bench_move_generation(const std::vector<std::string> &fens, std::uint64_t iterations)
+{
+    std::uint64_t total_moves{0};
+    const auto start{std::chrono::steady_clock::now()};
+    for (const auto &fen : fens)
+    {
+        const Position position{FenParser{fen}};
+        for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+        {
+            total_moves += position.get_moves().size();
+        }
+    }
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    std::uint64_t total_counted_moves{0};
+    const auto count_start{std::chrono::steady_clock::now()};
+    for (const auto &fen : fens)
+    {
+        const Position position{FenParser{fen}};
+        for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+        {
+            total_counted_moves += position.count_moves();
+        }
+    }
+    const std::chrono::duration<double> count_elapsed{std::chrono::steady_clock::now() - count_start};
+
+    const auto calls{static_cast<double>(fens.size() * iterations)};
+    std::cout << "Slider attacks: " << SliderAttacks::get_backend() << '\n';
+    std::cout << "Move generation: " << calls / elapsed.count() << " calls/s, "
+              << static_cast<double>(total_moves) / elapsed.count() << " moves/s\n";
+    std::cout << "Move counting: " << calls / count_elapsed.count() << " calls/s, "
+              << static_cast<double>(total_counted_moves) / count_elapsed.count() << " moves/s\n";
+}
+
+/*
+Parsing alone with one parser reused for every FEN, then building a whole position from each, the way positions are
+loaded for analysis and tuning
+*/
+void bench_fen_parsing(const std::vector<std::string> &fens, std::uint64_t iterations)
+{
+    FenParser fen_parser{};
+    BitBoard checksum{0};
+    const auto start{std::chrono::steady_clock::now()};
+    for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+    {
+        for (const auto &fen : fens)
+        {
+            const auto error{fen_parser.parse(fen)};
+            if (error != FenError::NoFenError)
+            {
+                std::cerr << "FEN " << fen << " has an " << error << '\n';
+                return;
+            }
+            checksum += fen_parser.get_piece_bit_board(Player::White, Piece::King);
+        }
+    }
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    const auto position_start{std::chrono::steady_clock::now()};
+    for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+    {
+        for (const auto &fen : fens)
+        {
+            fen_parser.parse(fen);
+            const Position position{fen_parser};
+            checksum += position.get_key();
+        }
+    }
+    const std::chrono::duration<double> position_elapsed{std::chrono::steady_clock::now() - position_start};
+
+    const auto positions{static_cast<double>(fens.size() * iterations)};
+    std::cout << "FEN parsing: " << positions / elapsed.count() << " positions/s\n";
+    std::cout << "Positions from FENs: " << positions / position_elapsed.count() << " positions/s (checksum "
+              << checksum << ")\n";
+}
+
+/*
+Packing and unpacking just the pieces with each backend, then building whole positions from packed ones to compare
+with building them from FENs
+*/
+void bench_packing(const std::vector<std::string> &fens, std::uint64_t iterations)
+{
+    std::vector<Position> positions{};
+    std::vector<PackedPosition> packed_positions{};
+    for (const auto &fen : fens)
+    {
+        positions.emplace_back(FenParser{fen});
+        packed_positions.push_back(positions.back().pack());
+    }
+
+    const auto num_positions{static_cast<double>(fens.size() * iterations)};
+    BitBoard checksum{0};
+    const auto pack_start{std::chrono::steady_clock::now()};
+    for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+    {
+        for (const auto &position : positions)
+        {
+            checksum += position.pack().get_halfmove_clock();
+        }
+    }
+    const std::chrono::duration<double> pack_elapsed{std::chrono::steady_clock::now() - pack_start};
+    std::cout << "Packing: " << num_positions / pack_elapsed.count() << " positions/s\n";
+
+    const auto bench_unpack{[&](PackingBackend backend, auto unpack_piece_bit_boards) {
+        const auto start{std::chrono::steady_clock::now()};
+        for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+        {
+            for (const auto &packed_position : packed_positions)
+            {
+                checksum += unpack_piece_bit_boards(packed_position)[Player::White][Piece::King];
+            }
+        }
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+        std::cout << "Unpacking pieces with the " << backend << " backend: " << num_positions / elapsed.count()
+                  << " positions/s\n";
+    }};
+    bench_unpack(PackingBackend::ScalarPacking, [](const PackedPosition &packed_position) {
+        return packed_position.unpack_piece_bit_boards<PackingBackend::ScalarPacking>();
+    });
+    if (PackedPosition::is_backend_supported(PackingBackend::Bmi2Packing))
+    {
+        bench_unpack(PackingBackend::Bmi2Packing, [](const PackedPosition &packed_position) {
+            return packed_position.unpack_piece_bit_boards<PackingBackend::Bmi2Packing>();
+        });
+    }
+
+    const auto position_start{std::chrono::steady_clock::now()};
+    for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+    {
+        for (const auto &packed_position : packed_positions)
+        {
+            checksum += Position{packed_position}.get_key();
+        }
+    }
+    const std::chrono::duration<double> position_elapsed{std::chrono::steady_clock::now() - position_start};
+    std::cout << "Positions from packed positions: " << num_positions / position_elapsed.count()
+              << " positions/s (checksum " << checksum << ")\n";
+}
+
+/*
+Reading a whole position file on one thread, then split across the pool. The callback does nothing, so this is the
+cost of getting positions out of the file and nothing else.
+*/
+void bench_epd(const std::string &path, std::size_t num_threads)
+{
+    const EpdReader epd_reader{path};
+    const auto callback{[](const EpdLine &, const FenParser &) {}};
+
+    ThreadPool thread_pool{num_threads};
+    for (const auto use_thread_pool : {false, true})
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        const auto statistics{use_thread_pool ? epd_reader.read(thread_pool, callback) : epd_reader.read(callback)};
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+        std::cout << "EPD reading with " << (use_thread_pool ? thread_pool.get_num_threads() : 1) << " threads and "
+                  << NewlineScan::get_backend() << " newline scan: " << statistics.positions << " positions in "
+                  << elapsed.count() << "s (" << static_cast<double>(statistics.positions) / elapsed.count()
+                  << " positions/s, " << statistics.invalid_lines << " invalid lines)\n";
+    }
+}
+
+/*
+Replaying every game in a PGN file on one thread, then split across the pool, with callbacks that do nothing
+*/
+void bench_pgn(const std::string &path, std::size_t num_threads)
+{
+    const PgnReader pgn_reader{path};
+    const auto move_callback{[](const PgnGame &, const Position &, Move) {}};
+
+    ThreadPool thread_pool{num_threads};
+    for (const auto use_thread_pool : {false, true})
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        const auto statistics{use_thread_pool ? pgn_reader.read(thread_pool, move_callback)
+                                              : pgn_reader.read(move_callback)};
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+        std::cout << "PGN reading with " << (use_thread_pool ? thread_pool.get_num_threads() : 1)
+                  << " threads: " << statistics.games << " games and " << statistics.moves << " moves in "
+                  << elapsed.count() << "s (" << static_cast<double>(statistics.games) / elapsed.count()
+                  << " games/s, " << static_cast<double>(statistics.moves) / elapsed.count() << " moves/s, "
+                  << statistics.invalid_games << " invalid games)\n";
+    }
+}
+
+struct Sliders
+{
+    BitBoard diagonal_sliders_bit_board;
+    BitBoard orthogonal_sliders_bit_board;
+    BitBoard occupied_bit_board;
+};
+
+/*
+One side's sliders at a time, the way the opponent attack map is built during move generation
+*/
+std::vector<Sliders> get_sliders(const std::vector<std::string> &fens)
+{
+    std::vector<Sliders> sliders{};
+    for (const auto &fen : fens)
+    {
+        const FenParser fen_parser{fen};
+        BitBoard occupied_bit_board{0};
+        for (const auto player : {Player::White, Player::Black})
+        {
+            for (const auto piece : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King})
+            {
+                occupied_bit_board |= fen_parser.get_piece_bit_board(player, piece);
+            }
+        }
+
+        for (const auto player : {Player::White, Player::Black})
+        {
+            const auto queens_bit_board{fen_parser.get_piece_bit_board(player, Piece::Queen)};
+            const Sliders player_sliders{fen_parser.get_piece_bit_board(player, Piece::Bishop) | queens_bit_board,
+                                         fen_parser.get_piece_bit_board(player, Piece::Rook) | queens_bit_board,
+                                         occupied_bit_board};
+            sliders.push_back(player_sliders);
+        }
+    }
+
+    return sliders;
+}
+
+template <typename F>
+void bench_attack_map(const std::string &name, const std::vector<Sliders> &sliders, std::uint64_t iterations,
+                      F get_attacks_bit_board)
+{
+    BitBoard checksum{0};
+    const auto start{std::chrono::steady_clock::now()};
+    for (std::uint64_t iteration{0}; iteration < iterations; ++iteration)
+    {
+        for (const auto &player_sliders : sliders)
+        {
+            /*
+            Varies the occupancy so the compiler can't hoist the work out of the loop
+            */
+            checksum += get_attacks_bit_board(player_sliders.diagonal_sliders_bit_board,
+                                              player_sliders.orthogonal_sliders_bit_board,
+                                              player_sliders.occupied_bit_board ^ (iteration & 1));
+        }
+    }
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    const auto calls{static_cast<double>(sliders.size() * iterations)};
+    std::cout << name << ": " << calls / elapsed.count() << " attack maps/s (checksum " << checksum << ")\n";
+}
+
+BitBoard get_lookup_attacks_bit_board(BitBoard diagonal_sliders_bit_board, BitBoard orthogonal_sliders_bit_board,
+                                      BitBoard occupied_bit_board)
+{
+    BitBoard attacks_bit_board{0};
+    while (diagonal_sliders_bit_board)
+    {
+        const auto from{static_cast<SquareUnderlying>(std::countr_zero(diagonal_sliders_bit_board))};
+        attacks_bit_board |= SliderAttacks::get_bishop_attacks_bit_board(from, occupied_bit_board);
+        diagonal_sliders_bit_board &= diagonal_sliders_bit_board - 1;
+    }
+    while (orthogonal_sliders_bit_board)
+    {
+        const auto from{static_cast<SquareUnderlying>(std::countr_zero(orthogonal_sliders_bit_board))};
+        attacks_bit_board |= SliderAttacks::get_rook_attacks_bit_board(from, occupied_bit_board);
+        orthogonal_sliders_bit_board &= orthogonal_sliders_bit_board - 1;
+    }
+
+    return attacks_bit_board;
+}
+
+void bench_attack_maps(const std::vector<std::string> &fens, std::uint64_t iterations)
+{
+    const auto sliders{get_sliders(fens)};
+
+    std::cout << "Slider attacks: " << SliderAttacks::get_backend() << '\n';
+    bench_attack_map("Per piece lookups", sliders, iterations, get_lookup_attacks_bit_board);
+    bench_attack_map("Kogge-Stone scalar", sliders, iterations,
+                     SliderFill::get_attacks_bit_board<SliderFillBackend::ScalarFill>);
+    if (SliderFill::is_backend_supported(SliderFillBackend::Avx2Fill))
+    {
+        bench_attack_map("Kogge-Stone AVX2", sliders, iterations,
+                         SliderFill::get_attacks_bit_board<SliderFillBackend::Avx2Fill>);
+    }
+}
+
+void bench_perft(const std::vector<std::string> &fens, std::uint8_t depth, std::size_t num_threads,
+                 std::size_t cache_megabytes, bool bulk_counting, bool divide)
+{
+    ThreadPool thread_pool{num_threads};
+    const auto cache{cache_megabytes ? std::make_unique<PerftCache>(cache_megabytes) : nullptr};
+    Perft perft{thread_pool, cache.get(), bulk_counting};
+
+    for (const auto &fen : fens)
+    {
+        const Position position{FenParser{fen}};
+        const auto start{std::chrono::steady_clock::now()};
+
+        std::uint64_t node_count{0};
+        for (const auto &[move, move_node_count] : perft.divide(position, depth))
+        {
+            if (divide)
+            {
+                std::cout << move << ": " << move_node_count << '\n';
+            }
+            node_count += move_node_count;
+        }
+        const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+        std::cout << "Perft " << static_cast<int>(depth) << " of " << fen << ": " << node_count << " nodes in "
+                  << elapsed.count() << "s (" << static_cast<double>(node_count) / elapsed.count() << " nps, "
+                  << thread_pool.get_num_threads() << " threads, " << SliderAttacks::get_backend()
+                  << " slider attacks)\n";
+
+        const auto statistics{perft.get_statistics()};
+        if (statistics.cache_probes)
+        {
+            std::cout << "Cache hit rate: "
+                      << 100.0 * static_cast<double>(statistics.cache_hits) /
+                             static_cast<double>(statistics.cache_probes)
+                      << "% of " << statistics.cache_probes << " probes\n";
+        }
+    }
+}
+
+SearchResult bench_search_threads(const std::vector<std::string> &fens, const SearchLimits &limits,
+                                  const SearchOptions &options, std::size_t num_threads, std::size_t hash_megabytes,
+                                  const Nnue *nnue)
+{
+    ThreadPool thread_pool{num_threads};
+    TranspositionTable transposition_table{hash_megabytes};
+    ParallelSearch search{thread_pool, transposition_table};
+    search.set_options(options);
+
+    SearchResult total{std::nullopt, 0, 0, {}, 0, {}, 0, 0, 0, 0};
+    for (const auto &fen : fens)
+    {
+        std::cout << "Search of " << fen << " with " << search.get_num_threads() << " threads\n";
+        transposition_table.clear();
+
+        Position position{FenParser{fen}};
+        position.set_nnue(nnue);
+        const auto result{search.search(position, limits, [](const SearchResult &iteration_result) {
+            std::cout << "Depth " << static_cast<int>(iteration_result.depth) << " score " << iteration_result.score
+                      << " time " << iteration_result.elapsed.count() << "s nodes " << iteration_result.nodes
+                      << " nps " << iteration_result.get_nodes_per_second() << " pv";
+            for (const auto move : iteration_result.principal_variation)
+            {
+                std::cout << ' ' << move;
+            }
+            std::cout << '\n';
+        })};
+        if (result.best_move.has_value())
+        {
+            std::cout << "Best move " << *result.best_move << " from depth " << static_cast<int>(result.depth) << '\n';
+        }
+
+        total.nodes += result.nodes;
+        total.elapsed += result.elapsed;
+        total.beta_cutoffs += result.beta_cutoffs;
+        total.first_move_beta_cutoffs += result.first_move_beta_cutoffs;
+        total.pawn_hash_probes += result.pawn_hash_probes;
+        total.pawn_hash_hits += result.pawn_hash_hits;
+    }
+
+    return total;
+}
+
+/*
+The given options, then each pruning technique switched off on its own, then all of them
+*/
+std::vector<SearchConfiguration> get_pruning_configurations(const SearchOptions &options)
+{
+    std::vector<SearchConfiguration> configurations{{"all pruning", options}};
+
+    auto no_null_move_options{options};
+    no_null_move_options.use_null_move_pruning = false;
+    configurations.emplace_back("no null move pruning", no_null_move_options);
+
+    auto no_late_move_reductions_options{options};
+    no_late_move_reductions_options.use_late_move_reductions = false;
+    configurations.emplace_back("no late move reductions", no_late_move_reductions_options);
+
+    auto no_reverse_futility_options{options};
+    no_reverse_futility_options.use_reverse_futility_pruning = false;
+    configurations.emplace_back("no reverse futility pruning", no_reverse_futility_options);
+
+    auto no_futility_options{options};
+    no_futility_options.use_futility_pruning = false;
+    configurations.emplace_back("no futility pruning", no_futility_options);
+
+    auto no_pruning_options{options};
+    no_pruning_options.use_null_move_pruning = false;
+    no_pruning_options.use_late_move_reductions = false;
+    no_pruning_options.use_reverse_futility_pruning = false;
+    no_pruning_options.use_futility_pruning = false;
+    configurations.emplace_back("no pruning", no_pruning_options);
+
+    return configurations;
+}
+
+/*
+With a depth limit the elapsed time is the time to that depth, so the summary shows how well the search scales and
+what each configuration costs compared to the first
+*/
+void bench_search(const std::vector<std::string> &fens, const SearchLimits &limits,
+                  const std::vector<SearchConfiguration> &configurations,
+                  const std::vector<std::size_t> &thread_counts, std::size_t hash_megabytes, const Nnue *nnue)
+{
+    std::vector<SearchResult> totals{};
+    for (const auto &[name, options] : configurations)
+    {
+        for (const auto num_threads : thread_counts)
+        {
+            std::cout << "Search with " << name << '\n';
+            totals.push_back(bench_search_threads(fens, limits, options, num_threads, hash_megabytes, nnue));
+        }
+    }
+
+    for (std::size_t idx{0}; idx < totals.size(); ++idx)
+    {
+        const auto &total{totals[idx]};
+        std::cout << "Search with " << configurations[idx / thread_counts.size()].first << " and "
+                  << thread_counts[idx % thread_counts.size()] << " threads: " << total.nodes << " nodes in "
+                  << total.elapsed.count() << "s (" << total.get_nodes_per_second() << " nps, "
+                  << totals.front().elapsed.count() / total.elapsed.count() << "x time to depth, "
+                  << total.get_nodes_per_second() / totals.front().get_nodes_per_second() << "x nps, "
+                  << 100 * total.get_first_move_cutoff_rate() << "% of cutoffs on the first move, "
+                  << 100 * total.get_pawn_hash_hit_rate() << "% pawn hash hits)\n";
+    }
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    po::options_description description{"Options"};
+    description.add_options()("help", "Show this message")(
+        "fen", po::value<std::vector<std::string>>()->multitoken(), "Positions to benchmark")(
+        "iterations", po::value<std::uint64_t>()->default_value(1000000), "Move generation calls per position")(
+        "perft", po::value<unsigned>(), "Run perft to this depth instead of the move generation benchmark")(
+        "threads", po::value<std::size_t>()->default_value(std::thread::hardware_concurrency()),
+        "Perft and search threads")(
+        "perft-hash", po::value<std::size_t>()->default_value(0), "Perft cache size in MB, 0 to disable")(
+        "no-bulk-counting", "Generate every leaf move in perft rather than just counting them")(
+        "divide", "Print the node count below each root move")(
+        "slider-attacks", po::value<std::string>(), "Force the magics or pext slider attacks backend")(
+        "attack-maps", "Benchmark whole side slider attack maps instead of move generation")(
+        "fen-parsing", "Benchmark parsing FENs instead of move generation")(
+        "packing", "Benchmark packing and unpacking positions instead of move generation")(
+        "epd", po::value<std::string>(), "Benchmark reading the positions in this EPD or FEN file instead")(
+        "pgn", po::value<std::string>(), "Benchmark replaying the games in this PGN file instead")(
+        "newline-scan", po::value<std::string>(), "Force the scalar or avx2 newline scan backend")(
+        "search", po::value<unsigned>(), "Search to this depth instead of the move generation benchmark")(
+        "search-nodes", po::value<std::uint64_t>(), "Also stop searching after this many nodes")(
+        "search-time", po::value<std::uint64_t>(), "Also stop searching after this many milliseconds")(
+        "search-threads", po::value<std::vector<std::size_t>>()->multitoken(),
+        "Search once with each of these thread counts instead of just --threads")(
+        "no-killer-moves", "Search without killer moves")("no-history", "Search without the history heuristic")(
+        "no-countermoves", "Search without countermoves")("no-null-move", "Search without null move pruning")(
+        "no-late-move-reductions", "Search without late move reductions")(
+        "no-reverse-futility", "Search without reverse futility pruning")(
+        "no-futility", "Search without futility pruning")(
+        "compare-pruning", "Search again with each pruning technique switched off")(
+        "hash", po::value<std::size_t>()->default_value(64), "Search transposition table size in MB")(
+        "nnue", po::value<std::string>(), "Search with the network in this file instead of the piece-square tables")(
+        "nnue-backend", po::value<std::string>(), "Force the scalar, sse or avx2 network backend");
+
+    po::variables_map variables{};
+    po::store(po::parse_command_line(argc, argv, description), variables);
+    po::notify(variables);
+
+    if (variables.count("help"))
+    {
+        std::cout << description << '\n';
+        return 0;
+    }
+
+    if (variables.count("slider-attacks"))
+    {
+        const auto backend_name{variables["slider-attacks"].as<std::string>()};
+        if (backend_name != "magics" && backend_name != "pext")
+        {
+            std::cerr << "Unknown slider attacks backend " << backend_name << '\n';
+            return 1;
+        }
+        SliderAttacks::set_backend(backend_name == "pext" ? SliderAttacksBackend::Pext : SliderAttacksBackend::Magics);
+    }
+
+    if (variables.count("nnue-backend"))
+    {
+        const auto backend_name{variables["nnue-backend"].as<std::string>()};
+        if (backend_name != "scalar" && backend_name != "sse" && backend_name != "avx2")
+        {
+            std::cerr << "Unknown NNUE backend " << backend_name << '\n';
+            return 1;
+        }
+        Nnue::set_backend(backend_name == "avx2"  ? NnueBackend::Avx2Nnue
+                          : backend_name == "sse" ? NnueBackend::SseNnue
+                                                  : NnueBackend::ScalarNnue);
+    }
+
+    if (variables.count("newline-scan"))
+    {
+        const auto backend_name{variables["newline-scan"].as<std::string>()};
+        if (backend_name != "scalar" && backend_name != "avx2")
+        {
+            std::cerr << "Unknown newline scan backend " << backend_name << '\n';
+            return 1;
+        }
+        NewlineScan::set_backend(backend_name == "avx2" ? NewlineScanBackend::Avx2Scan
+                                                        : NewlineScanBackend::ScalarScan);
+    }
+
+    const auto fens{variables.count("fen") ? variables["fen"].as<std::vector<std::string>>() : DEFAULT_FENS};
+    if (variables.count("perft"))
+    {
+        bench_perft(fens, static_cast<std::uint8_t>(variables["perft"].as<unsigned>()),
+                    variables["threads"].as<std::size_t>(), variables["perft-hash"].as<std::size_t>(),
+                    !variables.count("no-bulk-counting"), variables.count("divide"));
+    }
+    else if (variables.count("search") || variables.count("search-nodes") || variables.count("search-time"))
+    {
+        SearchLimits limits{};
+        if (variables.count("search"))
+        {
+            limits.depth = static_cast<std::uint8_t>(variables["search"].as<unsigned>());
+        }
+        if (variables.count("search-nodes"))
+        {
+            limits.nodes = variables["search-nodes"].as<std::uint64_t>();
+        }
+        if (variables.count("search-time"))
+        {
+            limits.time = std::chrono::milliseconds{variables["search-time"].as<std::uint64_t>()};
+        }
+        const auto thread_counts{variables.count("search-threads")
+                                     ? variables["search-threads"].as<std::vector<std::size_t>>()
+                                     : std::vector<std::size_t>{variables["threads"].as<std::size_t>()}};
+        SearchOptions options{};
+        options.use_killer_moves = !variables.count("no-killer-moves");
+        options.use_history = !variables.count("no-history");
+        options.use_countermoves = !variables.count("no-countermoves");
+        options.use_null_move_pruning = !variables.count("no-null-move");
+        options.use_late_move_reductions = !variables.count("no-late-move-reductions");
+        options.use_reverse_futility_pruning = !variables.count("no-reverse-futility");
+        options.use_futility_pruning = !variables.count("no-futility");
+        const auto configurations{variables.count("compare-pruning")
+                                      ? get_pruning_configurations(options)
+                                      : std::vector<SearchConfiguration>{{"the given options", options}}};
+        std::unique_ptr<Nnue> nnue{};
+        if (variables.count("nnue"))
+        {
+            nnue = std::make_unique<Nnue>(variables["nnue"].as<std::string>());
+            std::cout << "Evaluating with the " << Nnue::get_backend() << " network backend\n";
+        }
+        bench_search(fens, limits, configurations, thread_counts, variables["hash"].as<std::size_t>(), nnue.get());
+    }
+    else if (variables.count("epd"))
+    {
+        bench_epd(variables["epd"].as<std::string>(), variables["threads"].as<std::size_t>());
+    }
+    else if (variables.count("pgn"))
+    {
+        bench_pgn(variables["pgn"].as<std::string>(), variables["threads"].as<std::size_t>());
+    }
+    else if (variables.count("packing"))
+    {
+        bench_packing(fens, variables["iterations"].as<std::uint64_t>());
+    }
+    else if (variables.count("fen-parsing"))
+    {
+        bench_fen_parsing(fens, variables["iterations"].as<std::uint64_t>());
+    }
+    else if (variables.count("attack-maps"))
+    {
+        bench_attack_maps(fens, variables["iterations"].as<std::uint64_t>());
+    }
+    else
+    {
+        bench_move_generation(fens, variables["iterations"].as<std::uint64_t>());
+    }
+
+    return 0;
+}
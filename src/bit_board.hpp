@@ -2,27 +2,158 @@
 
 #include "bit_board_constants.hpp"
 #include "fen_parser.hpp"
+#include "leaper_attacks.hpp"
 #include "move.hpp"
+#include "move_list.hpp"
+#include "packed_position.hpp"
+#include "slider_attacks.hpp"
+#include "slider_fill.hpp"
 #include "types.hpp"
 
+#include <array>
 #include <bit>
-#include <cmath>
+#include <concepts>
+#include <cstddef>
 #include <iostream>
+#include <optional>
 #include <utility>
-#include <vector>
 
 class Position;
 
+/*
+Which moves to generate. Noisy moves are captures and promotions, quiet moves are everything else.
+*/
+enum MoveGeneration : std::uint8_t
+{
+    AllMoves,
+    NoisyMoves,
+    QuietMoves,
+};
+
+/*
+Everything about the side to move's king that legal move generation needs
+*/
+struct CheckInfo
+{
+    SquareUnderlying king_square;
+
+    /*
+    Worked out with the king removed, so it can't step backwards along a ray that's attacking it
+    */
+    BitBoard opponent_attacking_bit_board;
+    BitBoard checkers_bit_board;
+
+    /*
+    Where anything but the king has to land: anywhere out of check, on the checker or between it and the king in single
+    check, and nowhere in double check
+    */
+    BitBoard check_mask_bit_board;
+    BitBoard pinned_bit_board;
+
+    /*
+    En passant takes two pawns off the same rank at once, which the pins above can't describe, so it's checked against
+    these directly
+    */
+    BitBoard opponent_diagonal_sliders_bit_board;
+    BitBoard opponent_orthogonal_sliders_bit_board;
+};
+
+/*
+One player's pawns by strength and weakness. A passed pawn has no opposing pawn in front of it on its own or an
+adjacent file, an isolated pawn has no friendly pawn on an adjacent file, a doubled pawn has a friendly pawn in front of
+it, and a backward pawn can't advance without being captured and can't ever be defended by a pawn that can.
+*/
+struct PawnStructure
+{
+    BitBoard passed_bit_board;
+    BitBoard isolated_bit_board;
+    BitBoard doubled_bit_board;
+    BitBoard backward_bit_board;
+};
+
 template <Player player> class BitBoards
 {
   public:
     BitBoards();
     BitBoards(const FenParser &fen_parser);
+    BitBoards(const PackedPosition::PlayerPieceBitBoards &piece_bit_boards);
+
+    /*
+    In pawns. The king is worth more than everything else put together, so exchanges never give it up.
+    */
+    static constexpr Evaluation get_piece_value(Piece piece);
 
-    Evaluation get_total_piece_value() const;
     BitBoard get_occupied_bit_board() const;
+    BitBoard get_king_bit_board() const;
+    BitBoard get_piece_bit_board(Piece piece) const;
+
+    /*
+    Without any, zugzwang is likely enough that passing can't be trusted to be worse than moving
+    */
+    bool has_non_pawn_material() const;
+
+    /*
+    Worked out for every pawn at once by filling along files, so it costs the same however many pawns there are
+    */
+    PawnStructure get_pawn_structure(const BitBoards<opponent_of(player)> &opponent_bit_boards) const;
+
+    /*
+    For a king on the back rank of each file, how many of this player's pawns are on the two ranks in front of it, on
+    its own or an adjacent file
+    */
+    std::array<std::uint8_t, BOARD_WIDTH> get_pawn_shields() const;
+
+    /*
+    Computed once per node, then every add_*_moves uses it to only produce legal moves
+    */
+    CheckInfo get_check_info(const BitBoards<opponent_of(player)> &opponent_bit_boards) const;
+
+    template <MoveGeneration generation = MoveGeneration::AllMoves, MoveSink Moves>
+    void get_moves(Moves &moves, BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                   BitBoard en_passant_bit_board, CastlingRightsUnderlying castling_rights) const;
+
+    /*
+    Whether get_moves would produce the move, without generating anything. Meant for moves that might be from another
+    position, like ones from the transposition table.
+    */
+    bool is_legal(Move move, BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                  BitBoard en_passant_bit_board, CastlingRightsUnderlying castling_rights) const;
+
+    /*
+    Every square this player attacks, including ones occupied by its own pieces
+    */
+    BitBoard get_attacking_bit_board(BitBoard occupied_bit_board) const;
 
-    std::vector<Move> get_moves(BitBoard opponent_occupied_bit_board, BitBoard opponent_attacking_bit_board) const;
+    /*
+    This player's pieces attacking the square. Only pieces in the occupancy count, and sliders see through anything
+    that isn't, so taking attackers out of it reveals the ones lined up behind them.
+    */
+    BitBoard get_attackers_bit_board(SquareUnderlying square, BitBoard occupied_bit_board) const;
+
+    /*
+    The least valuable of this player's pieces in the bit board, and the bit board of just that one piece. There has to
+    be at least one.
+    */
+    std::pair<Piece, BitBoard> get_least_valuable_piece(BitBoard bit_board) const;
+
+    /*
+    Same rules as get_moves, but only popcounts the target bit boards
+    */
+    std::size_t count_moves(BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                            BitBoard en_passant_bit_board, CastlingRightsUnderlying castling_rights) const;
+
+    /*
+    Assumes one of this player's pieces is on the given square
+    */
+    Piece get_piece(BitBoard bit_board) const;
+    std::optional<Piece> find_piece(BitBoard bit_board) const;
+
+    /*
+    All of these toggle bits, so the same call undoes itself
+    */
+    void add_piece(Piece piece, BitBoard bit_board);
+    void remove_piece(Piece piece, BitBoard bit_board);
+    void move_piece(Piece piece, BitBoard from_to_bit_board);
 
   private:
     using Constants = BitBoardsConstants<player>;
@@ -32,57 +163,68 @@ template <Player player> class BitBoards
     static constexpr Evaluation BISHOP_VALUE{3};
     static constexpr Evaluation ROOK_VALUE{5};
     static constexpr Evaluation QUEEN_VALUE{9};
+    static constexpr Evaluation KING_VALUE{100};
+
+    static BitBoard get_pawn_attacks_bit_board(BitBoard pawns_bit_board);
+
+    /*
+    Every square from each piece onwards in the direction, itself included
+    */
+    template <Direction direction> static BitBoard fill_bit_board(BitBoard bit_board);
+
+    /*
+    The same squares on the files either side
+    */
+    static BitBoard get_adjacent_files_bit_board(BitBoard bit_board);
+
+    /*
+    Target bit boards are where the moves are allowed to land, already restricted by check and pins
+    */
+    template <MoveGeneration generation, MoveSink Moves>
+    void add_pawn_moves(Moves &moves, BitBoard pawns_bit_board, BitBoard occupied_bit_board,
+                        BitBoard opponent_occupied_bit_board, BitBoard target_bit_board) const;
+    template <MoveSink Moves>
+    void add_en_passant_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                              BitBoard en_passant_bit_board) const;
+    template <MoveSink Moves>
+    void add_knight_moves(Moves &moves, const CheckInfo &check_info, BitBoard target_bit_board) const;
+    template <MoveSink Moves>
+    void add_bishop_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                          BitBoard target_bit_board) const;
+    template <MoveSink Moves>
+    void add_rook_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                        BitBoard target_bit_board) const;
+    template <MoveSink Moves>
+    void add_queen_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                         BitBoard target_bit_board) const;
+    template <MoveGeneration generation, MoveSink Moves>
+    void add_king_moves(Moves &moves, BitBoard target_bit_board, BitBoard occupied_bit_board,
+                        const CheckInfo &check_info, CastlingRightsUnderlying castling_rights) const;
+
+    bool is_legal_en_passant(SquareUnderlying from, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                             BitBoard en_passant_bit_board) const;
+    bool is_legal_pawn_move(Move move, BitBoard occupied_bit_board, BitBoard opponent_occupied_bit_board,
+                            const CheckInfo &check_info, BitBoard en_passant_bit_board,
+                            BitBoard target_bit_board) const;
+
+    /*
+    The safe squares include the king's own, so this also rules out castling out of check
+    */
+    static bool can_castle(CastlingRightsUnderlying castling_right, BitBoard empty_bit_board, BitBoard safe_bit_board,
+                           BitBoard occupied_bit_board, const CheckInfo &check_info,
+                           CastlingRightsUnderlying castling_rights);
 
-    static constexpr auto NOT_A_FILE_BIT_BOARD{~file_to_bit_board(File::FA)};
-    static constexpr auto NOT_AB_FILE_BIT_BOARD{NOT_A_FILE_BIT_BOARD & ~file_to_bit_board(File::FB)};
-    static constexpr auto NOT_H_FILE_BIT_BOARD{~file_to_bit_board(File::FH)};
-    static constexpr auto NOT_GH_FILE_BIT_BOARD{NOT_H_FILE_BIT_BOARD & ~file_to_bit_board(File::FG)};
-    static constexpr auto NOT_RANK_END_BIT_BOARD{NOT_A_FILE_BIT_BOARD & NOT_H_FILE_BIT_BOARD};
-    static constexpr auto NOT_FILE_END_BIT_BOARD{~rank_to_bit_board(Rank::R1) & ~rank_to_bit_board(Rank::R8)};
-    static constexpr auto NOT_EDGE_BIT_BOARD{NOT_RANK_END_BIT_BOARD & NOT_FILE_END_BIT_BOARD};
-
-    template <Direction direction> static consteval BitBoard create_diagonal_bit_board(Square starting_square);
-    static constexpr auto MAIN_DIAGONAL_BIT_BOARD{create_diagonal_bit_board<Direction::NE>(Square::A1)};
-    static constexpr auto MAIN_ANTIDIAGONAL_BIT_BOARD{create_diagonal_bit_board<Direction::NW>(Square::H1)};
-
-    static consteval Lookup<BitBoard> create_knight_attacks_bit_board_lookup();
-    static consteval Lookup<BitBoard> create_king_attacks_bit_board_lookup();
-    static constexpr Lookup<BitBoard> KNIGHT_ATTACKS_BIT_BOARD_LOOKUP{create_knight_attacks_bit_board_lookup()};
-    static constexpr Lookup<BitBoard> KING_ATTACKS_BIT_BOARD_LOOKUP{create_king_attacks_bit_board_lookup()};
-
-    static consteval Lookup<BitBoard> create_bishop_relevant_occupancies_bit_board_lookup();
-    static consteval Lookup<BitBoard> create_rook_relevant_occupancies_bit_board_lookup();
-    static constexpr Lookup<BitBoard> BISHOP_RELEVANT_OCCUPANCIES_BIT_BOARD_LOOKUP{
-        create_bishop_relevant_occupancies_bit_board_lookup()};
-    static constexpr Lookup<BitBoard> ROOK_RELEVANT_OCCUPANCIES_BIT_BOARD_LOOKUP{
-        create_rook_relevant_occupancies_bit_board_lookup()};
-
-    static consteval Lookup<Magic> create_bishop_magics_lookup();
-    static consteval Lookup<Magic> create_rook_magics_lookup();
-    static constexpr Lookup<Magic> BISHOP_MAGICS_LOOKUP{create_bishop_magics_lookup()};
-    static constexpr Lookup<Magic> ROOK_MAGICS_LOOKUP{create_rook_magics_lookup()};
-
-    using BishopAttackLookup = Lookup<BitBoard, 512>;
-    using RookAttackLookup = Lookup<BitBoard, 4096>;
-    static consteval BishopAttackLookup create_bishop_attacks_bit_board_lookup();
-    static consteval RookAttackLookup create_rook_attacks_bit_board_lookup();
-    static constexpr BishopAttackLookup BISHOP_ATTACKS_BIT_BOARD_LOOKUP{create_bishop_attacks_bit_board_lookup()};
-    static constexpr RookAttackLookup ROOK_ATTACKS_BIT_BOARD_LOOKUP{create_rook_attacks_bit_board_lookup()};
-
-    void add_pawn_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                        BitBoard opponent_occupied_bit_board) const;
-    void add_knight_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board) const;
-    void add_bishop_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                          BitBoard opponent_occupied_bit_board) const;
-    void add_rook_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                        BitBoard opponent_occupied_bit_board) const;
-    void add_queen_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                         BitBoard opponent_occupied_bit_board) const;
-    void add_king_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                        BitBoard opponent_attacking_bit_board) const;
-
-    template <typename F>
-    static inline void serialise_bit_board(std::vector<Move> &moves, BitBoard bit_board, F from_function);
+    /*
+    A pinned piece can still move along the line between its king and the pinner
+    */
+    static BitBoard get_pin_bit_board(SquareUnderlying from, const CheckInfo &check_info);
+
+    template <MoveSink Moves, typename F>
+    static inline void serialise_bit_board(Moves &moves, BitBoard bit_board, F from_function,
+                                           MoveFlag flag = MoveFlag::Normal);
+    template <MoveSink Moves, typename F>
+    static inline void serialise_promotions(Moves &moves, BitBoard bit_board, F from_function);
+    BitBoard &get_piece_bit_board(Piece piece);
     inline static std::uint8_t count_bits(BitBoard bit_board);
     inline static std::uint8_t ls1b(BitBoard bit_board);
 
@@ -93,6 +235,7 @@ template <Player player> class BitBoards
     BitBoard queens;
     BitBoard king;
 
+    template <Player> friend class BitBoards;
     friend std::ostream &operator<<(std::ostream &os, Position position);
 };
 
@@ -106,49 +249,42 @@ BitBoards<player>::BitBoards()
 
 template <Player player>
 BitBoards<player>::BitBoards(const FenParser &fen_parser)
-    : pawns{0}, knights{0}, bishops{0}, rooks{0}, queens{0}, king{0}
+    : pawns{fen_parser.get_piece_bit_board(player, Piece::Pawn)},
+      knights{fen_parser.get_piece_bit_board(player, Piece::Knight)},
+      bishops{fen_parser.get_piece_bit_board(player, Piece::Bishop)},
+      rooks{fen_parser.get_piece_bit_board(player, Piece::Rook)},
+      queens{fen_parser.get_piece_bit_board(player, Piece::Queen)},
+      king{fen_parser.get_piece_bit_board(player, Piece::King)}
 {
-    const auto &board_array{fen_parser.get_board_array()};
-    for (SquareUnderlying square{0}; square < BOARD_SQUARES; ++square)
-    {
-        const auto &entry{board_array.at(square)};
-        if (entry.has_value() && entry->first == player)
-        {
-            const auto mask{square_to_bit_board(Square{square})};
-            switch (entry->second)
-            {
-            case Piece::Pawn:
-                pawns |= mask;
-                break;
-            case Piece::Knight:
-                knights |= mask;
-                break;
-            case Piece::Bishop:
-                bishops |= mask;
-                break;
-            case Piece::Rook:
-                rooks |= mask;
-                break;
-            case Piece::Queen:
-                queens |= mask;
-                break;
-            case Piece::King:
-                king |= mask;
-                break;
-            }
-        }
-    }
 }
 
-template <Player player> std::int16_t BitBoards<player>::get_total_piece_value() const
+template <Player player>
+BitBoards<player>::BitBoards(const PackedPosition::PlayerPieceBitBoards &piece_bit_boards)
+    : pawns{piece_bit_boards[Piece::Pawn]}, knights{piece_bit_boards[Piece::Knight]},
+      bishops{piece_bit_boards[Piece::Bishop]}, rooks{piece_bit_boards[Piece::Rook]},
+      queens{piece_bit_boards[Piece::Queen]}, king{piece_bit_boards[Piece::King]}
 {
-    const auto pawns_value{PAWN_VALUE * count_bits(pawns)};
-    const auto knights_value{KNIGHT_VALUE * count_bits(knights)};
-    const auto bishops_value{BISHOP_VALUE * count_bits(bishops)};
-    const auto rooks_value{ROOK_VALUE * count_bits(rooks)};
-    const auto queens_value{QUEEN_VALUE * count_bits(queens)};
+}
+
+template <Player player> constexpr Evaluation BitBoards<player>::get_piece_value(Piece piece)
+{
+    switch (piece)
+    {
+    case Piece::Pawn:
+        return PAWN_VALUE;
+    case Piece::Knight:
+        return KNIGHT_VALUE;
+    case Piece::Bishop:
+        return BISHOP_VALUE;
+    case Piece::Rook:
+        return ROOK_VALUE;
+    case Piece::Queen:
+        return QUEEN_VALUE;
+    case Piece::King:
+        return KING_VALUE;
+    }
 
-    return pawns_value + knights_value + bishops_value + rooks_value + queens_value;
+    throw std::logic_error{"Tried to get value of unknown piece"};
 }
 
 template <Player player> BitBoard BitBoards<player>::get_occupied_bit_board() const
@@ -156,300 +292,753 @@ template <Player player> BitBoard BitBoards<player>::get_occupied_bit_board() co
     return pawns | knights | bishops | rooks | queens | king;
 }
 
-template <Player player>
-std::vector<Move> BitBoards<player>::get_moves(BitBoard opponent_occupied_bit_board,
-                                               BitBoard opponent_attacking_bit_board) const
+template <Player player> BitBoard BitBoards<player>::get_king_bit_board() const
 {
-    std::vector<Move> moves{};
-    const auto self_occupied_bit_board{get_occupied_bit_board()};
-
-    add_pawn_moves(moves, self_occupied_bit_board, opponent_occupied_bit_board);
-    add_knight_moves(moves, self_occupied_bit_board);
-    add_bishop_moves(moves, self_occupied_bit_board, opponent_occupied_bit_board);
-    add_rook_moves(moves, self_occupied_bit_board, opponent_occupied_bit_board);
-    add_queen_moves(moves, self_occupied_bit_board, opponent_occupied_bit_board);
-    add_king_moves(moves, self_occupied_bit_board, opponent_attacking_bit_board);
+    return king;
+}
 
-    return moves;
+template <Player player> bool BitBoards<player>::has_non_pawn_material() const
+{
+    return knights | bishops | rooks | queens;
 }
 
 template <Player player>
-void BitBoards<player>::add_pawn_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                                       BitBoard opponent_occupied_bit_board) const
+PawnStructure BitBoards<player>::get_pawn_structure(const BitBoards<opponent_of(player)> &opponent_bit_boards) const
 {
+    static constexpr auto BACKWARD_DIRECTION{static_cast<Direction>(-Constants::PAWN_PUSH_DIRECTION)};
+    const auto opponent_pawns_bit_board{opponent_bit_boards.pawns};
+
+    /*
+    Squares in front of the opponent's pawns from their side, so every square they could block or capture on
+    */
+    const auto opponent_front_spans_bit_board{
+        fill_bit_board<BACKWARD_DIRECTION>(direction_shift<BACKWARD_DIRECTION>(opponent_pawns_bit_board))};
+    const auto files_bit_board{fill_bit_board<Constants::PAWN_PUSH_DIRECTION>(pawns) |
+                               fill_bit_board<BACKWARD_DIRECTION>(pawns)};
+    const auto rear_spans_bit_board{fill_bit_board<BACKWARD_DIRECTION>(direction_shift<BACKWARD_DIRECTION>(pawns))};
+
     /*
-    Push moves
+    A pawn's stop square is backward if an opposing pawn attacks it and no friendly pawn could ever come up to defend
+    it
     */
+    const auto attack_spans_bit_board{
+        fill_bit_board<Constants::PAWN_PUSH_DIRECTION>(get_pawn_attacks_bit_board(pawns))};
+    const auto opponent_attacks_bit_board{
+        BitBoards<opponent_of(player)>::get_pawn_attacks_bit_board(opponent_pawns_bit_board)};
+    const auto stops_bit_board{direction_shift<Constants::PAWN_PUSH_DIRECTION>(pawns)};
+    const auto backward_stops_bit_board{stops_bit_board & opponent_attacks_bit_board & ~attack_spans_bit_board};
+
+    PawnStructure pawn_structure{};
+    pawn_structure.passed_bit_board = pawns & ~(opponent_front_spans_bit_board |
+                                                get_adjacent_files_bit_board(opponent_front_spans_bit_board));
+    pawn_structure.isolated_bit_board = pawns & ~get_adjacent_files_bit_board(files_bit_board);
+    pawn_structure.doubled_bit_board = pawns & rear_spans_bit_board;
+    pawn_structure.backward_bit_board = direction_shift<BACKWARD_DIRECTION>(backward_stops_bit_board);
+
+    return pawn_structure;
+}
+
+template <Player player> std::array<std::uint8_t, BOARD_WIDTH> BitBoards<player>::get_pawn_shields() const
+{
+    const auto shield_pawns_bit_board{pawns & Constants::PAWN_SHIELD_BIT_BOARD};
+
+    std::array<std::uint8_t, BOARD_WIDTH> pawn_shields{};
+    for (FileUnderlying file{0}; file < BOARD_WIDTH; ++file)
+    {
+        const auto file_bit_board{file_to_bit_board(File{file})};
+        pawn_shields[file] =
+            count_bits(shield_pawns_bit_board & (file_bit_board | get_adjacent_files_bit_board(file_bit_board)));
+    }
+
+    return pawn_shields;
+}
+
+template <Player player>
+CheckInfo BitBoards<player>::get_check_info(const BitBoards<opponent_of(player)> &opponent_bit_boards) const
+{
+    const auto self_occupied_bit_board{get_occupied_bit_board()};
+    const auto opponent_occupied_bit_board{opponent_bit_boards.get_occupied_bit_board()};
     const auto occupied_bit_board{self_occupied_bit_board | opponent_occupied_bit_board};
-    auto single_push_bit_board{direction_shift<Constants::PAWN_PUSH_DIRECTION>(pawns)};
-    single_push_bit_board &= ~occupied_bit_board;
-    serialise_bit_board(moves, single_push_bit_board, [](auto to) { return to - Constants::PAWN_PUSH_DIRECTION; });
 
-    static constexpr auto SINGLE_PUSH_RANK{
-        direction_shift<Constants::PAWN_PUSH_DIRECTION>(Constants::STARTING_PAWNS_BIT_BOARD)};
-    auto double_push_bit_board{
-        direction_shift<Constants::PAWN_PUSH_DIRECTION>(single_push_bit_board & SINGLE_PUSH_RANK)};
-    double_push_bit_board &= ~occupied_bit_board;
-    serialise_bit_board(moves, double_push_bit_board,
-                        [](auto to) { return to - static_cast<std::uint8_t>(2 * Constants::PAWN_PUSH_DIRECTION); });
+    CheckInfo check_info{};
+    check_info.king_square = ls1b(king);
+    check_info.opponent_diagonal_sliders_bit_board = opponent_bit_boards.bishops | opponent_bit_boards.queens;
+    check_info.opponent_orthogonal_sliders_bit_board = opponent_bit_boards.rooks | opponent_bit_boards.queens;
+    check_info.opponent_attacking_bit_board = opponent_bit_boards.get_attacking_bit_board(occupied_bit_board & ~king);
 
     /*
-    Capture left
+    Attacks are symmetric, so anything the king could capture as that piece is checking it
     */
-    auto left_capture_bit_board{
-        direction_shift<Constants::PAWN_LEFT_CAPTURE_DIRECTION>(pawns & ~Constants::LEFT_FILE_BIT_BOARD)};
-    left_capture_bit_board &= opponent_occupied_bit_board;
-    serialise_bit_board(moves, left_capture_bit_board,
-                        [](auto to) { return to - Constants::PAWN_LEFT_CAPTURE_DIRECTION; });
+    check_info.checkers_bit_board =
+        (get_pawn_attacks_bit_board(king) & opponent_bit_boards.pawns) |
+        (LeaperAttacks::get_knight_attacks_bit_board(check_info.king_square) & opponent_bit_boards.knights) |
+        (SliderAttacks::get_bishop_attacks_bit_board(check_info.king_square, occupied_bit_board) &
+         check_info.opponent_diagonal_sliders_bit_board) |
+        (SliderAttacks::get_rook_attacks_bit_board(check_info.king_square, occupied_bit_board) &
+         check_info.opponent_orthogonal_sliders_bit_board);
+
+    if (!check_info.checkers_bit_board)
+    {
+        check_info.check_mask_bit_board = ~BitBoard{0};
+    }
+    else if (!(check_info.checkers_bit_board & (check_info.checkers_bit_board - 1)))
+    {
+        check_info.check_mask_bit_board =
+            check_info.checkers_bit_board |
+            SliderAttacks::get_between_bit_board(check_info.king_square, ls1b(check_info.checkers_bit_board));
+    }
 
     /*
-    Capture right
+    Sliders that would see the king through this player's pieces. Any with exactly one piece in the way pin it, unless
+    it's the opponent's own.
     */
-    auto right_capture_bit_board{
-        direction_shift<Constants::PAWN_RIGHT_CAPTURE_DIRECTION>(pawns & ~Constants::RIGHT_FILE_BIT_BOARD)};
-    right_capture_bit_board &= opponent_occupied_bit_board;
-    serialise_bit_board(moves, right_capture_bit_board,
-                        [](auto to) { return to - Constants::PAWN_RIGHT_CAPTURE_DIRECTION; });
+    auto pinners_bit_board{(SliderAttacks::get_bishop_attacks_bit_board(check_info.king_square,
+                                                                        opponent_occupied_bit_board) &
+                            check_info.opponent_diagonal_sliders_bit_board) |
+                           (SliderAttacks::get_rook_attacks_bit_board(check_info.king_square,
+                                                                      opponent_occupied_bit_board) &
+                            check_info.opponent_orthogonal_sliders_bit_board)};
+    while (pinners_bit_board)
+    {
+        const auto blockers_bit_board{
+            SliderAttacks::get_between_bit_board(check_info.king_square, ls1b(pinners_bit_board)) & occupied_bit_board};
+        if (blockers_bit_board && !(blockers_bit_board & (blockers_bit_board - 1)) &&
+            (blockers_bit_board & self_occupied_bit_board))
+        {
+            check_info.pinned_bit_board |= blockers_bit_board;
+        }
+
+        pinners_bit_board &= pinners_bit_board - 1;
+    }
+
+    return check_info;
 }
 
 template <Player player>
-void BitBoards<player>::add_knight_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board) const
+template <MoveGeneration generation, MoveSink Moves>
+void BitBoards<player>::get_moves(Moves &moves, BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                                  BitBoard en_passant_bit_board, CastlingRightsUnderlying castling_rights) const
 {
-    auto bit_board{knights};
-    for (SquareUnderlying from{0}; bit_board; ++from)
+    const auto self_occupied_bit_board{get_occupied_bit_board()};
+    const auto occupied_bit_board{self_occupied_bit_board | opponent_occupied_bit_board};
+
+    /*
+    Where pieces other than pawns land for this kind of move. Whether a pawn captures depends on how it moves rather
+    than where, so pawns sort themselves out.
+    */
+    auto generation_bit_board{~self_occupied_bit_board};
+    if constexpr (generation == MoveGeneration::NoisyMoves)
     {
-        const auto lsb{ls1b(bit_board)};
-        from += lsb;
+        generation_bit_board = opponent_occupied_bit_board;
+    }
+    else if constexpr (generation == MoveGeneration::QuietMoves)
+    {
+        generation_bit_board = ~occupied_bit_board;
+    }
 
-        const auto attacks_bit_board{KNIGHT_ATTACKS_BIT_BOARD_LOOKUP.at(from) & ~self_occupied_bit_board};
-        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+    /*
+    Nothing but the king can get out of double check
+    */
+    if (check_info.check_mask_bit_board)
+    {
+        const auto pawn_target_bit_board{~self_occupied_bit_board & check_info.check_mask_bit_board};
+        add_pawn_moves<generation>(moves, pawns & ~check_info.pinned_bit_board, occupied_bit_board,
+                                   opponent_occupied_bit_board, pawn_target_bit_board);
+        auto pinned_pawns_bit_board{pawns & check_info.pinned_bit_board};
+        while (pinned_pawns_bit_board)
+        {
+            const SquareUnderlying from{ls1b(pinned_pawns_bit_board)};
+            add_pawn_moves<generation>(moves, square_to_bit_board(Square{from}), occupied_bit_board,
+                                       opponent_occupied_bit_board,
+                                       pawn_target_bit_board & get_pin_bit_board(from, check_info));
+            pinned_pawns_bit_board &= pinned_pawns_bit_board - 1;
+        }
+        if constexpr (generation != MoveGeneration::QuietMoves)
+        {
+            add_en_passant_moves(moves, occupied_bit_board, check_info, en_passant_bit_board);
+        }
 
-        bit_board >>= (lsb + 1);
+        const auto target_bit_board{generation_bit_board & check_info.check_mask_bit_board};
+        add_knight_moves(moves, check_info, target_bit_board);
+        add_bishop_moves(moves, occupied_bit_board, check_info, target_bit_board);
+        add_rook_moves(moves, occupied_bit_board, check_info, target_bit_board);
+        add_queen_moves(moves, occupied_bit_board, check_info, target_bit_board);
     }
+
+    add_king_moves<generation>(moves, generation_bit_board, occupied_bit_board, check_info, castling_rights);
 }
 
 template <Player player>
-void BitBoards<player>::add_bishop_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                                         BitBoard opponent_occupied_bit_board) const
+bool BitBoards<player>::is_legal(Move move, BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                                 BitBoard en_passant_bit_board, CastlingRightsUnderlying castling_rights) const
 {
-    auto bit_board{rooks};
-    for (SquareUnderlying from{0}; bit_board; ++from)
+    const auto from{move.get_from()};
+    const auto from_bit_board{square_to_bit_board(Square{from})};
+    const auto to_bit_board{square_to_bit_board(Square{move.get_to()})};
+    const auto flag{move.get_flag()};
+    const auto self_occupied_bit_board{get_occupied_bit_board()};
+    const auto occupied_bit_board{self_occupied_bit_board | opponent_occupied_bit_board};
+
+    if (from_bit_board & king)
     {
-        const auto lsb{ls1b(bit_board)};
-        from += lsb;
+        if (flag == MoveFlag::Castle)
+        {
+            if (move.get_to() == Constants::KINGSIDE_CASTLING_KING_TO)
+            {
+                return can_castle(Constants::KINGSIDE_CASTLING_RIGHT, Constants::KINGSIDE_CASTLING_EMPTY_BIT_BOARD,
+                                  Constants::KINGSIDE_CASTLING_SAFE_BIT_BOARD, occupied_bit_board, check_info,
+                                  castling_rights);
+            }
 
-        auto idx{self_occupied_bit_board | opponent_occupied_bit_board};
-        idx &= BISHOP_RELEVANT_OCCUPANCIES_BIT_BOARD_LOOKUP.at(from);
-        idx *= BISHOP_MAGICS_LOOKUP.at(from);
+            return move.get_to() == Constants::QUEENSIDE_CASTLING_KING_TO &&
+                   can_castle(Constants::QUEENSIDE_CASTLING_RIGHT, Constants::QUEENSIDE_CASTLING_EMPTY_BIT_BOARD,
+                              Constants::QUEENSIDE_CASTLING_SAFE_BIT_BOARD, occupied_bit_board, check_info,
+                              castling_rights);
+        }
 
-        static constexpr auto SHIFT_AMOUNT{BOARD_SQUARES -
-                                           static_cast<int>(std::log2(BISHOP_ATTACKS_BIT_BOARD_LOOKUP.size()))};
-        idx >>= SHIFT_AMOUNT;
+        return flag == MoveFlag::Normal && (LeaperAttacks::get_king_attacks_bit_board(from) & to_bit_board &
+                                            ~self_occupied_bit_board & ~check_info.opponent_attacking_bit_board);
+    }
 
-        const auto attacks_bit_board{BISHOP_ATTACKS_BIT_BOARD_LOOKUP.at(idx)};
-        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+    if (!(self_occupied_bit_board & from_bit_board) || !check_info.check_mask_bit_board)
+    {
+        return false;
+    }
 
-        bit_board >>= (lsb + 1);
+    const auto target_bit_board{~self_occupied_bit_board & check_info.check_mask_bit_board &
+                                get_pin_bit_board(from, check_info)};
+    if (from_bit_board & pawns)
+    {
+        return is_legal_pawn_move(move, occupied_bit_board, opponent_occupied_bit_board, check_info,
+                                  en_passant_bit_board, target_bit_board);
     }
-}
 
-template <Player player>
-void BitBoards<player>::add_rook_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                                       BitBoard opponent_occupied_bit_board) const
-{
-    auto bit_board{rooks};
-    for (SquareUnderlying from{0}; bit_board; ++from)
+    if (flag != MoveFlag::Normal)
     {
-        const auto lsb{ls1b(bit_board)};
-        from += lsb;
+        return false;
+    }
 
-        auto idx{self_occupied_bit_board | opponent_occupied_bit_board};
-        idx &= ROOK_RELEVANT_OCCUPANCIES_BIT_BOARD_LOOKUP.at(from);
-        idx *= ROOK_MAGICS_LOOKUP.at(from);
+    BitBoard attacks_bit_board{0};
+    if (from_bit_board & knights)
+    {
+        attacks_bit_board = LeaperAttacks::get_knight_attacks_bit_board(from);
+    }
+    else if (from_bit_board & bishops)
+    {
+        attacks_bit_board = SliderAttacks::get_bishop_attacks_bit_board(from, occupied_bit_board);
+    }
+    else if (from_bit_board & rooks)
+    {
+        attacks_bit_board = SliderAttacks::get_rook_attacks_bit_board(from, occupied_bit_board);
+    }
+    else
+    {
+        attacks_bit_board = SliderAttacks::get_queen_attacks_bit_board(from, occupied_bit_board);
+    }
 
-        static constexpr auto SHIFT_AMOUNT{BOARD_SQUARES -
-                                           static_cast<int>(std::log2(ROOK_ATTACKS_BIT_BOARD_LOOKUP.size()))};
-        idx >>= SHIFT_AMOUNT;
+    return attacks_bit_board & to_bit_board & target_bit_board;
+}
 
-        const auto attacks_bit_board{ROOK_ATTACKS_BIT_BOARD_LOOKUP.at(idx)};
-        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+template <Player player> BitBoard BitBoards<player>::get_attacking_bit_board(BitBoard occupied_bit_board) const
+{
+    BitBoard attacking_bit_board{get_pawn_attacks_bit_board(pawns)};
 
-        bit_board >>= (lsb + 1);
+    auto knights_bit_board{knights};
+    while (knights_bit_board)
+    {
+        attacking_bit_board |= LeaperAttacks::get_knight_attacks_bit_board(ls1b(knights_bit_board));
+        knights_bit_board &= knights_bit_board - 1;
     }
+
+    attacking_bit_board |= SliderFill::get_attacks_bit_board(bishops | queens, rooks | queens, occupied_bit_board);
+    attacking_bit_board |= LeaperAttacks::get_king_attacks_bit_board(ls1b(king));
+
+    return attacking_bit_board;
 }
 
 template <Player player>
-void BitBoards<player>::add_queen_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                                        BitBoard opponent_occupied_bit_board) const
+BitBoard BitBoards<player>::get_attackers_bit_board(SquareUnderlying square, BitBoard occupied_bit_board) const
 {
-    (void)moves;
-    (void)self_occupied_bit_board;
-    (void)opponent_occupied_bit_board;
+    /*
+    Attacks are symmetric, so a pawn of the opponent's on the square would attack exactly this player's pawns that
+    attack it
+    */
+    const auto square_bit_board{square_to_bit_board(Square{square})};
+    const auto attackers_bit_board{
+        (BitBoards<opponent_of(player)>::get_pawn_attacks_bit_board(square_bit_board) & pawns) |
+        (LeaperAttacks::get_knight_attacks_bit_board(square) & knights) |
+        (SliderAttacks::get_bishop_attacks_bit_board(square, occupied_bit_board) & (bishops | queens)) |
+        (SliderAttacks::get_rook_attacks_bit_board(square, occupied_bit_board) & (rooks | queens)) |
+        (LeaperAttacks::get_king_attacks_bit_board(square) & king)};
+
+    return attackers_bit_board & occupied_bit_board;
 }
 
 template <Player player>
-void BitBoards<player>::add_king_moves(std::vector<Move> &moves, BitBoard self_occupied_bit_board,
-                                       BitBoard opponent_attacking_bit_board) const
+std::pair<Piece, BitBoard> BitBoards<player>::get_least_valuable_piece(BitBoard bit_board) const
 {
-    /* Reasonably assumes for the sake of speed there's exactly 1 king */
-    const SquareUnderlying from{ls1b(king)};
-    const auto attacks_no_check_bit_board{KING_ATTACKS_BIT_BOARD_LOOKUP.at(from) & ~self_occupied_bit_board &
-                                          ~opponent_attacking_bit_board};
+    for (const auto piece : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen})
+    {
+        const auto pieces_bit_board{bit_board & get_piece_bit_board(piece)};
+        if (pieces_bit_board)
+        {
+            return {piece, square_to_bit_board(Square{ls1b(pieces_bit_board)})};
+        }
+    }
 
-    serialise_bit_board(moves, attacks_no_check_bit_board, [from](auto) { return from; });
+    return {Piece::King, bit_board & king};
 }
 
 template <Player player>
-template <typename F>
-inline void BitBoards<player>::serialise_bit_board(std::vector<Move> &moves, BitBoard bit_board, F from_function)
+std::size_t BitBoards<player>::count_moves(BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                                           BitBoard en_passant_bit_board,
+                                           CastlingRightsUnderlying castling_rights) const
+{
+    MoveCounter move_counter{};
+    get_moves(move_counter, opponent_occupied_bit_board, check_info, en_passant_bit_board, castling_rights);
+
+    return move_counter.size();
+}
+
+template <Player player> Piece BitBoards<player>::get_piece(BitBoard bit_board) const
+{
+    if (pawns & bit_board)
+    {
+        return Piece::Pawn;
+    }
+    else if (knights & bit_board)
+    {
+        return Piece::Knight;
+    }
+    else if (bishops & bit_board)
+    {
+        return Piece::Bishop;
+    }
+    else if (rooks & bit_board)
+    {
+        return Piece::Rook;
+    }
+    else if (queens & bit_board)
+    {
+        return Piece::Queen;
+    }
+
+    return Piece::King;
+}
+
+template <Player player> std::optional<Piece> BitBoards<player>::find_piece(BitBoard bit_board) const
 {
-    for (SquareUnderlying to{0}; bit_board; ++to)
+    if (get_occupied_bit_board() & bit_board)
     {
-        const auto lsb{ls1b(bit_board)};
-        to += lsb;
-        const auto from{static_cast<SquareUnderlying>(from_function(to))};
-        moves.emplace_back(from, to);
-        bit_board >>= (lsb + 1);
+        return get_piece(bit_board);
     }
+
+    return std::nullopt;
 }
 
-template <Player player> inline std::uint8_t BitBoards<player>::count_bits(BitBoard bit_board)
+template <Player player> inline void BitBoards<player>::add_piece(Piece piece, BitBoard bit_board)
 {
-    return std::popcount(bit_board);
+    get_piece_bit_board(piece) ^= bit_board;
 }
 
-template <Player player> inline std::uint8_t BitBoards<player>::ls1b(BitBoard bit_board)
+template <Player player> inline void BitBoards<player>::remove_piece(Piece piece, BitBoard bit_board)
 {
-    return static_cast<std::uint8_t>(std::countr_zero(bit_board));
+    get_piece_bit_board(piece) ^= bit_board;
+}
+
+template <Player player> inline void BitBoards<player>::move_piece(Piece piece, BitBoard from_to_bit_board)
+{
+    get_piece_bit_board(piece) ^= from_to_bit_board;
+}
+
+template <Player player> inline BitBoard &BitBoards<player>::get_piece_bit_board(Piece piece)
+{
+    switch (piece)
+    {
+    case Piece::Pawn:
+        return pawns;
+    case Piece::Knight:
+        return knights;
+    case Piece::Bishop:
+        return bishops;
+    case Piece::Rook:
+        return rooks;
+    case Piece::Queen:
+        return queens;
+    case Piece::King:
+        return king;
+    }
+
+    throw std::logic_error{"Tried to get bit board of unknown piece"};
+}
+
+template <Player player> inline BitBoard BitBoards<player>::get_piece_bit_board(Piece piece) const
+{
+    switch (piece)
+    {
+    case Piece::Pawn:
+        return pawns;
+    case Piece::Knight:
+        return knights;
+    case Piece::Bishop:
+        return bishops;
+    case Piece::Rook:
+        return rooks;
+    case Piece::Queen:
+        return queens;
+    case Piece::King:
+        return king;
+    }
+
+    throw std::logic_error{"Tried to get bit board of unknown piece"};
 }
 
 template <Player player>
 template <Direction direction>
-consteval BitBoard BitBoards<player>::create_diagonal_bit_board(Square starting_square)
+inline BitBoard BitBoards<player>::fill_bit_board(BitBoard bit_board)
 {
-    BitBoard diagonal{square_to_bit_board(starting_square)};
-    diagonal |= direction_shift<direction>(diagonal);
-    diagonal |= direction_shift<Direction{2 * direction}>(diagonal);
-    diagonal |= direction_shift<Direction{4 * direction}>(diagonal);
+    bit_board |= direction_shift<direction>(bit_board, 1u);
+    bit_board |= direction_shift<direction>(bit_board, 2u);
+    bit_board |= direction_shift<direction>(bit_board, 4u);
 
-    return diagonal;
+    return bit_board;
 }
 
-template <Player player> consteval Lookup<BitBoard> BitBoards<player>::create_knight_attacks_bit_board_lookup()
+template <Player player> inline BitBoard BitBoards<player>::get_adjacent_files_bit_board(BitBoard bit_board)
 {
-    Lookup<BitBoard> knight_attacks_bit_board_lookup{};
-    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
-    {
-        const auto from_bit_board{square_to_bit_board(Square{from})};
+    return direction_shift<Direction::E>(bit_board & NOT_H_FILE_BIT_BOARD) |
+           direction_shift<Direction::W>(bit_board & NOT_A_FILE_BIT_BOARD);
+}
 
-        BitBoard attacks_bit_board{0};
-        attacks_bit_board |= direction_shift<Direction::NNE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::ENE>(from_bit_board & NOT_GH_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::ESE>(from_bit_board & NOT_GH_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::SSE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::SSW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::WSW>(from_bit_board & NOT_AB_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::WNW>(from_bit_board & NOT_AB_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::NNW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+template <Player player> inline BitBoard BitBoards<player>::get_pawn_attacks_bit_board(BitBoard pawns_bit_board)
+{
+    return direction_shift<Constants::PAWN_LEFT_CAPTURE_DIRECTION>(pawns_bit_board & ~Constants::LEFT_FILE_BIT_BOARD) |
+           direction_shift<Constants::PAWN_RIGHT_CAPTURE_DIRECTION>(pawns_bit_board & ~Constants::RIGHT_FILE_BIT_BOARD);
+}
 
-        knight_attacks_bit_board_lookup.at(from) = attacks_bit_board;
+template <Player player>
+inline BitBoard BitBoards<player>::get_pin_bit_board(SquareUnderlying from, const CheckInfo &check_info)
+{
+    if (check_info.pinned_bit_board & square_to_bit_board(Square{from}))
+    {
+        return SliderAttacks::get_line_bit_board(check_info.king_square, from);
     }
 
-    return knight_attacks_bit_board_lookup;
+    return ~BitBoard{0};
 }
 
 template <Player player>
-consteval Lookup<BitBoard> BitBoards<player>::create_bishop_relevant_occupancies_bit_board_lookup()
+template <MoveGeneration generation, MoveSink Moves>
+void BitBoards<player>::add_pawn_moves(Moves &moves, BitBoard pawns_bit_board, BitBoard occupied_bit_board,
+                                       BitBoard opponent_occupied_bit_board, BitBoard target_bit_board) const
 {
-    Lookup<BitBoard> bishop_relevant_occupancies_bit_board_lookup{};
-    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    /*
+    Push moves. Double pushes are found from every single push, including ones that miss the target, since only where
+    the pawn lands matters.
+    */
+    auto single_push_bit_board{direction_shift<Constants::PAWN_PUSH_DIRECTION>(pawns_bit_board)};
+    single_push_bit_board &= ~occupied_bit_board;
+    const auto single_push_target_bit_board{single_push_bit_board & target_bit_board};
+    const auto single_push_from_function{[](auto to) { return to - Constants::PAWN_PUSH_DIRECTION; }};
+    if constexpr (generation != MoveGeneration::NoisyMoves)
+    {
+        serialise_bit_board(moves, single_push_target_bit_board & ~Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                            single_push_from_function);
+
+        static constexpr auto SINGLE_PUSH_RANK{
+            direction_shift<Constants::PAWN_PUSH_DIRECTION>(Constants::STARTING_PAWNS_BIT_BOARD)};
+        auto double_push_bit_board{
+            direction_shift<Constants::PAWN_PUSH_DIRECTION>(single_push_bit_board & SINGLE_PUSH_RANK)};
+        double_push_bit_board &= ~occupied_bit_board & target_bit_board;
+        serialise_bit_board(
+            moves, double_push_bit_board,
+            [](auto to) { return to - static_cast<std::uint8_t>(2 * Constants::PAWN_PUSH_DIRECTION); },
+            MoveFlag::DoublePush);
+    }
+
+    if constexpr (generation == MoveGeneration::QuietMoves)
     {
-        const auto diagonal_shift_amount{(from >> 3) - (from & 0x7)}; /* Cursed */
-        const auto antidiagonal_shift_amount{(from & 0x7) + (from >> 3) - 7};
+        return;
+    }
 
-        BitBoard relevant_occupancy_bit_board{0};
+    serialise_promotions(moves, single_push_target_bit_board & Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                         single_push_from_function);
+
+    /*
+    Capture left
+    */
+    const auto left_capture_target_bit_board{
+        direction_shift<Constants::PAWN_LEFT_CAPTURE_DIRECTION>(pawns_bit_board & ~Constants::LEFT_FILE_BIT_BOARD) &
+        opponent_occupied_bit_board & target_bit_board};
+    const auto left_capture_from_function{[](auto to) { return to - Constants::PAWN_LEFT_CAPTURE_DIRECTION; }};
+    serialise_bit_board(moves, left_capture_target_bit_board & ~Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                        left_capture_from_function);
+    serialise_promotions(moves, left_capture_target_bit_board & Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                         left_capture_from_function);
 
-        relevant_occupancy_bit_board |= diagonal_shift(MAIN_DIAGONAL_BIT_BOARD, diagonal_shift_amount);
-        relevant_occupancy_bit_board |= diagonal_shift(MAIN_ANTIDIAGONAL_BIT_BOARD, antidiagonal_shift_amount);
-        relevant_occupancy_bit_board &= NOT_EDGE_BIT_BOARD;
-        relevant_occupancy_bit_board &= ~square_to_bit_board(Square{from});
+    /*
+    Capture right
+    */
+    const auto right_capture_target_bit_board{
+        direction_shift<Constants::PAWN_RIGHT_CAPTURE_DIRECTION>(pawns_bit_board & ~Constants::RIGHT_FILE_BIT_BOARD) &
+        opponent_occupied_bit_board & target_bit_board};
+    const auto right_capture_from_function{[](auto to) { return to - Constants::PAWN_RIGHT_CAPTURE_DIRECTION; }};
+    serialise_bit_board(moves, right_capture_target_bit_board & ~Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                        right_capture_from_function);
+    serialise_promotions(moves, right_capture_target_bit_board & Constants::PAWN_PROMOTION_RANK_BIT_BOARD,
+                         right_capture_from_function);
+}
 
-        bishop_relevant_occupancies_bit_board_lookup.at(from) = relevant_occupancy_bit_board;
+template <Player player>
+template <MoveSink Moves>
+void BitBoards<player>::add_en_passant_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                                             BitBoard en_passant_bit_board) const
+{
+    if (!en_passant_bit_board)
+    {
+        return;
     }
 
-    return bishop_relevant_occupancies_bit_board_lookup;
+    /*
+    Only a pawn that could capture onto the square from the opponent's side can be attacking it
+    */
+    const SquareUnderlying to{ls1b(en_passant_bit_board)};
+    auto from_bit_board{BitBoards<opponent_of(player)>::get_pawn_attacks_bit_board(en_passant_bit_board) & pawns};
+    while (from_bit_board)
+    {
+        const SquareUnderlying from{ls1b(from_bit_board)};
+        if (is_legal_en_passant(from, occupied_bit_board, check_info, en_passant_bit_board))
+        {
+            moves.push_back(Move{from, to, MoveFlag::EnPassant});
+        }
+
+        from_bit_board &= from_bit_board - 1;
+    }
+}
+
+template <Player player>
+bool BitBoards<player>::is_legal_en_passant(SquareUnderlying from, BitBoard occupied_bit_board,
+                                            const CheckInfo &check_info, BitBoard en_passant_bit_board) const
+{
+    /*
+    Either blocks a check or captures the checking pawn, then make sure the king isn't left open along a ray through
+    either pawn. That covers pins as well as both pawns leaving the king's rank together.
+    */
+    const auto captured_bit_board{direction_shift<Direction{-Constants::PAWN_PUSH_DIRECTION}>(en_passant_bit_board)};
+    const auto after_occupied_bit_board{occupied_bit_board ^ square_to_bit_board(Square{from}) ^ en_passant_bit_board ^
+                                        captured_bit_board};
+
+    return ((en_passant_bit_board | captured_bit_board) & check_info.check_mask_bit_board) &&
+           !(SliderAttacks::get_bishop_attacks_bit_board(check_info.king_square, after_occupied_bit_board) &
+             check_info.opponent_diagonal_sliders_bit_board) &&
+           !(SliderAttacks::get_rook_attacks_bit_board(check_info.king_square, after_occupied_bit_board) &
+             check_info.opponent_orthogonal_sliders_bit_board);
 }
 
 template <Player player>
-consteval Lookup<BitBoard> BitBoards<player>::create_rook_relevant_occupancies_bit_board_lookup()
+bool BitBoards<player>::is_legal_pawn_move(Move move, BitBoard occupied_bit_board,
+                                           BitBoard opponent_occupied_bit_board, const CheckInfo &check_info,
+                                           BitBoard en_passant_bit_board, BitBoard target_bit_board) const
 {
-    Lookup<BitBoard> rook_relevant_occupancies_bit_board_lookup{};
-    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    const auto from{move.get_from()};
+    const auto from_bit_board{square_to_bit_board(Square{from})};
+    const auto to_bit_board{square_to_bit_board(Square{move.get_to()})};
+    const auto flag{move.get_flag()};
+
+    if (flag == MoveFlag::EnPassant)
     {
-        const Square from_square{from};
-        const auto rank{square_to_rank(from_square)};
-        const auto file{square_to_file(from_square)};
+        return en_passant_bit_board && to_bit_board == en_passant_bit_board &&
+               (get_pawn_attacks_bit_board(from_bit_board) & to_bit_board) &&
+               is_legal_en_passant(from, occupied_bit_board, check_info, en_passant_bit_board);
+    }
 
-        BitBoard relevant_occupancy_bit_board{0};
-        relevant_occupancy_bit_board |= rank_to_bit_board(rank) & NOT_RANK_END_BIT_BOARD;
-        relevant_occupancy_bit_board |= file_to_bit_board(file) & NOT_FILE_END_BIT_BOARD;
-        relevant_occupancy_bit_board &= ~square_to_bit_board(from_square);
+    const auto single_push_bit_board{direction_shift<Constants::PAWN_PUSH_DIRECTION>(from_bit_board) &
+                                     ~occupied_bit_board};
+    if (flag == MoveFlag::DoublePush)
+    {
+        return (from_bit_board & Constants::STARTING_PAWNS_BIT_BOARD) &&
+               (direction_shift<Constants::PAWN_PUSH_DIRECTION>(single_push_bit_board) & ~occupied_bit_board &
+                to_bit_board & target_bit_board);
+    }
 
-        rook_relevant_occupancies_bit_board_lookup.at(from) = relevant_occupancy_bit_board;
+    /*
+    Reaching the last rank has to promote, and nothing else can
+    */
+    const bool is_promotion_rank{static_cast<bool>(to_bit_board & Constants::PAWN_PROMOTION_RANK_BIT_BOARD)};
+    if ((flag != MoveFlag::Normal && !move.is_promotion()) || move.is_promotion() != is_promotion_rank)
+    {
+        return false;
     }
 
-    return rook_relevant_occupancies_bit_board_lookup;
+    const auto captures_bit_board{get_pawn_attacks_bit_board(from_bit_board) & opponent_occupied_bit_board};
+
+    return (single_push_bit_board | captures_bit_board) & to_bit_board & target_bit_board;
 }
 
-template <Player player> consteval Lookup<BitBoard> BitBoards<player>::create_king_attacks_bit_board_lookup()
+template <Player player>
+template <MoveSink Moves>
+void BitBoards<player>::add_knight_moves(Moves &moves, const CheckInfo &check_info, BitBoard target_bit_board) const
 {
-    Lookup<BitBoard> king_attacks_bit_board_lookup{};
-    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    /*
+    A pinned knight can never stay on the line it's pinned along
+    */
+    auto bit_board{knights & ~check_info.pinned_bit_board};
+    while (bit_board)
     {
-        const auto from_bit_board{square_to_bit_board(Square{from})};
+        const SquareUnderlying from{ls1b(bit_board)};
 
-        BitBoard attacks_bit_board{0};
-        attacks_bit_board |= direction_shift<Direction::N>(from_bit_board);
-        attacks_bit_board |= direction_shift<Direction::NE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::E>(from_bit_board & NOT_H_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::SE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::S>(from_bit_board);
-        attacks_bit_board |= direction_shift<Direction::SW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::W>(from_bit_board & NOT_A_FILE_BIT_BOARD);
-        attacks_bit_board |= direction_shift<Direction::NW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+        const auto attacks_bit_board{LeaperAttacks::get_knight_attacks_bit_board(from) & target_bit_board};
+        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
 
-        king_attacks_bit_board_lookup.at(from) = attacks_bit_board;
+        bit_board &= bit_board - 1;
     }
+}
 
-    return king_attacks_bit_board_lookup;
+template <Player player>
+template <MoveSink Moves>
+void BitBoards<player>::add_bishop_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                                         BitBoard target_bit_board) const
+{
+    auto bit_board{bishops};
+    while (bit_board)
+    {
+        const SquareUnderlying from{ls1b(bit_board)};
+
+        const auto attacks_bit_board{SliderAttacks::get_bishop_attacks_bit_board(from, occupied_bit_board) &
+                                     target_bit_board & get_pin_bit_board(from, check_info)};
+        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+
+        bit_board &= bit_board - 1;
+    }
 }
 
-template <Player player> consteval Lookup<Magic> BitBoards<player>::create_bishop_magics_lookup()
+template <Player player>
+template <MoveSink Moves>
+void BitBoards<player>::add_rook_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                                       BitBoard target_bit_board) const
 {
-    Lookup<Magic> bishop_magics_lookup{};
+    auto bit_board{rooks};
+    while (bit_board)
+    {
+        const SquareUnderlying from{ls1b(bit_board)};
 
-    return bishop_magics_lookup;
+        const auto attacks_bit_board{SliderAttacks::get_rook_attacks_bit_board(from, occupied_bit_board) &
+                                     target_bit_board & get_pin_bit_board(from, check_info)};
+        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+
+        bit_board &= bit_board - 1;
+    }
 }
 
-template <Player player> consteval Lookup<Magic> BitBoards<player>::create_rook_magics_lookup()
+template <Player player>
+template <MoveSink Moves>
+void BitBoards<player>::add_queen_moves(Moves &moves, BitBoard occupied_bit_board, const CheckInfo &check_info,
+                                        BitBoard target_bit_board) const
 {
-    Lookup<Magic> rook_magics_lookup{};
+    auto bit_board{queens};
+    while (bit_board)
+    {
+        const SquareUnderlying from{ls1b(bit_board)};
 
-    return rook_magics_lookup;
+        const auto attacks_bit_board{SliderAttacks::get_queen_attacks_bit_board(from, occupied_bit_board) &
+                                     target_bit_board & get_pin_bit_board(from, check_info)};
+        serialise_bit_board(moves, attacks_bit_board, [from](auto) { return from; });
+
+        bit_board &= bit_board - 1;
+    }
 }
 
 template <Player player>
-consteval BitBoards<player>::BishopAttackLookup BitBoards<player>::create_bishop_attacks_bit_board_lookup()
+template <MoveGeneration generation, MoveSink Moves>
+void BitBoards<player>::add_king_moves(Moves &moves, BitBoard target_bit_board, BitBoard occupied_bit_board,
+                                       const CheckInfo &check_info, CastlingRightsUnderlying castling_rights) const
 {
-    BishopAttackLookup bishop_attacks_bit_board_lookup{};
+    const auto from{check_info.king_square};
+    const auto attacks_no_check_bit_board{LeaperAttacks::get_king_attacks_bit_board(from) & target_bit_board &
+                                          ~check_info.opponent_attacking_bit_board};
+
+    serialise_bit_board(moves, attacks_no_check_bit_board, [from](auto) { return from; });
 
-    return bishop_attacks_bit_board_lookup;
+    if constexpr (generation == MoveGeneration::NoisyMoves)
+    {
+        return;
+    }
+
+    if (can_castle(Constants::KINGSIDE_CASTLING_RIGHT, Constants::KINGSIDE_CASTLING_EMPTY_BIT_BOARD,
+                   Constants::KINGSIDE_CASTLING_SAFE_BIT_BOARD, occupied_bit_board, check_info, castling_rights))
+    {
+        moves.push_back(Move{from, Constants::KINGSIDE_CASTLING_KING_TO, MoveFlag::Castle});
+    }
+
+    if (can_castle(Constants::QUEENSIDE_CASTLING_RIGHT, Constants::QUEENSIDE_CASTLING_EMPTY_BIT_BOARD,
+                   Constants::QUEENSIDE_CASTLING_SAFE_BIT_BOARD, occupied_bit_board, check_info, castling_rights))
+    {
+        moves.push_back(Move{from, Constants::QUEENSIDE_CASTLING_KING_TO, MoveFlag::Castle});
+    }
 }
 
 template <Player player>
-consteval BitBoards<player>::RookAttackLookup BitBoards<player>::create_rook_attacks_bit_board_lookup()
+inline bool BitBoards<player>::can_castle(CastlingRightsUnderlying castling_right, BitBoard empty_bit_board,
+                                          BitBoard safe_bit_board, BitBoard occupied_bit_board,
+                                          const CheckInfo &check_info, CastlingRightsUnderlying castling_rights)
 {
-    RookAttackLookup rook_attacks_bit_board_lookup{};
+    /*
+    Castling rights being set implies the king and rook are still on their starting squares
+    */
+    return (castling_rights & castling_right) && !(occupied_bit_board & empty_bit_board) &&
+           !(check_info.opponent_attacking_bit_board & safe_bit_board);
+}
 
-    return rook_attacks_bit_board_lookup;
+template <Player player>
+template <MoveSink Moves, typename F>
+inline void BitBoards<player>::serialise_bit_board(Moves &moves, BitBoard bit_board, F from_function, MoveFlag flag)
+{
+    if constexpr (std::same_as<Moves, MoveCounter>)
+    {
+        moves.add(count_bits(bit_board));
+    }
+    else
+    {
+        while (bit_board)
+        {
+            const SquareUnderlying to{ls1b(bit_board)};
+            const auto from{static_cast<SquareUnderlying>(from_function(to))};
+            moves.push_back(Move{from, to, flag});
+            bit_board &= bit_board - 1;
+        }
+    }
+}
+
+template <Player player>
+template <MoveSink Moves, typename F>
+inline void BitBoards<player>::serialise_promotions(Moves &moves, BitBoard bit_board, F from_function)
+{
+    if constexpr (std::same_as<Moves, MoveCounter>)
+    {
+        static constexpr auto NUM_PROMOTION_PIECES{4};
+        moves.add(NUM_PROMOTION_PIECES * count_bits(bit_board));
+    }
+    else
+    {
+        while (bit_board)
+        {
+            const SquareUnderlying to{ls1b(bit_board)};
+            const auto from{static_cast<SquareUnderlying>(from_function(to))};
+            moves.push_back(Move{from, to, MoveFlag::QueenPromotion});
+            moves.push_back(Move{from, to, MoveFlag::RookPromotion});
+            moves.push_back(Move{from, to, MoveFlag::BishopPromotion});
+            moves.push_back(Move{from, to, MoveFlag::KnightPromotion});
+            bit_board &= bit_board - 1;
+        }
+    }
+}
+
+template <Player player> inline std::uint8_t BitBoards<player>::count_bits(BitBoard bit_board)
+{
+    return std::popcount(bit_board);
+}
+
+template <Player player> inline std::uint8_t BitBoards<player>::ls1b(BitBoard bit_board)
+{
+    return static_cast<std::uint8_t>(std::countr_zero(bit_board));
 }
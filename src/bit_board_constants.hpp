@@ -17,9 +17,26 @@ template <> struct BitBoardsConstants<Player::White>
     static constexpr auto PAWN_PUSH_DIRECTION{Direction::N};
     static constexpr auto PAWN_LEFT_CAPTURE_DIRECTION{Direction::NW};
     static constexpr auto PAWN_RIGHT_CAPTURE_DIRECTION{Direction::NE};
+    static constexpr auto PAWN_SHIELD_BIT_BOARD{rank_to_bit_board(Rank::R2) | rank_to_bit_board(Rank::R3)};
+    static constexpr auto BACK_RANK_BIT_BOARD{rank_to_bit_board(Rank::R1)};
 
     static constexpr auto LEFT_FILE_BIT_BOARD{file_to_bit_board(File::FA)};
     static constexpr auto RIGHT_FILE_BIT_BOARD{file_to_bit_board(File::FH)};
+    static constexpr auto KINGSIDE_CASTLING_RIGHT{CastlingRights::WhiteKingside};
+    static constexpr auto QUEENSIDE_CASTLING_RIGHT{CastlingRights::WhiteQueenside};
+    static constexpr auto KINGSIDE_CASTLING_EMPTY_BIT_BOARD{square_to_bit_board(Square::F1) |
+                                                            square_to_bit_board(Square::G1)};
+    static constexpr auto QUEENSIDE_CASTLING_EMPTY_BIT_BOARD{
+        square_to_bit_board(Square::B1) | square_to_bit_board(Square::C1) | square_to_bit_board(Square::D1)};
+    static constexpr auto KINGSIDE_CASTLING_SAFE_BIT_BOARD{STARTING_KING_BIT_BOARD | KINGSIDE_CASTLING_EMPTY_BIT_BOARD};
+    static constexpr auto QUEENSIDE_CASTLING_SAFE_BIT_BOARD{
+        STARTING_KING_BIT_BOARD | square_to_bit_board(Square::C1) | square_to_bit_board(Square::D1)};
+    static constexpr auto KINGSIDE_CASTLING_KING_TO{Square::G1};
+    static constexpr auto QUEENSIDE_CASTLING_KING_TO{Square::C1};
+    static constexpr auto KINGSIDE_CASTLING_ROOK_FROM{Square::H1};
+    static constexpr auto KINGSIDE_CASTLING_ROOK_TO{Square::F1};
+    static constexpr auto QUEENSIDE_CASTLING_ROOK_FROM{Square::A1};
+    static constexpr auto QUEENSIDE_CASTLING_ROOK_TO{Square::D1};
 };
 
 template <> struct BitBoardsConstants<Player::Black>
@@ -35,7 +52,24 @@ template <> struct BitBoardsConstants<Player::Black>
     static constexpr auto PAWN_PUSH_DIRECTION{Direction::S};
     static constexpr auto PAWN_LEFT_CAPTURE_DIRECTION{Direction::SE};
     static constexpr auto PAWN_RIGHT_CAPTURE_DIRECTION{Direction::SW};
+    static constexpr auto PAWN_SHIELD_BIT_BOARD{rank_to_bit_board(Rank::R7) | rank_to_bit_board(Rank::R6)};
+    static constexpr auto BACK_RANK_BIT_BOARD{rank_to_bit_board(Rank::R8)};
 
     static constexpr auto LEFT_FILE_BIT_BOARD{file_to_bit_board(File::FH)};
     static constexpr auto RIGHT_FILE_BIT_BOARD{file_to_bit_board(File::FA)};
+    static constexpr auto KINGSIDE_CASTLING_RIGHT{CastlingRights::BlackKingside};
+    static constexpr auto QUEENSIDE_CASTLING_RIGHT{CastlingRights::BlackQueenside};
+    static constexpr auto KINGSIDE_CASTLING_EMPTY_BIT_BOARD{square_to_bit_board(Square::F8) |
+                                                            square_to_bit_board(Square::G8)};
+    static constexpr auto QUEENSIDE_CASTLING_EMPTY_BIT_BOARD{
+        square_to_bit_board(Square::B8) | square_to_bit_board(Square::C8) | square_to_bit_board(Square::D8)};
+    static constexpr auto KINGSIDE_CASTLING_SAFE_BIT_BOARD{STARTING_KING_BIT_BOARD | KINGSIDE_CASTLING_EMPTY_BIT_BOARD};
+    static constexpr auto QUEENSIDE_CASTLING_SAFE_BIT_BOARD{
+        STARTING_KING_BIT_BOARD | square_to_bit_board(Square::C8) | square_to_bit_board(Square::D8)};
+    static constexpr auto KINGSIDE_CASTLING_KING_TO{Square::G8};
+    static constexpr auto QUEENSIDE_CASTLING_KING_TO{Square::C8};
+    static constexpr auto KINGSIDE_CASTLING_ROOK_FROM{Square::H8};
+    static constexpr auto KINGSIDE_CASTLING_ROOK_TO{Square::F8};
+    static constexpr auto QUEENSIDE_CASTLING_ROOK_FROM{Square::A8};
+    static constexpr auto QUEENSIDE_CASTLING_ROOK_TO{Square::D8};
 };
@@ -0,0 +1,81 @@
+#include "board_validity.hpp"
+
+#include "bit_board_constants.hpp"
+
+#include <bit>
+
+bool BoardValidity::is_valid_piece_placement(const PieceBitBoards &piece_bit_boards)
+{
+    const auto back_ranks_bit_board{rank_to_bit_board(Rank::R1) | rank_to_bit_board(Rank::R8)};
+    for (const auto &player_piece_bit_boards : piece_bit_boards)
+    {
+        if (std::popcount(player_piece_bit_boards[Piece::King]) != 1 ||
+            (player_piece_bit_boards[Piece::Pawn] & back_ranks_bit_board))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BoardValidity::is_valid_castling_rights(const PieceBitBoards &piece_bit_boards,
+                                             CastlingRightsUnderlying castling_rights)
+{
+    return is_valid_castling_rights<Player::White>(piece_bit_boards, castling_rights) &&
+           is_valid_castling_rights<Player::Black>(piece_bit_boards, castling_rights);
+}
+
+template <Player player>
+bool BoardValidity::is_valid_castling_rights(const PieceBitBoards &piece_bit_boards,
+                                             CastlingRightsUnderlying castling_rights)
+{
+    using Constants = BitBoardsConstants<player>;
+
+    const auto &player_piece_bit_boards{piece_bit_boards[player]};
+    if ((castling_rights & (Constants::KINGSIDE_CASTLING_RIGHT | Constants::QUEENSIDE_CASTLING_RIGHT)) &&
+        !(player_piece_bit_boards[Piece::King] & Constants::STARTING_KING_BIT_BOARD))
+    {
+        return false;
+    }
+    if ((castling_rights & Constants::KINGSIDE_CASTLING_RIGHT) &&
+        !(player_piece_bit_boards[Piece::Rook] & square_to_bit_board(Constants::KINGSIDE_CASTLING_ROOK_FROM)))
+    {
+        return false;
+    }
+
+    return !(castling_rights & Constants::QUEENSIDE_CASTLING_RIGHT) ||
+           (player_piece_bit_boards[Piece::Rook] & square_to_bit_board(Constants::QUEENSIDE_CASTLING_ROOK_FROM));
+}
+
+bool BoardValidity::is_valid_en_passant_square(const PieceBitBoards &piece_bit_boards, Player current_player,
+                                               Square en_passant_square)
+{
+    const auto opponent{opponent_of(current_player)};
+    if (square_to_rank(en_passant_square) != (current_player == Player::White ? Rank::R6 : Rank::R3))
+    {
+        return false;
+    }
+
+    /*
+    The opponent's pawn went from behind the square to in front of it, as seen by the player to move
+    */
+    const auto en_passant_bit_board{square_to_bit_board(en_passant_square)};
+    const auto pawn_bit_board{current_player == Player::White ? direction_shift<Direction::S>(en_passant_bit_board)
+                                                              : direction_shift<Direction::N>(en_passant_bit_board)};
+    const auto pawn_from_bit_board{current_player == Player::White
+                                       ? direction_shift<Direction::N>(en_passant_bit_board)
+                                       : direction_shift<Direction::S>(en_passant_bit_board)};
+
+    BitBoard occupied_bit_board{0};
+    for (const auto &player_piece_bit_boards : piece_bit_boards)
+    {
+        for (const auto piece_bit_board : player_piece_bit_boards)
+        {
+            occupied_bit_board |= piece_bit_board;
+        }
+    }
+
+    return (piece_bit_boards[opponent][Piece::Pawn] & pawn_bit_board) &&
+           !(occupied_bit_board & (en_passant_bit_board | pawn_from_bit_board));
+}
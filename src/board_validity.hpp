@@ -0,0 +1,41 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <array>
+
+/*
+What a board read from outside has to hold before a Position can be built from it. Move generation trusts all of it, so
+a board that breaks any of these can generate moves that make pieces out of nothing.
+*/
+class BoardValidity
+{
+  public:
+    static constexpr auto NUM_PLAYERS{2};
+    static constexpr auto NUM_PIECES{6};
+
+    using PieceBitBoards = std::array<std::array<BitBoard, NUM_PIECES>, NUM_PLAYERS>;
+
+    /*
+    Exactly one king each and no pawns on the first or last rank
+    */
+    static bool is_valid_piece_placement(const PieceBitBoards &piece_bit_boards);
+
+    /*
+    Each right's king and rook are still on their starting squares
+    */
+    static bool is_valid_castling_rights(const PieceBitBoards &piece_bit_boards,
+                                         CastlingRightsUnderlying castling_rights);
+
+    /*
+    On the sixth rank with white to move or the third with black, with the pawn that just moved two squares in front of
+    it, and both the square and the one the pawn came from empty
+    */
+    static bool is_valid_en_passant_square(const PieceBitBoards &piece_bit_boards, Player current_player,
+                                           Square en_passant_square);
+
+  private:
+    template <Player player>
+    static bool is_valid_castling_rights(const PieceBitBoards &piece_bit_boards,
+                                         CastlingRightsUnderlying castling_rights);
+};
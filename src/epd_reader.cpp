@@ -0,0 +1,107 @@
+#include "epd_reader.hpp"
+
+#include "newline_scan.hpp"
+
+#include <algorithm>
+
+EpdReader::EpdReader(const std::string &path) : file{path}
+{
+}
+
+EpdReader::Statistics EpdReader::read(const Callback &callback) const
+{
+    return read_chunk(file.get_contents(), callback);
+}
+
+EpdReader::Statistics EpdReader::read(ThreadPool &thread_pool, const Callback &callback) const
+{
+    const auto chunks{split_into_chunks(thread_pool.get_num_threads() * CHUNKS_PER_THREAD)};
+    std::vector<Statistics> chunk_statistics(chunks.size());
+    for (std::size_t chunk_idx{0}; chunk_idx < chunks.size(); ++chunk_idx)
+    {
+        thread_pool.submit([&chunks, &chunk_statistics, &callback, chunk_idx] {
+            chunk_statistics[chunk_idx] = read_chunk(chunks[chunk_idx], callback);
+        });
+    }
+    thread_pool.wait();
+
+    Statistics statistics{0, 0};
+    for (const auto &[positions, invalid_lines] : chunk_statistics)
+    {
+        statistics.positions += positions;
+        statistics.invalid_lines += invalid_lines;
+    }
+
+    return statistics;
+}
+
+std::vector<std::string_view> EpdReader::split_into_chunks(std::size_t max_chunks) const
+{
+    const auto contents{file.get_contents()};
+    const auto num_chunks{std::clamp<std::size_t>(contents.size() / MIN_CHUNK_BYTES, 1, max_chunks)};
+
+    /*
+    Each chunk ends just after the first newline past its share of the file
+    */
+    std::vector<std::string_view> chunks{};
+    std::size_t chunk_begin{0};
+    for (std::size_t chunk_idx{1}; chunk_idx <= num_chunks && chunk_begin < contents.size(); ++chunk_idx)
+    {
+        auto chunk_end{contents.size()};
+        if (chunk_idx < num_chunks)
+        {
+            const auto share_end{std::max(chunk_begin, contents.size() * chunk_idx / num_chunks)};
+            const auto newline_idx{contents.find('\n', share_end)};
+            chunk_end = newline_idx == std::string_view::npos ? contents.size() : newline_idx + 1;
+        }
+
+        chunks.push_back(contents.substr(chunk_begin, chunk_end - chunk_begin));
+        chunk_begin = chunk_end;
+    }
+
+    return chunks;
+}
+
+EpdReader::Statistics EpdReader::read_chunk(std::string_view chunk, const Callback &callback)
+{
+    Statistics statistics{0, 0};
+    FenParser fen_parser{};
+    NewlineScan::for_each_line(chunk, [&fen_parser, &callback, &statistics](std::string_view line) {
+        read_line(line, fen_parser, callback, statistics);
+    });
+
+    return statistics;
+}
+
+void EpdReader::read_line(std::string_view line, FenParser &fen_parser, const Callback &callback,
+                          Statistics &statistics)
+{
+    if (line.empty())
+    {
+        return;
+    }
+
+    auto fields_end{line.find(' ')};
+    for (auto field{1}; field < NUM_EPD_FIELDS && fields_end != std::string_view::npos; ++field)
+    {
+        fields_end = line.find(' ', fields_end + 1);
+    }
+
+    EpdLine epd_line{line, {}};
+    auto fen{line};
+    if (fields_end != std::string_view::npos &&
+        (fields_end + 1 == line.size() || line[fields_end + 1] < '0' || line[fields_end + 1] > '9'))
+    {
+        fen = line.substr(0, fields_end);
+        epd_line.operations = line.substr(fields_end + 1);
+    }
+
+    if (fen_parser.parse(fen) != FenError::NoFenError)
+    {
+        ++statistics.invalid_lines;
+        return;
+    }
+
+    ++statistics.positions;
+    callback(epd_line, fen_parser);
+}
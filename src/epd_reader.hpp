@@ -0,0 +1,77 @@
+#pragma once
+
+#include "fen_parser.hpp"
+#include "mapped_file.hpp"
+#include "memory.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+One line of a position file, as views into the mapping. The operations are whatever follows the position on an EPD
+line, such as "bm Nf3; id \"1\";", and are empty for a FEN.
+*/
+struct EpdLine
+{
+    std::string_view text;
+    std::string_view operations;
+};
+
+/*
+Every position in a memory mapped EPD or FEN file, one per line. Lines are parsed where they are in the mapping, so
+nothing is copied or allocated per line, and building a Position from the parser is left to whoever needs one. Blank
+lines are skipped, and so are lines that don't parse, which are only counted.
+
+A line with more than four fields is a FEN when the fifth starts with a digit, otherwise an EPD line whose operations
+start there.
+*/
+class EpdReader
+{
+  public:
+    using Callback = std::function<void(const EpdLine &line, const FenParser &fen_parser)>;
+
+    struct Statistics
+    {
+        std::uint64_t positions;
+        std::uint64_t invalid_lines;
+    };
+
+    /*
+    Throws if the file can't be mapped
+    */
+    explicit EpdReader(const std::string &path);
+
+    /*
+    In file order, on the calling thread
+    */
+    Statistics read(const Callback &callback) const;
+
+    /*
+    Splits the file at line boundaries into several chunks per thread, so one slow chunk doesn't leave the others idle,
+    and parses them all at once. Lines aren't called back in file order, and the callback is called from several
+    threads at once. Must not be called from inside one of the pool's tasks.
+    */
+    Statistics read(ThreadPool &thread_pool, const Callback &callback) const;
+
+  private:
+    static constexpr std::size_t CHUNKS_PER_THREAD{8};
+
+    /*
+    Smaller files aren't worth handing out to other threads
+    */
+    static constexpr std::size_t MIN_CHUNK_BYTES{MEGABYTE};
+
+    static constexpr auto NUM_EPD_FIELDS{4};
+
+    std::vector<std::string_view> split_into_chunks(std::size_t max_chunks) const;
+    static Statistics read_chunk(std::string_view chunk, const Callback &callback);
+    static void read_line(std::string_view line, FenParser &fen_parser, const Callback &callback,
+                          Statistics &statistics);
+
+    MappedFile file;
+};
@@ -1,73 +1,171 @@
 #include "fen_parser.hpp"
 
-FenParser::FenParser(std::string_view fen) : board_array{}, current_player{}
+#include <charconv>
+#include <sstream>
+#include <stdexcept>
+
+consteval Lookup<std::uint8_t, FenParser::NUM_CHARACTERS> FenParser::create_piece_characters_lookup()
+{
+    constexpr std::string_view WHITE_PIECE_CHARACTERS{"PNBRQK"};
+    constexpr std::string_view BLACK_PIECE_CHARACTERS{"pnbrqk"};
+
+    Lookup<std::uint8_t, NUM_CHARACTERS> piece_characters_lookup{};
+    for (std::uint8_t piece{0}; piece < NUM_PIECES; ++piece)
+    {
+        piece_characters_lookup[static_cast<unsigned char>(WHITE_PIECE_CHARACTERS[piece])] =
+            static_cast<std::uint8_t>(1 + Player::White * NUM_PIECES + piece);
+        piece_characters_lookup[static_cast<unsigned char>(BLACK_PIECE_CHARACTERS[piece])] =
+            static_cast<std::uint8_t>(1 + Player::Black * NUM_PIECES + piece);
+    }
+
+    return piece_characters_lookup;
+}
+
+constexpr Lookup<std::uint8_t, FenParser::NUM_CHARACTERS> FenParser::PIECE_CHARACTERS_LOOKUP{
+    create_piece_characters_lookup()};
+
+FenParser::FenParser()
+    : piece_bit_boards{}, current_player{Player::White}, castling_rights{CastlingRights::NoCastling},
+      en_passant_square{}, halfmove_clock{0}, fullmove_counter{1}
 {
-    const auto segments{split(fen, ' ')};
+}
 
-    if (segments.size() != 6)
+FenParser::FenParser(std::string_view fen) : FenParser{}
+{
+    const auto error{parse(fen)};
+    if (error != FenError::NoFenError)
     {
-        throw std::logic_error{"FEN expects 6 segments"};
+        std::ostringstream message{};
+        message << "FEN " << fen << " has an " << error;
+        throw std::logic_error{message.str()};
     }
+}
+
+FenError FenParser::parse(std::string_view fen)
+{
+    piece_bit_boards = {};
+    castling_rights = CastlingRights::NoCastling;
+    en_passant_square = std::nullopt;
+    halfmove_clock = 0;
+    fullmove_counter = 1;
 
-    const auto piece_placement{split(segments[0], '/')};
-    std::size_t board_array_idx{0};
-    for (auto rank_it{piece_placement.rbegin()}; rank_it != piece_placement.rend(); ++rank_it)
+    if (!parse_piece_placement(fen))
     {
-        for (const auto token : *rank_it)
+        return FenError::InvalidPiecePlacement;
+    }
+    if (!parse_side_to_move(fen))
+    {
+        return FenError::InvalidSideToMove;
+    }
+    if (!parse_castling_ability(fen))
+    {
+        return FenError::InvalidCastlingAbility;
+    }
+    if (!parse_en_passant_square(fen))
+    {
+        return FenError::InvalidEnPassantSquare;
+    }
+    if (fen.empty())
+    {
+        return FenError::NoFenError;
+    }
+    if (!parse_number(fen, halfmove_clock))
+    {
+        return FenError::InvalidHalfmoveClock;
+    }
+    if (!parse_separator(fen) || !parse_number(fen, fullmove_counter))
+    {
+        return FenError::InvalidFullmoveCounter;
+    }
+
+    return fen.empty() ? FenError::NoFenError : FenError::TrailingCharacters;
+}
+
+Player FenParser::get_current_player() const
+{
+    return current_player;
+}
+
+CastlingRightsUnderlying FenParser::get_castling_rights() const
+{
+    return castling_rights;
+}
+
+std::optional<Square> FenParser::get_en_passant_square() const
+{
+    return en_passant_square;
+}
+
+std::uint8_t FenParser::get_halfmove_clock() const
+{
+    return halfmove_clock;
+}
+
+std::uint16_t FenParser::get_fullmove_counter() const
+{
+    return fullmove_counter;
+}
+
+bool FenParser::parse_piece_placement(std::string_view &fen)
+{
+    /*
+    Ranks are listed from the eighth down, each from the a file across
+    */
+    auto rank{static_cast<int>(Rank::R8)};
+    auto file{0};
+    std::size_t idx{0};
+    for (; idx < fen.size() && fen[idx] != ' '; ++idx)
+    {
+        const auto token{fen[idx]};
+        if (token == '/')
+        {
+            if (file != BOARD_WIDTH || rank == Rank::R1)
+            {
+                return false;
+            }
+            --rank;
+            file = 0;
+        }
+        else if (token >= '1' && token <= '8')
         {
-            if (std::isdigit(token))
+            file += token - '0';
+            if (file > BOARD_WIDTH)
             {
-                for (auto count{0}; count < token - '0'; ++count)
-                {
-                    board_array[board_array_idx] = std::nullopt;
-                    ++board_array_idx;
-                }
+                return false;
             }
-            else
+        }
+        else
+        {
+            const auto piece_character{PIECE_CHARACTERS_LOOKUP[static_cast<unsigned char>(token)]};
+            if (!piece_character || file == BOARD_WIDTH)
             {
-                Player player{std::isupper(token) ? Player::White : Player::Black};
-                Piece piece{};
-                switch (std::toupper(token))
-                {
-                case 'P':
-                    piece = Piece::Pawn;
-                    break;
-                case 'N':
-                    piece = Piece::Knight;
-                    break;
-                case 'B':
-                    piece = Piece::Bishop;
-                    break;
-                case 'R':
-                    piece = Piece::Rook;
-                    break;
-                case 'Q':
-                    piece = Piece::Queen;
-                    break;
-                case 'K':
-                    piece = Piece::King;
-                    break;
-                default:
-                    throw std::logic_error{"FEN piece wasn't any of expected"};
-                }
-                board_array[board_array_idx].emplace(player, piece);
-                ++board_array_idx;
+                return false;
             }
+
+            const auto player_piece{piece_character - 1};
+            piece_bit_boards[player_piece / NUM_PIECES][player_piece % NUM_PIECES] |=
+                square_to_bit_board(Square(rank * BOARD_WIDTH + file));
+            ++file;
         }
     }
 
-    if (board_array_idx != BOARD_SQUARES)
+    if (rank != Rank::R1 || file != BOARD_WIDTH || !BoardValidity::is_valid_piece_placement(piece_bit_boards))
     {
-        throw std::logic_error{"FEN piece placement didn't contain correct amount of squares"};
+        return false;
     }
+    fen.remove_prefix(idx);
 
-    const auto side_to_move{segments[1]};
-    if (side_to_move.size() != 1)
+    return parse_separator(fen);
+}
+
+bool FenParser::parse_side_to_move(std::string_view &fen)
+{
+    if (fen.empty())
     {
-        throw std::logic_error{"FEN did not have a single character side to move field"};
+        return false;
     }
 
-    switch (*side_to_move.begin())
+    switch (fen.front())
     {
     case 'w':
         current_player = Player::White;
@@ -76,36 +174,138 @@ FenParser::FenParser(std::string_view fen) : board_array{}, current_player{}
         current_player = Player::Black;
         break;
     default:
-        throw std::logic_error{"FEN contained side to move field that was not 'w' or 'b'"};
+        return false;
     }
+    fen.remove_prefix(1);
 
-    // TODO: Parse remaining segments
-    const auto castling_ability{segments[2]};
-    const auto en_passant_target_squares{segments[3]};
-    const auto halfmove_clock{segments[4]};
-    const auto fullmove_counter{segments[5]};
+    return parse_separator(fen);
 }
 
-const std::array<std::optional<std::pair<Player, Piece>>, BOARD_SQUARES> &FenParser::get_board_array() const
+bool FenParser::parse_castling_ability(std::string_view &fen)
 {
-    return board_array;
+    if (!fen.empty() && fen.front() == '-')
+    {
+        fen.remove_prefix(1);
+
+        return parse_separator(fen);
+    }
+
+    std::size_t idx{0};
+    for (; idx < fen.size() && fen[idx] != ' '; ++idx)
+    {
+        CastlingRightsUnderlying castling_right{CastlingRights::NoCastling};
+        switch (fen[idx])
+        {
+        case 'K':
+            castling_right = CastlingRights::WhiteKingside;
+            break;
+        case 'Q':
+            castling_right = CastlingRights::WhiteQueenside;
+            break;
+        case 'k':
+            castling_right = CastlingRights::BlackKingside;
+            break;
+        case 'q':
+            castling_right = CastlingRights::BlackQueenside;
+            break;
+        default:
+            return false;
+        }
+
+        if (castling_rights & castling_right)
+        {
+            return false;
+        }
+        castling_rights |= castling_right;
+    }
+
+    if (!idx || !BoardValidity::is_valid_castling_rights(piece_bit_boards, castling_rights))
+    {
+        return false;
+    }
+    fen.remove_prefix(idx);
+
+    return parse_separator(fen);
 }
 
-Player FenParser::get_current_player() const
+bool FenParser::parse_en_passant_square(std::string_view &fen)
 {
-    return current_player;
+    if (!fen.empty() && fen.front() == '-')
+    {
+        fen.remove_prefix(1);
+    }
+    else
+    {
+        if (fen.size() < 2 || fen[0] < 'a' || fen[0] > 'h' || fen[1] < '1' || fen[1] > '8')
+        {
+            return false;
+        }
+
+        const auto file{fen[0] - 'a'};
+        const auto rank{fen[1] - '1'};
+        en_passant_square = Square(rank * BOARD_WIDTH + file);
+        if (!BoardValidity::is_valid_en_passant_square(piece_bit_boards, current_player, *en_passant_square))
+        {
+            return false;
+        }
+        fen.remove_prefix(2);
+    }
+
+    return fen.empty() || parse_separator(fen);
+}
+
+template <std::unsigned_integral T> bool FenParser::parse_number(std::string_view &fen, T &number)
+{
+    const auto [end, error]{std::from_chars(fen.data(), fen.data() + fen.size(), number)};
+    if (error != std::errc{} || end == fen.data())
+    {
+        return false;
+    }
+    fen.remove_prefix(static_cast<std::size_t>(end - fen.data()));
+
+    return true;
+}
+
+bool FenParser::parse_separator(std::string_view &fen)
+{
+    if (fen.size() < 2 || fen.front() != ' ')
+    {
+        return false;
+    }
+    fen.remove_prefix(1);
+
+    return true;
 }
 
-std::vector<std::string_view> FenParser::split(std::string_view string, char delimiter)
+std::ostream &operator<<(std::ostream &os, FenError error)
 {
-    std::vector<std::string_view> tokens{};
-    std::size_t begin_idx{0};
-    for (std::size_t end_idx{string.find(delimiter)};
-         (end_idx = string.find(delimiter, begin_idx)) != std::string_view::npos; begin_idx = end_idx + 1)
+    switch (error)
     {
-        tokens.push_back(string.substr(begin_idx, end_idx - begin_idx));
+    case FenError::NoFenError:
+        os << "no error";
+        break;
+    case FenError::InvalidPiecePlacement:
+        os << "invalid piece placement";
+        break;
+    case FenError::InvalidSideToMove:
+        os << "invalid side to move";
+        break;
+    case FenError::InvalidCastlingAbility:
+        os << "invalid castling ability";
+        break;
+    case FenError::InvalidEnPassantSquare:
+        os << "invalid en passant target square";
+        break;
+    case FenError::InvalidHalfmoveClock:
+        os << "invalid halfmove clock";
+        break;
+    case FenError::InvalidFullmoveCounter:
+        os << "invalid fullmove counter";
+        break;
+    case FenError::TrailingCharacters:
+        os << "unexpected character after the last field";
+        break;
     }
-    tokens.push_back(string.substr(begin_idx));
 
-    return tokens;
+    return os;
 }
@@ -1,24 +1,100 @@
 #pragma once
 
+#include "board_validity.hpp"
 #include "types.hpp"
 
 #include <array>
+#include <concepts>
+#include <cstdint>
+#include <iostream>
 #include <optional>
-#include <utility>
-#include <vector>
+#include <string_view>
 
+/*
+The first field of a FEN that couldn't be parsed
+*/
+enum FenError : std::uint8_t
+{
+    NoFenError,
+    InvalidPiecePlacement,
+    InvalidSideToMove,
+    InvalidCastlingAbility,
+    InvalidEnPassantSquare,
+    InvalidHalfmoveClock,
+    InvalidFullmoveCounter,
+    TrailingCharacters,
+};
+
+std::ostream &operator<<(std::ostream &os, FenError error);
+
+/*
+Reads every field in a single pass straight into a bitboard per piece, without allocating. The clocks can be left off,
+as they are in EPD, in which case they're 0 and 1. The placement, castling rights and en passant square are checked
+against each other by BoardValidity, so anything that parses can be made into a Position.
+*/
 class FenParser
 {
   public:
+    /*
+    An empty board, to be filled by parse
+    */
+    FenParser();
+
+    /*
+    Throws if the FEN is invalid
+    */
     FenParser(std::string_view fen);
 
-    const std::array<std::optional<std::pair<Player, Piece>>, BOARD_SQUARES> &get_board_array() const;
+    /*
+    Replaces whatever was parsed before, so one parser can be reused for a whole file of positions. Never throws, so a
+    bad position can be skipped cheaply. After an error the fields are left partly parsed.
+    */
+    FenError parse(std::string_view fen);
+
+    BitBoard get_piece_bit_board(Player player, Piece piece) const;
     Player get_current_player() const;
+    CastlingRightsUnderlying get_castling_rights() const;
+    std::optional<Square> get_en_passant_square() const;
+    std::uint8_t get_halfmove_clock() const;
+    std::uint16_t get_fullmove_counter() const;
 
   private:
-    static std::vector<std::string_view> split(std::string_view string, char delimiter);
+    static constexpr auto NUM_PIECES{6};
+    static constexpr auto NUM_CHARACTERS{256};
 
-    std::array<std::optional<std::pair<Player, Piece>>, BOARD_SQUARES> board_array;
+    /*
+    Zero for characters that aren't a piece, otherwise one more than the player's pieces before it plus the piece
+    */
+    static consteval Lookup<std::uint8_t, NUM_CHARACTERS> create_piece_characters_lookup();
+    static const Lookup<std::uint8_t, NUM_CHARACTERS> PIECE_CHARACTERS_LOOKUP;
+
+    /*
+    Each consumes its field from the front of the FEN along with the space before the next one
+    */
+    bool parse_piece_placement(std::string_view &fen);
+    bool parse_side_to_move(std::string_view &fen);
+    bool parse_castling_ability(std::string_view &fen);
+    bool parse_en_passant_square(std::string_view &fen);
+
+    /*
+    Only consumes the digits
+    */
+    template <std::unsigned_integral T> static bool parse_number(std::string_view &fen, T &number);
+
+    /*
+    Fields are separated by a single space, and the last one runs to the end of the FEN
+    */
+    static bool parse_separator(std::string_view &fen);
+
+    BoardValidity::PieceBitBoards piece_bit_boards;
     Player current_player;
-    // TODO: Caslting, en passant, halfmove clock, fullmove counter
+    CastlingRightsUnderlying castling_rights;
+    std::optional<Square> en_passant_square;
+    std::uint8_t halfmove_clock;
+    std::uint16_t fullmove_counter;
 };
+
+inline BitBoard FenParser::get_piece_bit_board(Player player, Piece piece) const
+{
+    return piece_bit_boards[player][piece];
+}
@@ -0,0 +1,52 @@
+#include "leaper_attacks.hpp"
+
+consteval Lookup<BitBoard> LeaperAttacks::create_knight_attacks_bit_board_lookup()
+{
+    Lookup<BitBoard> knight_attacks_bit_board_lookup{};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto from_bit_board{square_to_bit_board(Square{from})};
+
+        BitBoard attacks_bit_board{0};
+        attacks_bit_board |= direction_shift<Direction::NNE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::ENE>(from_bit_board & NOT_GH_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::ESE>(from_bit_board & NOT_GH_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::SSE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::SSW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::WSW>(from_bit_board & NOT_AB_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::WNW>(from_bit_board & NOT_AB_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::NNW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+
+        knight_attacks_bit_board_lookup.at(from) = attacks_bit_board;
+    }
+
+    return knight_attacks_bit_board_lookup;
+}
+
+consteval Lookup<BitBoard> LeaperAttacks::create_king_attacks_bit_board_lookup()
+{
+    Lookup<BitBoard> king_attacks_bit_board_lookup{};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto from_bit_board{square_to_bit_board(Square{from})};
+
+        BitBoard attacks_bit_board{0};
+        attacks_bit_board |= direction_shift<Direction::N>(from_bit_board);
+        attacks_bit_board |= direction_shift<Direction::NE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::E>(from_bit_board & NOT_H_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::SE>(from_bit_board & NOT_H_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::S>(from_bit_board);
+        attacks_bit_board |= direction_shift<Direction::SW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::W>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+        attacks_bit_board |= direction_shift<Direction::NW>(from_bit_board & NOT_A_FILE_BIT_BOARD);
+
+        king_attacks_bit_board_lookup.at(from) = attacks_bit_board;
+    }
+
+    return king_attacks_bit_board_lookup;
+}
+
+alignas(CACHE_LINE_BYTES) constexpr Lookup<BitBoard> LeaperAttacks::KNIGHT_ATTACKS_BIT_BOARD_LOOKUP{
+    create_knight_attacks_bit_board_lookup()};
+alignas(CACHE_LINE_BYTES) constexpr Lookup<BitBoard> LeaperAttacks::KING_ATTACKS_BIT_BOARD_LOOKUP{
+    create_king_attacks_bit_board_lookup()};
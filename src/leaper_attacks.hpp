@@ -0,0 +1,34 @@
+#pragma once
+
+#include "memory.hpp"
+#include "types.hpp"
+
+/*
+Knight and king attacks, which only depend on the square. Shared by both colours so there's a single copy in cache.
+*/
+class LeaperAttacks
+{
+  public:
+    static BitBoard get_knight_attacks_bit_board(SquareUnderlying from);
+    static BitBoard get_king_attacks_bit_board(SquareUnderlying from);
+
+  private:
+    static constexpr auto NOT_AB_FILE_BIT_BOARD{NOT_A_FILE_BIT_BOARD & ~file_to_bit_board(File::FB)};
+    static constexpr auto NOT_GH_FILE_BIT_BOARD{NOT_H_FILE_BIT_BOARD & ~file_to_bit_board(File::FG)};
+
+    static consteval Lookup<BitBoard> create_knight_attacks_bit_board_lookup();
+    static consteval Lookup<BitBoard> create_king_attacks_bit_board_lookup();
+
+    alignas(CACHE_LINE_BYTES) static const Lookup<BitBoard> KNIGHT_ATTACKS_BIT_BOARD_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const Lookup<BitBoard> KING_ATTACKS_BIT_BOARD_LOOKUP;
+};
+
+inline BitBoard LeaperAttacks::get_knight_attacks_bit_board(SquareUnderlying from)
+{
+    return KNIGHT_ATTACKS_BIT_BOARD_LOOKUP[from];
+}
+
+inline BitBoard LeaperAttacks::get_king_attacks_bit_board(SquareUnderlying from)
+{
+    return KING_ATTACKS_BIT_BOARD_LOOKUP[from];
+}
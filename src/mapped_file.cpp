@@ -0,0 +1,56 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) : mapping{nullptr}, size_bytes{0}
+{
+    const auto file_descriptor{open(path.c_str(), O_RDONLY)};
+    if (file_descriptor < 0)
+    {
+        throw std::logic_error{"Couldn't open " + path};
+    }
+
+    struct stat file_stat
+    {
+    };
+    if (fstat(file_descriptor, &file_stat))
+    {
+        close(file_descriptor);
+        throw std::logic_error{"Couldn't get the size of " + path};
+    }
+
+    size_bytes = static_cast<std::size_t>(file_stat.st_size);
+    if (!size_bytes)
+    {
+        close(file_descriptor);
+        return;
+    }
+
+    /*
+    The mapping stays valid once the file is closed
+    */
+    mapping = mmap(nullptr, size_bytes, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::logic_error{"Couldn't map " + path};
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (mapping != nullptr)
+    {
+        munmap(mapping, size_bytes);
+    }
+}
+
+std::string_view MappedFile::get_contents() const
+{
+    return {static_cast<const char *>(mapping), size_bytes};
+}
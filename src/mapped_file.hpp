@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+A whole file mapped read only. Pages are only read in from disk when first touched and are shared with anything else
+mapping the same file, so files far bigger than memory can be walked through without copying them.
+*/
+class MappedFile
+{
+  public:
+    /*
+    Throws if the file can't be opened or mapped
+    */
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /*
+    Empty for an empty file, which can't be mapped
+    */
+    std::string_view get_contents() const;
+
+  private:
+    void *mapping;
+    std::size_t size_bytes;
+};
@@ -0,0 +1,36 @@
+#include "memory.hpp"
+
+#include <sys/mman.h>
+
+void FreeDeleter::operator()(void *memory) const
+{
+    std::free(memory);
+}
+
+void *allocate_aligned(std::size_t size_bytes, bool use_huge_pages)
+{
+    const auto huge_pages{use_huge_pages && size_bytes >= HUGE_PAGE_BYTES};
+    const auto alignment{huge_pages ? HUGE_PAGE_BYTES : CACHE_LINE_BYTES};
+
+    /*
+    aligned_alloc needs the size to be a multiple of the alignment
+    */
+    const auto aligned_size_bytes{(size_bytes + alignment - 1) / alignment * alignment};
+    auto *memory{std::aligned_alloc(alignment, aligned_size_bytes)};
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+    {
+        /*
+        Only a hint, so failure just means regular pages and more TLB misses
+        */
+        madvise(memory, aligned_size_bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    return memory;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+struct FreeDeleter
+{
+    void operator()(void *memory) const;
+};
+
+template <typename T> using AlignedArray = std::unique_ptr<T[], FreeDeleter>;
+
+static constexpr std::size_t CACHE_LINE_BYTES{64};
+static constexpr std::size_t MEGABYTE{1024 * 1024};
+static constexpr std::size_t HUGE_PAGE_BYTES{2 * MEGABYTE};
+
+/*
+Cache line aligned at least. Large enough allocations are aligned to and advised to use huge pages when asked, which
+cuts TLB misses for tables that are probed randomly.
+*/
+void *allocate_aligned(std::size_t size_bytes, bool use_huge_pages);
+
+template <typename T> AlignedArray<T> allocate_aligned_array(std::size_t size, bool use_huge_pages)
+{
+    AlignedArray<T> array{static_cast<T *>(allocate_aligned(size * sizeof(T), use_huge_pages))};
+    std::uninitialized_default_construct_n(array.get(), size);
+
+    return array;
+}
@@ -1,21 +1,13 @@
 #include "move.hpp"
 
-Move::Move(SquareUnderlying from, SquareUnderlying to) : from{from}, to{to}
-{
-}
-
-SquareUnderlying Move::get_from() const
-{
-    return from;
-}
-
-SquareUnderlying Move::get_to() const
-{
-    return to;
-}
-
 std::ostream &operator<<(std::ostream &os, Move move)
 {
     os << Square{move.get_from()} << Square{move.get_to()};
+    if (move.is_promotion())
+    {
+        static constexpr std::array<char, 4> PROMOTION_CHARACTERS{'n', 'b', 'r', 'q'};
+        os << PROMOTION_CHARACTERS.at(move.get_promotion_piece() - Piece::Knight);
+    }
+
     return os;
 }
@@ -2,17 +2,94 @@
 
 #include "types.hpp"
 
+using MoveUnderlying = std::uint16_t;
+
+enum MoveFlag : std::uint8_t
+{
+    Normal,
+    DoublePush,
+    EnPassant,
+    Castle,
+
+    /* Promotions are kept in the same order as Piece so the promoted piece can be calculated */
+    KnightPromotion,
+    BishopPromotion,
+    RookPromotion,
+    QueenPromotion,
+};
+
+/*
+Packed into 16 bits (6 for each square, 4 for the flag) to keep move lists and undo records small
+*/
 class Move
 {
   public:
-    Move(SquareUnderlying from, SquareUnderlying to);
+    Move() = default;
+    Move(SquareUnderlying from, SquareUnderlying to, MoveFlag flag = MoveFlag::Normal);
+    explicit Move(MoveUnderlying data);
 
     SquareUnderlying get_from() const;
     SquareUnderlying get_to() const;
+    MoveFlag get_flag() const;
+
+    bool is_promotion() const;
+    Piece get_promotion_piece() const;
+
+    /*
+    For packing moves into hash table entries
+    */
+    MoveUnderlying get_underlying() const;
+
+    bool operator==(const Move &other) const = default;
 
   private:
-    SquareUnderlying from;
-    SquareUnderlying to;
+    static constexpr MoveUnderlying SQUARE_MASK{0x3F};
+    static constexpr auto TO_SHIFT{6};
+    static constexpr auto FLAG_SHIFT{12};
+
+    MoveUnderlying data;
 };
 
 std::ostream &operator<<(std::ostream &os, Move move);
+
+/*
+Defined here rather than in move.cpp so that move generation can inline them
+*/
+inline Move::Move(SquareUnderlying from, SquareUnderlying to, MoveFlag flag)
+    : data{static_cast<MoveUnderlying>(from | (to << TO_SHIFT) | (flag << FLAG_SHIFT))}
+{
+}
+
+inline Move::Move(MoveUnderlying data) : data{data}
+{
+}
+
+inline SquareUnderlying Move::get_from() const
+{
+    return data & SQUARE_MASK;
+}
+
+inline SquareUnderlying Move::get_to() const
+{
+    return (data >> TO_SHIFT) & SQUARE_MASK;
+}
+
+inline MoveFlag Move::get_flag() const
+{
+    return MoveFlag(data >> FLAG_SHIFT);
+}
+
+inline bool Move::is_promotion() const
+{
+    return get_flag() >= MoveFlag::KnightPromotion;
+}
+
+inline Piece Move::get_promotion_piece() const
+{
+    return Piece(get_flag() - MoveFlag::KnightPromotion + Piece::Knight);
+}
+
+inline MoveUnderlying Move::get_underlying() const
+{
+    return data;
+}
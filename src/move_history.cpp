@@ -0,0 +1,28 @@
+#include "move_history.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+MoveHistory::MoveHistory() : history_scores{}, countermoves{}
+{
+}
+
+void MoveHistory::clear()
+{
+    history_scores = {};
+    countermoves = {};
+}
+
+void MoveHistory::update_history_score(Player player, Move move, int bonus)
+{
+    auto &history_score{history_scores[player][move.get_from()][move.get_to()]};
+    const auto clamped_bonus{std::clamp<int>(bonus, -MAX_HISTORY_SCORE, MAX_HISTORY_SCORE)};
+    history_score =
+        static_cast<std::int16_t>(history_score + clamped_bonus - history_score * std::abs(clamped_bonus) /
+                                                                      MAX_HISTORY_SCORE);
+}
+
+void MoveHistory::set_countermove(Move previous_move, Move move)
+{
+    countermoves[previous_move.get_from()][previous_move.get_to()] = move;
+}
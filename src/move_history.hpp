@@ -0,0 +1,52 @@
+#pragma once
+
+#include "move.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <cstdint>
+
+/*
+What the search has learned about quiet moves from earlier cutoffs, independent of where in the tree they happened.
+The butterfly history scores every from and to square pair by how often it has cut off, and the countermoves are
+whichever move last cut off straight after each previous move.
+*/
+class MoveHistory
+{
+  public:
+    /*
+    Scores stay within this either side of zero
+    */
+    static constexpr std::int16_t MAX_HISTORY_SCORE{16384};
+
+    MoveHistory();
+
+    void clear();
+
+    std::int16_t get_history_score(Player player, Move move) const;
+
+    /*
+    Gravity: the further a score already is in the direction of the bonus, the less it moves, so a move that was good
+    a long time ago is overtaken quickly by one that's good now
+    */
+    void update_history_score(Player player, Move move, int bonus);
+
+    Move get_countermove(Move previous_move) const;
+    void set_countermove(Move previous_move, Move move);
+
+  private:
+    static constexpr auto NUM_PLAYERS{2};
+
+    std::array<Lookup<Lookup<std::int16_t>>, NUM_PLAYERS> history_scores;
+    Lookup<Lookup<Move>> countermoves;
+};
+
+inline std::int16_t MoveHistory::get_history_score(Player player, Move move) const
+{
+    return history_scores[player][move.get_from()][move.get_to()];
+}
+
+inline Move MoveHistory::get_countermove(Move previous_move) const
+{
+    return countermoves[previous_move.get_from()][previous_move.get_to()];
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "move.hpp"
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <utility>
+
+/*
+Anything moves can be generated into, so the add_*_moves functions never need to know about storage
+*/
+template <typename T>
+concept MoveSink = requires(T &sink, Move move) { sink.push_back(move); };
+
+/*
+Fixed capacity list living entirely on the stack, large enough for the most legal moves any position can have
+*/
+class MoveList
+{
+  public:
+    static constexpr std::size_t MAX_MOVES{218};
+
+    MoveList();
+
+    void push_back(Move move);
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    Move &operator[](std::size_t idx);
+    const Move &operator[](std::size_t idx) const;
+
+    Move *begin();
+    Move *end();
+    const Move *begin() const;
+    const Move *end() const;
+
+  private:
+    std::array<Move, MAX_MOVES> moves;
+    std::size_t num_moves;
+};
+
+/*
+Only counts moves. Move generation recognises it and popcounts target bit boards instead of serialising them.
+*/
+class MoveCounter
+{
+  public:
+    MoveCounter();
+
+    void push_back(Move move);
+    void add(std::size_t num_moves);
+
+    std::size_t size() const;
+
+  private:
+    std::size_t num_moves;
+};
+
+/*
+Wraps a callable so moves can be consumed as they are generated without being stored at all
+*/
+template <typename F> class MoveVisitor
+{
+  public:
+    MoveVisitor(F visit_function);
+
+    void push_back(Move move);
+
+  private:
+    F visit_function;
+};
+
+inline MoveList::MoveList() : num_moves{0}
+{
+}
+
+inline void MoveList::push_back(Move move)
+{
+    moves[num_moves] = move;
+    ++num_moves;
+}
+
+inline void MoveList::clear()
+{
+    num_moves = 0;
+}
+
+inline std::size_t MoveList::size() const
+{
+    return num_moves;
+}
+
+inline bool MoveList::empty() const
+{
+    return num_moves == 0;
+}
+
+inline Move &MoveList::operator[](std::size_t idx)
+{
+    return moves[idx];
+}
+
+inline const Move &MoveList::operator[](std::size_t idx) const
+{
+    return moves[idx];
+}
+
+inline Move *MoveList::begin()
+{
+    return moves.data();
+}
+
+inline Move *MoveList::end()
+{
+    return moves.data() + num_moves;
+}
+
+inline const Move *MoveList::begin() const
+{
+    return moves.data();
+}
+
+inline const Move *MoveList::end() const
+{
+    return moves.data() + num_moves;
+}
+
+inline MoveCounter::MoveCounter() : num_moves{0}
+{
+}
+
+inline void MoveCounter::push_back(Move)
+{
+    ++num_moves;
+}
+
+inline void MoveCounter::add(std::size_t num_added_moves)
+{
+    num_moves += num_added_moves;
+}
+
+inline std::size_t MoveCounter::size() const
+{
+    return num_moves;
+}
+
+template <typename F> MoveVisitor<F>::MoveVisitor(F visit_function) : visit_function{std::move(visit_function)}
+{
+}
+
+template <typename F> inline void MoveVisitor<F>::push_back(Move move)
+{
+    visit_function(move);
+}
@@ -0,0 +1,188 @@
+#include "move_picker.hpp"
+
+#include <utility>
+
+MovePicker::MovePicker(const Position &position, const CheckInfo &check_info, const MoveHistory &move_history,
+                       std::optional<Move> hash_move, const KillerMoves &killer_moves, Move countermove)
+    : position{position}, check_info{check_info}, move_history{move_history}, hash_move{hash_move},
+      killer_moves{killer_moves}, killer_moves_picked{}, countermove{countermove}, noisy_only{false},
+      stage{Stage::HashMove}, killer_idx{0}, moves{}, scores{}, move_idx{0}
+{
+}
+
+MovePicker::MovePicker(const Position &position, const CheckInfo &check_info, const MoveHistory &move_history)
+    : position{position}, check_info{check_info}, move_history{move_history}, hash_move{std::nullopt},
+      killer_moves{}, killer_moves_picked{}, countermove{std::nullopt}, noisy_only{!check_info.checkers_bit_board},
+      stage{Stage::GenerateNoisy}, killer_idx{0}, moves{}, scores{}, move_idx{0}
+{
+}
+
+std::optional<Move> MovePicker::next()
+{
+    switch (stage)
+    {
+    case Stage::HashMove:
+        stage = Stage::GenerateNoisy;
+        if (hash_move.has_value() && position.is_legal(*hash_move, check_info))
+        {
+            return hash_move;
+        }
+
+        hash_move = std::nullopt;
+        [[fallthrough]];
+    case Stage::GenerateNoisy:
+        position.get_moves<MoveGeneration::NoisyMoves>(moves, check_info);
+        score_noisy_moves();
+        stage = Stage::Noisy;
+        [[fallthrough]];
+    case Stage::Noisy:
+        while (move_idx < moves.size())
+        {
+            const auto move{pick_best_move()};
+            if (move != hash_move)
+            {
+                return move;
+            }
+        }
+
+        if (noisy_only)
+        {
+            stage = Stage::Done;
+            break;
+        }
+
+        stage = Stage::Killers;
+        [[fallthrough]];
+    case Stage::Killers:
+        /*
+        Killers are quiet by definition, a capture in the slot has already been picked as a noisy move
+        */
+        while (killer_idx < NUM_KILLER_MOVES)
+        {
+            const auto killer_move{killer_moves[killer_idx]};
+            const auto is_duplicate{killer_move == hash_move ||
+                                    (killer_idx && killer_move == killer_moves[killer_idx - 1])};
+            if (!is_duplicate && is_quiet_and_legal(killer_move))
+            {
+                killer_moves_picked[killer_idx] = true;
+                ++killer_idx;
+                return killer_move;
+            }
+
+            ++killer_idx;
+        }
+
+        stage = Stage::Countermove;
+        [[fallthrough]];
+    case Stage::Countermove:
+        stage = Stage::GenerateQuiets;
+        if (countermove.has_value() && !was_picked_early(*countermove) && is_quiet_and_legal(*countermove))
+        {
+            return countermove;
+        }
+
+        countermove = std::nullopt;
+        [[fallthrough]];
+    case Stage::GenerateQuiets:
+        moves.clear();
+        move_idx = 0;
+        position.get_moves<MoveGeneration::QuietMoves>(moves, check_info);
+        score_quiet_moves();
+        stage = Stage::Quiets;
+        [[fallthrough]];
+    case Stage::Quiets:
+        while (move_idx < moves.size())
+        {
+            const auto move{pick_best_move()};
+            if (!was_picked_early(move) && move != countermove)
+            {
+                return move;
+            }
+        }
+
+        stage = Stage::Done;
+        [[fallthrough]];
+    case Stage::Done:
+        break;
+    }
+
+    return std::nullopt;
+}
+
+void MovePicker::score_noisy_moves()
+{
+    /*
+    Promoting counts as capturing the new piece
+    */
+    using PieceValues = BitBoards<Player::White>;
+    for (std::size_t idx{0}; idx < moves.size(); ++idx)
+    {
+        const auto move{moves[idx]};
+        const auto captured_piece{position.get_captured_piece(move)};
+
+        Evaluation victim_value{0};
+        if (captured_piece.has_value())
+        {
+            victim_value += PieceValues::get_piece_value(*captured_piece);
+        }
+        if (move.is_promotion())
+        {
+            victim_value += PieceValues::get_piece_value(move.get_promotion_piece());
+        }
+        const auto attacker_value{PieceValues::get_piece_value(position.get_moved_piece(move))};
+        scores[idx] = static_cast<std::int16_t>(VICTIM_WEIGHT * victim_value - attacker_value);
+    }
+}
+
+void MovePicker::score_quiet_moves()
+{
+    const auto player{position.get_current_player()};
+    for (std::size_t idx{0}; idx < moves.size(); ++idx)
+    {
+        scores[idx] = move_history.get_history_score(player, moves[idx]);
+    }
+}
+
+Move MovePicker::pick_best_move()
+{
+    /*
+    One step of a selection sort, since most nodes cut off long before every move has been picked
+    */
+    auto best_idx{move_idx};
+    for (auto idx{move_idx + 1}; idx < moves.size(); ++idx)
+    {
+        if (scores[idx] > scores[best_idx])
+        {
+            best_idx = idx;
+        }
+    }
+
+    std::swap(moves[move_idx], moves[best_idx]);
+    std::swap(scores[move_idx], scores[best_idx]);
+
+    return moves[move_idx++];
+}
+
+bool MovePicker::is_quiet_and_legal(Move move) const
+{
+    return !move.is_promotion() && !position.get_captured_piece(move).has_value() &&
+           position.is_legal(move, check_info);
+}
+
+bool MovePicker::was_picked_early(Move move) const
+{
+    if (move == hash_move)
+    {
+        return true;
+    }
+
+    for (std::size_t idx{0}; idx < NUM_KILLER_MOVES; ++idx)
+    {
+        if (killer_moves_picked[idx] && move == killer_moves[idx])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
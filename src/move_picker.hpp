@@ -0,0 +1,89 @@
+#pragma once
+
+#include "bit_board.hpp"
+#include "move.hpp"
+#include "move_history.hpp"
+#include "move_list.hpp"
+#include "position.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/*
+Hands the search legal moves one at a time, most promising first. Each stage is only generated once everything before
+it has failed to cut off, so a node that cuts off on the hash move generates nothing at all and one that cuts off on a
+capture never serialises its quiet moves.
+*/
+class MovePicker
+{
+  public:
+    static constexpr std::size_t NUM_KILLER_MOVES{2};
+    using KillerMoves = std::array<Move, NUM_KILLER_MOVES>;
+
+    /*
+    The hash move, killer moves and countermove can come from other positions, so they're checked for legality before
+    being picked. Noisy moves are picked most valuable victim then least valuable attacker first, and the remaining
+    quiet moves by their history score.
+    */
+    MovePicker(const Position &position, const CheckInfo &check_info, const MoveHistory &move_history,
+               std::optional<Move> hash_move, const KillerMoves &killer_moves, Move countermove);
+
+    /*
+    For quiescence search, which only wants noisy moves unless it has to get out of check
+    */
+    MovePicker(const Position &position, const CheckInfo &check_info, const MoveHistory &move_history);
+
+    /*
+    Empty once every legal move has been picked
+    */
+    std::optional<Move> next();
+
+  private:
+    enum Stage : std::uint8_t
+    {
+        HashMove,
+        GenerateNoisy,
+        Noisy,
+        Killers,
+        Countermove,
+        GenerateQuiets,
+        Quiets,
+        Done,
+    };
+
+    /*
+    Every victim outweighs every attacker, so attackers only break ties between captures of equally valuable pieces
+    */
+    static constexpr std::int16_t VICTIM_WEIGHT{128};
+
+    void score_noisy_moves();
+    void score_quiet_moves();
+    Move pick_best_move();
+
+    /*
+    Killers and countermoves are only picked early if they're quiet and legal here
+    */
+    bool is_quiet_and_legal(Move move) const;
+
+    /*
+    Moves picked in an earlier stage, which get generated again by the later ones
+    */
+    bool was_picked_early(Move move) const;
+
+    const Position &position;
+    const CheckInfo &check_info;
+    const MoveHistory &move_history;
+    std::optional<Move> hash_move;
+    KillerMoves killer_moves;
+    std::array<bool, NUM_KILLER_MOVES> killer_moves_picked;
+    std::optional<Move> countermove;
+    bool noisy_only;
+
+    Stage stage;
+    std::size_t killer_idx;
+    MoveList moves;
+    std::array<std::int16_t, MoveList::MAX_MOVES> scores;
+    std::size_t move_idx;
+};
@@ -0,0 +1,81 @@
+#include "newline_scan.hpp"
+
+#include <stdexcept>
+
+#ifdef NEWLINE_SCAN_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+NewlineScanBackend NewlineScan::backend{NewlineScan::is_backend_supported(NewlineScanBackend::Avx2Scan)
+                                            ? NewlineScanBackend::Avx2Scan
+                                            : NewlineScanBackend::ScalarScan};
+
+void NewlineScan::set_backend(NewlineScanBackend new_backend)
+{
+    if (!is_backend_supported(new_backend))
+    {
+        throw std::logic_error{"Newline scan backend isn't supported by this CPU"};
+    }
+
+    backend = new_backend;
+}
+
+bool NewlineScan::is_backend_supported(NewlineScanBackend backend_to_check)
+{
+    switch (backend_to_check)
+    {
+    case NewlineScanBackend::ScalarScan:
+        return true;
+    case NewlineScanBackend::Avx2Scan:
+#ifdef NEWLINE_SCAN_HAS_AVX2
+        /*
+        Needed because this also runs during static initialisation, possibly before libgcc has detected the CPU
+        */
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+std::uint64_t NewlineScan::get_scalar_newline_mask(const char *block)
+{
+    std::uint64_t newline_mask{0};
+    for (std::size_t idx{0}; idx < BLOCK_BYTES; ++idx)
+    {
+        newline_mask |= static_cast<std::uint64_t>(block[idx] == '\n') << idx;
+    }
+
+    return newline_mask;
+}
+
+#ifdef NEWLINE_SCAN_HAS_AVX2
+[[gnu::target("avx2")]] std::uint64_t NewlineScan::get_avx2_newline_mask(const char *block)
+{
+    const auto newlines{_mm256_set1_epi8('\n')};
+    const auto low_block{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block))};
+    const auto high_block{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + sizeof(__m256i)))};
+    const auto low_mask{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low_block, newlines)))};
+    const auto high_mask{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high_block, newlines)))};
+
+    return static_cast<std::uint64_t>(high_mask) << 32 | low_mask;
+}
+#endif
+
+std::ostream &operator<<(std::ostream &os, NewlineScanBackend backend)
+{
+    switch (backend)
+    {
+    case NewlineScanBackend::ScalarScan:
+        os << "scalar";
+        break;
+    case NewlineScanBackend::Avx2Scan:
+        os << "avx2";
+        break;
+    }
+
+    return os;
+}
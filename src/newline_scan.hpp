@@ -0,0 +1,129 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEWLINE_SCAN_HAS_AVX2
+#endif
+
+enum NewlineScanBackend : std::uint8_t
+{
+    ScalarScan,
+    Avx2Scan,
+};
+
+std::ostream &operator<<(std::ostream &os, NewlineScanBackend backend);
+
+/*
+Splits text into lines by finding every newline in a block of 64 bytes at once, as a mask with a bit set for each one.
+The AVX2 backend compares 32 bytes per instruction, so a line of a position file costs a handful of instructions rather
+than a compare per character.
+*/
+class NewlineScan
+{
+  public:
+    static constexpr std::size_t BLOCK_BYTES{64};
+
+    /*
+    Calls back with every line in order, without its newline or a carriage return before it. The last line doesn't
+    need a newline after it.
+    */
+    template <typename F> static void for_each_line(std::string_view text, F &&callback);
+
+    /*
+    Bit i is set when block[i] is a newline
+    */
+    static std::uint64_t get_newline_mask(const char *block);
+
+    static NewlineScanBackend get_backend();
+
+    /*
+    Not safe to call while other threads are scanning. Throws if the CPU can't run the backend.
+    */
+    static void set_backend(NewlineScanBackend new_backend);
+
+    static bool is_backend_supported(NewlineScanBackend backend_to_check);
+
+  private:
+    template <typename F> static void call_back_with_line(const char *line_begin, const char *line_end, F &callback);
+
+    static std::uint64_t get_scalar_newline_mask(const char *block);
+#ifdef NEWLINE_SCAN_HAS_AVX2
+    [[gnu::target("avx2")]] static std::uint64_t get_avx2_newline_mask(const char *block);
+#endif
+
+    static NewlineScanBackend backend;
+};
+
+template <typename F> void NewlineScan::for_each_line(std::string_view text, F &&callback)
+{
+    /*
+    An empty file's contents have no data pointer, which memchr mustn't be given even to search nothing
+    */
+    if (text.empty())
+    {
+        return;
+    }
+
+    const auto *line_begin{text.data()};
+    const auto *const text_end{text.data() + text.size()};
+
+    const auto *block{text.data()};
+    for (; block + BLOCK_BYTES <= text_end; block += BLOCK_BYTES)
+    {
+        for (auto newline_mask{get_newline_mask(block)}; newline_mask; newline_mask &= newline_mask - 1)
+        {
+            const auto *line_end{block + std::countr_zero(newline_mask)};
+            call_back_with_line(line_begin, line_end, callback);
+            line_begin = line_end + 1;
+        }
+    }
+
+    /*
+    Less than a block left
+    */
+    while (const auto *line_end{
+        static_cast<const char *>(std::memchr(block, '\n', static_cast<std::size_t>(text_end - block)))})
+    {
+        call_back_with_line(line_begin, line_end, callback);
+        line_begin = line_end + 1;
+        block = line_begin;
+    }
+
+    if (line_begin != text_end)
+    {
+        call_back_with_line(line_begin, text_end, callback);
+    }
+}
+
+template <typename F> void NewlineScan::call_back_with_line(const char *line_begin, const char *line_end, F &callback)
+{
+    if (line_end != line_begin && line_end[-1] == '\r')
+    {
+        --line_end;
+    }
+
+    callback(std::string_view{line_begin, static_cast<std::size_t>(line_end - line_begin)});
+}
+
+inline std::uint64_t NewlineScan::get_newline_mask(const char *block)
+{
+#ifdef NEWLINE_SCAN_HAS_AVX2
+    if (backend == NewlineScanBackend::Avx2Scan)
+    {
+        return get_avx2_newline_mask(block);
+    }
+#endif
+
+    return get_scalar_newline_mask(block);
+}
+
+inline NewlineScanBackend NewlineScan::get_backend()
+{
+    return backend;
+}
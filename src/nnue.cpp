@@ -0,0 +1,443 @@
+#include "nnue.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef NNUE_HAS_SIMD
+#include <immintrin.h>
+#endif
+
+namespace
+{
+template <bool adds, bool removes>
+void update_scalar_values(std::int16_t *values, const std::int16_t *added_weights,
+                          const std::int16_t *removed_weights)
+{
+    /*
+    Wraps around on overflow just like the vector instructions, so removing a feature always undoes adding it
+    */
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; ++idx)
+    {
+        if constexpr (adds)
+        {
+            values[idx] = static_cast<std::int16_t>(values[idx] + added_weights[idx]);
+        }
+        if constexpr (removes)
+        {
+            values[idx] = static_cast<std::int16_t>(values[idx] - removed_weights[idx]);
+        }
+    }
+}
+
+void transform_scalar_values(const std::int16_t *values, std::uint8_t *output)
+{
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; ++idx)
+    {
+        const auto value{std::clamp<std::int16_t>(values[idx], 0, std::numeric_limits<std::int8_t>::max())};
+        output[idx] = static_cast<std::uint8_t>(value);
+    }
+}
+
+std::int32_t get_scalar_dot_product(const std::uint8_t *input, const std::int8_t *weights, std::size_t size)
+{
+    std::int32_t dot_product{0};
+    for (std::size_t idx{0}; idx < size; ++idx)
+    {
+        dot_product += input[idx] * weights[idx];
+    }
+
+    return dot_product;
+}
+
+#ifdef NNUE_HAS_SIMD
+template <bool adds, bool removes>
+[[gnu::target("ssse3")]] void update_sse_values(std::int16_t *values, const std::int16_t *added_weights,
+                                                const std::int16_t *removed_weights)
+{
+    static constexpr std::size_t LANES{sizeof(__m128i) / sizeof(std::int16_t)};
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; idx += LANES)
+    {
+        auto *values_vector{reinterpret_cast<__m128i *>(values + idx)};
+        auto updated{_mm_load_si128(values_vector)};
+        if constexpr (adds)
+        {
+            updated = _mm_add_epi16(updated, _mm_loadu_si128(reinterpret_cast<const __m128i *>(added_weights + idx)));
+        }
+        if constexpr (removes)
+        {
+            updated =
+                _mm_sub_epi16(updated, _mm_loadu_si128(reinterpret_cast<const __m128i *>(removed_weights + idx)));
+        }
+        _mm_store_si128(values_vector, updated);
+    }
+}
+
+[[gnu::target("ssse3")]] void transform_sse_values(const std::int16_t *values, std::uint8_t *output)
+{
+    /*
+    Negatives go to zero first, then packing saturates everything above 127
+    */
+    static constexpr std::size_t LANES{sizeof(__m128i) / sizeof(std::int16_t)};
+    const auto zero{_mm_setzero_si128()};
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; idx += 2 * LANES)
+    {
+        const auto low{_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i *>(values + idx)), zero)};
+        const auto high{_mm_max_epi16(_mm_load_si128(reinterpret_cast<const __m128i *>(values + idx + LANES)), zero)};
+        _mm_store_si128(reinterpret_cast<__m128i *>(output + idx), _mm_packs_epi16(low, high));
+    }
+}
+
+[[gnu::target("ssse3")]] std::int32_t get_sse_dot_product(const std::uint8_t *input, const std::int8_t *weights,
+                                                          std::size_t size)
+{
+    /*
+    Inputs are at most 127, so adjacent products can be summed in 16 bits without saturating
+    */
+    const auto ones{_mm_set1_epi16(1)};
+    auto dot_product{_mm_setzero_si128()};
+    for (std::size_t idx{0}; idx < size; idx += sizeof(__m128i))
+    {
+        const auto products{_mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(input + idx)),
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + idx)))};
+        dot_product = _mm_add_epi32(dot_product, _mm_madd_epi16(products, ones));
+    }
+
+    dot_product = _mm_add_epi32(dot_product, _mm_shuffle_epi32(dot_product, 0x4E));
+    dot_product = _mm_add_epi32(dot_product, _mm_shuffle_epi32(dot_product, 0xB1));
+
+    return _mm_cvtsi128_si32(dot_product);
+}
+
+template <bool adds, bool removes>
+[[gnu::target("avx2")]] void update_avx2_values(std::int16_t *values, const std::int16_t *added_weights,
+                                                const std::int16_t *removed_weights)
+{
+    static constexpr std::size_t LANES{sizeof(__m256i) / sizeof(std::int16_t)};
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; idx += LANES)
+    {
+        auto *values_vector{reinterpret_cast<__m256i *>(values + idx)};
+        auto updated{_mm256_load_si256(values_vector)};
+        if constexpr (adds)
+        {
+            updated = _mm256_add_epi16(updated,
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(added_weights + idx)));
+        }
+        if constexpr (removes)
+        {
+            updated = _mm256_sub_epi16(updated,
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i *>(removed_weights + idx)));
+        }
+        _mm256_store_si256(values_vector, updated);
+    }
+}
+
+[[gnu::target("avx2")]] void transform_avx2_values(const std::int16_t *values, std::uint8_t *output)
+{
+    /*
+    Packing works within each 128 bit half, so the 64 bit quarters need putting back in order afterwards
+    */
+    static constexpr std::size_t LANES{sizeof(__m256i) / sizeof(std::int16_t)};
+    const auto zero{_mm256_setzero_si256()};
+    for (std::size_t idx{0}; idx < Nnue::ACCUMULATOR_SIZE; idx += 2 * LANES)
+    {
+        const auto low{_mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i *>(values + idx)), zero)};
+        const auto high{
+            _mm256_max_epi16(_mm256_load_si256(reinterpret_cast<const __m256i *>(values + idx + LANES)), zero)};
+        const auto packed{_mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), 0xD8)};
+        _mm256_store_si256(reinterpret_cast<__m256i *>(output + idx), packed);
+    }
+}
+
+[[gnu::target("avx2")]] std::int32_t get_avx2_dot_product(const std::uint8_t *input, const std::int8_t *weights,
+                                                          std::size_t size)
+{
+    const auto ones{_mm256_set1_epi16(1)};
+    auto dot_product{_mm256_setzero_si256()};
+    for (std::size_t idx{0}; idx < size; idx += sizeof(__m256i))
+    {
+        const auto products{
+            _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + idx)),
+                                 _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + idx)))};
+        dot_product = _mm256_add_epi32(dot_product, _mm256_madd_epi16(products, ones));
+    }
+
+    auto sum{_mm_add_epi32(_mm256_castsi256_si128(dot_product), _mm256_extracti128_si256(dot_product, 1))};
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+template <NnueBackend backend>
+std::int32_t get_dot_product(const std::uint8_t *input, const std::int8_t *weights, std::size_t size)
+{
+#ifdef NNUE_HAS_SIMD
+    if constexpr (backend == NnueBackend::Avx2Nnue)
+    {
+        return get_avx2_dot_product(input, weights, size);
+    }
+    else if constexpr (backend == NnueBackend::SseNnue)
+    {
+        return get_sse_dot_product(input, weights, size);
+    }
+#endif
+
+    return get_scalar_dot_product(input, weights, size);
+}
+
+template <NnueBackend backend> void transform_values(const std::int16_t *values, std::uint8_t *output)
+{
+#ifdef NNUE_HAS_SIMD
+    if constexpr (backend == NnueBackend::Avx2Nnue)
+    {
+        transform_avx2_values(values, output);
+        return;
+    }
+    else if constexpr (backend == NnueBackend::SseNnue)
+    {
+        transform_sse_values(values, output);
+        return;
+    }
+#endif
+
+    transform_scalar_values(values, output);
+}
+} // namespace
+
+NnueBackend Nnue::backend{
+    Nnue::is_backend_supported(NnueBackend::Avx2Nnue)
+        ? NnueBackend::Avx2Nnue
+        : (Nnue::is_backend_supported(NnueBackend::SseNnue) ? NnueBackend::SseNnue : NnueBackend::ScalarNnue)};
+
+Nnue::Nnue(const std::string &path)
+    : mapping{nullptr}, feature_weights{nullptr}, feature_biases{nullptr}, first_hidden_weights{nullptr},
+      first_hidden_biases{nullptr}, second_hidden_weights{nullptr}, second_hidden_biases{nullptr},
+      output_weights{nullptr}, output_bias{nullptr}
+{
+    const auto file_descriptor{open(path.c_str(), O_RDONLY)};
+    if (file_descriptor < 0)
+    {
+        throw std::logic_error{"Couldn't open network file"};
+    }
+
+    struct stat file_stat
+    {
+    };
+    if (fstat(file_descriptor, &file_stat) || static_cast<std::size_t>(file_stat.st_size) != FILE_BYTES)
+    {
+        close(file_descriptor);
+        throw std::logic_error{"Network file is the wrong size for this architecture"};
+    }
+
+    /*
+    The mapping stays valid once the file is closed
+    */
+    mapping = mmap(nullptr, FILE_BYTES, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::logic_error{"Couldn't map network file"};
+    }
+
+    const auto *bytes{static_cast<const std::uint8_t *>(mapping)};
+    if (!std::equal(MAGIC.begin(), MAGIC.end(), bytes))
+    {
+        munmap(mapping, FILE_BYTES);
+        throw std::logic_error{"Network file doesn't start with the expected magic"};
+    }
+
+    /*
+    Every section but the last two is a whole number of cache lines, so they're all aligned for vector loads
+    */
+    bytes += HEADER_BYTES;
+    feature_weights = reinterpret_cast<const std::int16_t *>(bytes);
+    bytes += sizeof(std::int16_t) * NUM_FEATURES * ACCUMULATOR_SIZE;
+    feature_biases = reinterpret_cast<const std::int16_t *>(bytes);
+    bytes += sizeof(std::int16_t) * ACCUMULATOR_SIZE;
+    first_hidden_weights = reinterpret_cast<const std::int8_t *>(bytes);
+    bytes += sizeof(std::int8_t) * NUM_PERSPECTIVES * ACCUMULATOR_SIZE * HIDDEN_SIZE;
+    first_hidden_biases = reinterpret_cast<const std::int32_t *>(bytes);
+    bytes += sizeof(std::int32_t) * HIDDEN_SIZE;
+    second_hidden_weights = reinterpret_cast<const std::int8_t *>(bytes);
+    bytes += sizeof(std::int8_t) * HIDDEN_SIZE * HIDDEN_SIZE;
+    second_hidden_biases = reinterpret_cast<const std::int32_t *>(bytes);
+    bytes += sizeof(std::int32_t) * HIDDEN_SIZE;
+    output_weights = reinterpret_cast<const std::int8_t *>(bytes);
+    bytes += sizeof(std::int8_t) * HIDDEN_SIZE;
+    output_bias = reinterpret_cast<const std::int32_t *>(bytes);
+}
+
+Nnue::~Nnue()
+{
+    munmap(mapping, FILE_BYTES);
+}
+
+void Nnue::reset_features(AccumulatorValues &values) const
+{
+    std::copy_n(feature_biases, ACCUMULATOR_SIZE, values.begin());
+}
+
+void Nnue::add_feature(AccumulatorValues &values, std::size_t feature_idx) const
+{
+    update_values<true, false>(values, feature_idx, 0);
+}
+
+void Nnue::remove_feature(AccumulatorValues &values, std::size_t feature_idx) const
+{
+    update_values<false, true>(values, 0, feature_idx);
+}
+
+void Nnue::move_feature(AccumulatorValues &values, std::size_t from_feature_idx, std::size_t to_feature_idx) const
+{
+    update_values<true, true>(values, to_feature_idx, from_feature_idx);
+}
+
+Evaluation Nnue::evaluate(const Accumulator &accumulator, Player player) const
+{
+    switch (backend)
+    {
+    case NnueBackend::Avx2Nnue:
+        return evaluate<NnueBackend::Avx2Nnue>(accumulator, player);
+    case NnueBackend::SseNnue:
+        return evaluate<NnueBackend::SseNnue>(accumulator, player);
+    case NnueBackend::ScalarNnue:
+        break;
+    }
+
+    return evaluate<NnueBackend::ScalarNnue>(accumulator, player);
+}
+
+void Nnue::set_backend(NnueBackend new_backend)
+{
+    if (!is_backend_supported(new_backend))
+    {
+        throw std::logic_error{"NNUE backend isn't supported by this CPU"};
+    }
+
+    backend = new_backend;
+}
+
+bool Nnue::is_backend_supported(NnueBackend backend_to_check)
+{
+    switch (backend_to_check)
+    {
+    case NnueBackend::ScalarNnue:
+        return true;
+    case NnueBackend::SseNnue:
+#ifdef NNUE_HAS_SIMD
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("ssse3");
+#else
+        return false;
+#endif
+    case NnueBackend::Avx2Nnue:
+#ifdef NNUE_HAS_SIMD
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+template <NnueBackend backend, bool adds, bool removes>
+void Nnue::update_backend_values(AccumulatorValues &values, std::size_t added_feature_idx,
+                                 std::size_t removed_feature_idx) const
+{
+    const auto *added_weights{feature_weights + added_feature_idx * ACCUMULATOR_SIZE};
+    const auto *removed_weights{feature_weights + removed_feature_idx * ACCUMULATOR_SIZE};
+#ifdef NNUE_HAS_SIMD
+    if constexpr (backend == NnueBackend::Avx2Nnue)
+    {
+        update_avx2_values<adds, removes>(values.data(), added_weights, removed_weights);
+        return;
+    }
+    else if constexpr (backend == NnueBackend::SseNnue)
+    {
+        update_sse_values<adds, removes>(values.data(), added_weights, removed_weights);
+        return;
+    }
+#endif
+
+    update_scalar_values<adds, removes>(values.data(), added_weights, removed_weights);
+}
+
+template <bool adds, bool removes>
+void Nnue::update_values(AccumulatorValues &values, std::size_t added_feature_idx,
+                         std::size_t removed_feature_idx) const
+{
+    switch (backend)
+    {
+    case NnueBackend::Avx2Nnue:
+        update_backend_values<NnueBackend::Avx2Nnue, adds, removes>(values, added_feature_idx, removed_feature_idx);
+        return;
+    case NnueBackend::SseNnue:
+        update_backend_values<NnueBackend::SseNnue, adds, removes>(values, added_feature_idx, removed_feature_idx);
+        return;
+    case NnueBackend::ScalarNnue:
+        break;
+    }
+
+    update_backend_values<NnueBackend::ScalarNnue, adds, removes>(values, added_feature_idx, removed_feature_idx);
+}
+
+template <NnueBackend backend> Evaluation Nnue::evaluate(const Accumulator &accumulator, Player player) const
+{
+    /*
+    The player to move's half always comes first, so the network knows whose turn it is
+    */
+    alignas(CACHE_LINE_BYTES) std::array<std::uint8_t, NUM_PERSPECTIVES * ACCUMULATOR_SIZE> transformed;
+    transform_values<backend>(accumulator.perspectives[player].data(), transformed.data());
+    transform_values<backend>(accumulator.perspectives[opponent_of(player)].data(),
+                              transformed.data() + ACCUMULATOR_SIZE);
+
+    alignas(CACHE_LINE_BYTES) std::array<std::uint8_t, HIDDEN_SIZE> first_hidden;
+    propagate<backend, NUM_PERSPECTIVES * ACCUMULATOR_SIZE, HIDDEN_SIZE>(transformed.data(), first_hidden_weights,
+                                                                         first_hidden_biases, first_hidden.data());
+
+    alignas(CACHE_LINE_BYTES) std::array<std::uint8_t, HIDDEN_SIZE> second_hidden;
+    propagate<backend, HIDDEN_SIZE, HIDDEN_SIZE>(first_hidden.data(), second_hidden_weights, second_hidden_biases,
+                                                 second_hidden.data());
+
+    const auto output{*output_bias + get_dot_product<backend>(second_hidden.data(), output_weights, HIDDEN_SIZE)};
+
+    return static_cast<Evaluation>(std::clamp<std::int32_t>(output / OUTPUT_SCALE, -MAX_EVALUATION, MAX_EVALUATION));
+}
+
+template <NnueBackend backend, std::size_t INPUT_SIZE, std::size_t OUTPUT_SIZE>
+void Nnue::propagate(const std::uint8_t *input, const std::int8_t *weights, const std::int32_t *biases,
+                     std::uint8_t *output)
+{
+    for (std::size_t idx{0}; idx < OUTPUT_SIZE; ++idx)
+    {
+        const auto sum{biases[idx] + get_dot_product<backend>(input, weights + idx * INPUT_SIZE, INPUT_SIZE)};
+        output[idx] = static_cast<std::uint8_t>(std::clamp<std::int32_t>(sum >> WEIGHT_SHIFT, 0, MAX_ACTIVATION));
+    }
+}
+
+std::ostream &operator<<(std::ostream &os, NnueBackend backend)
+{
+    switch (backend)
+    {
+    case NnueBackend::ScalarNnue:
+        os << "scalar";
+        break;
+    case NnueBackend::SseNnue:
+        os << "sse";
+        break;
+    case NnueBackend::Avx2Nnue:
+        os << "avx2";
+        break;
+    }
+
+    return os;
+}
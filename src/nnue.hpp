@@ -0,0 +1,158 @@
+#pragma once
+
+#include "memory.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NNUE_HAS_SIMD
+#endif
+
+/*
+The SSE backend needs SSSE3 for its multiply-adds
+*/
+enum NnueBackend : std::uint8_t
+{
+    ScalarNnue,
+    SseNnue,
+    Avx2Nnue,
+};
+
+std::ostream &operator<<(std::ostream &os, NnueBackend backend);
+
+/*
+An efficiently updatable neural network evaluation. Its inputs are every piece except the kings, by colour, type and
+square, relative to where one of the kings is. Each king's half of the first layer is kept in an accumulator that only
+changes by a couple of weight rows per move, and the layers after it are small enough to run from scratch on every
+evaluation:
+
+    2 x 40960 -> 2 x 256 -> 32 -> 32 -> 1
+
+Weights are quantised, int16 for the first layer and int8 with int32 biases after it. They're read straight out of a
+memory mapped file, which is the magic padded to a cache line followed by the weights then biases of each layer in
+order, little endian.
+*/
+class Nnue
+{
+  public:
+    static constexpr std::size_t NUM_PERSPECTIVES{2};
+    static constexpr std::size_t NUM_FEATURE_PIECES{10};
+    static constexpr std::size_t NUM_FEATURES{BOARD_SQUARES * NUM_FEATURE_PIECES * BOARD_SQUARES};
+    static constexpr std::size_t ACCUMULATOR_SIZE{256};
+    static constexpr std::size_t HIDDEN_SIZE{32};
+
+    using AccumulatorValues = std::array<std::int16_t, ACCUMULATOR_SIZE>;
+
+    /*
+    The first layer's output from each player's point of view
+    */
+    struct Accumulator
+    {
+        alignas(CACHE_LINE_BYTES) std::array<AccumulatorValues, NUM_PERSPECTIVES> perspectives;
+    };
+
+    static constexpr std::array<char, 8> MAGIC{'G', 'G', 'P', 'N', 'N', 'U', 'E', '1'};
+    static constexpr std::size_t HEADER_BYTES{CACHE_LINE_BYTES};
+    static constexpr std::size_t FILE_BYTES{
+        HEADER_BYTES + sizeof(std::int16_t) * (NUM_FEATURES * ACCUMULATOR_SIZE + ACCUMULATOR_SIZE) +
+        sizeof(std::int8_t) * NUM_PERSPECTIVES * ACCUMULATOR_SIZE * HIDDEN_SIZE + sizeof(std::int32_t) * HIDDEN_SIZE +
+        sizeof(std::int8_t) * HIDDEN_SIZE * HIDDEN_SIZE + sizeof(std::int32_t) * HIDDEN_SIZE +
+        sizeof(std::int8_t) * HIDDEN_SIZE + sizeof(std::int32_t)};
+
+    /*
+    Throws if the file can't be mapped or isn't a network of this shape. The pages are shared with anything else that
+    maps the same file, so every thread and engine process reads the one copy.
+    */
+    explicit Nnue(const std::string &path);
+    ~Nnue();
+
+    Nnue(const Nnue &) = delete;
+    Nnue &operator=(const Nnue &) = delete;
+
+    /*
+    Squares are flipped for black, so both players see the board from their own side
+    */
+    static std::size_t get_feature_idx(Player perspective, SquareUnderlying king_square, Player player, Piece piece,
+                                       SquareUnderlying square);
+
+    /*
+    Starting from the biases, every feature has to be added to get the accumulator for a position
+    */
+    void reset_features(AccumulatorValues &values) const;
+    void add_feature(AccumulatorValues &values, std::size_t feature_idx) const;
+    void remove_feature(AccumulatorValues &values, std::size_t feature_idx) const;
+    void move_feature(AccumulatorValues &values, std::size_t from_feature_idx, std::size_t to_feature_idx) const;
+
+    /*
+    In centipawns from the point of view of the player to move
+    */
+    Evaluation evaluate(const Accumulator &accumulator, Player player) const;
+
+    static NnueBackend get_backend();
+
+    /*
+    Not safe to call while other threads are evaluating. Throws if the CPU can't run the backend.
+    */
+    static void set_backend(NnueBackend new_backend);
+
+    static bool is_backend_supported(NnueBackend backend_to_check);
+
+  private:
+    /*
+    Hidden layers sum in units of 1 / 2^6 and clamp to the int8 range, and the output is in units of 1 / 16 centipawns
+    */
+    static constexpr auto WEIGHT_SHIFT{6};
+    static constexpr std::int32_t MAX_ACTIVATION{127};
+    static constexpr std::int32_t OUTPUT_SCALE{16};
+
+    /*
+    Well clear of mate scores, however badly the network is trained
+    */
+    static constexpr Evaluation MAX_EVALUATION{10000};
+
+    template <NnueBackend backend, bool adds, bool removes>
+    void update_backend_values(AccumulatorValues &values, std::size_t added_feature_idx,
+                               std::size_t removed_feature_idx) const;
+    template <bool adds, bool removes>
+    void update_values(AccumulatorValues &values, std::size_t added_feature_idx,
+                       std::size_t removed_feature_idx) const;
+    template <NnueBackend backend> Evaluation evaluate(const Accumulator &accumulator, Player player) const;
+
+    /*
+    One dense layer followed by a clipped ReLU
+    */
+    template <NnueBackend backend, std::size_t INPUT_SIZE, std::size_t OUTPUT_SIZE>
+    static void propagate(const std::uint8_t *input, const std::int8_t *weights, const std::int32_t *biases,
+                          std::uint8_t *output);
+
+    void *mapping;
+    const std::int16_t *feature_weights;
+    const std::int16_t *feature_biases;
+    const std::int8_t *first_hidden_weights;
+    const std::int32_t *first_hidden_biases;
+    const std::int8_t *second_hidden_weights;
+    const std::int32_t *second_hidden_biases;
+    const std::int8_t *output_weights;
+    const std::int32_t *output_bias;
+
+    static NnueBackend backend;
+};
+
+inline std::size_t Nnue::get_feature_idx(Player perspective, SquareUnderlying king_square, Player player, Piece piece,
+                                         SquareUnderlying square)
+{
+    const auto flip{perspective == Player::White ? 0 : BOARD_SQUARES - BOARD_WIDTH};
+    const auto piece_idx{(player == perspective ? 0 : NUM_FEATURE_PIECES / 2) + piece};
+
+    return ((king_square ^ flip) * NUM_FEATURE_PIECES + piece_idx) * BOARD_SQUARES + (square ^ flip);
+}
+
+inline NnueBackend Nnue::get_backend()
+{
+    return backend;
+}
@@ -0,0 +1,186 @@
+#include "packed_position.hpp"
+
+#include "slider_attacks.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+#ifdef PACKED_POSITION_HAS_BMI2
+#include <immintrin.h>
+#endif
+
+/*
+PDEP is microcoded wherever PEXT is, so the slider attacks have already worked out whether it's worth using
+*/
+PackingBackend PackedPosition::backend{SliderAttacks::detect_fastest_backend() == SliderAttacksBackend::Pext
+                                           ? PackingBackend::Bmi2Packing
+                                           : PackingBackend::ScalarPacking};
+
+PackedPosition::PackedPosition(const PieceBitBoards &piece_bit_boards, Player current_player,
+                               CastlingRightsUnderlying castling_rights, std::optional<Square> en_passant_square,
+                               std::uint8_t halfmove_clock, std::uint16_t fullmove_counter)
+    : occupied_bit_board{0}, piece_codes{}, fullmove_counter{fullmove_counter}, halfmove_clock{halfmove_clock},
+      flags{static_cast<std::uint8_t>(current_player | castling_rights << 1)},
+      en_passant_square{en_passant_square.has_value() ? static_cast<std::uint8_t>(*en_passant_square)
+                                                      : NO_EN_PASSANT_SQUARE},
+      reserved{}
+{
+    for (const auto &player_piece_bit_boards : piece_bit_boards)
+    {
+        for (const auto piece_bit_board : player_piece_bit_boards)
+        {
+            occupied_bit_board |= piece_bit_board;
+        }
+    }
+
+    if (static_cast<std::size_t>(std::popcount(occupied_bit_board)) > MAX_PIECES)
+    {
+        throw std::logic_error{"Position has too many pieces to pack"};
+    }
+
+    /*
+    A piece's place in the occupied squares is how many of them come before it
+    */
+    for (std::uint8_t piece_code{0}; piece_code < NUM_PIECE_CODES; ++piece_code)
+    {
+        for (auto piece_bit_board{piece_bit_boards[piece_code / NUM_PIECES][piece_code % NUM_PIECES]}; piece_bit_board;
+             piece_bit_board &= piece_bit_board - 1)
+        {
+            const auto before_bit_board{occupied_bit_board & ((piece_bit_board & (~piece_bit_board + 1)) - 1)};
+            const auto piece_idx{static_cast<std::size_t>(std::popcount(before_bit_board))};
+            piece_codes[piece_idx / 2] |= static_cast<std::uint8_t>(piece_code << (piece_idx % 2 * PIECE_CODE_BITS));
+        }
+    }
+}
+
+bool PackedPosition::is_valid() const
+{
+    return is_valid(unpack_piece_bit_boards());
+}
+
+bool PackedPosition::is_valid(const PieceBitBoards &piece_bit_boards) const
+{
+    const auto en_passant_square{get_en_passant_square()};
+
+    return BoardValidity::is_valid_piece_placement(piece_bit_boards) &&
+           BoardValidity::is_valid_castling_rights(piece_bit_boards, get_castling_rights()) &&
+           (!en_passant_square.has_value() ||
+            BoardValidity::is_valid_en_passant_square(piece_bit_boards, get_current_player(), *en_passant_square));
+}
+
+Player PackedPosition::get_current_player() const
+{
+    return static_cast<Player>(flags & 1);
+}
+
+CastlingRightsUnderlying PackedPosition::get_castling_rights() const
+{
+    return static_cast<CastlingRightsUnderlying>((flags >> 1) & CastlingRights::AllCastling);
+}
+
+std::optional<Square> PackedPosition::get_en_passant_square() const
+{
+    if (en_passant_square >= NO_EN_PASSANT_SQUARE)
+    {
+        return std::nullopt;
+    }
+
+    return Square(en_passant_square);
+}
+
+std::uint8_t PackedPosition::get_halfmove_clock() const
+{
+    return halfmove_clock;
+}
+
+std::uint16_t PackedPosition::get_fullmove_counter() const
+{
+    return fullmove_counter;
+}
+
+void PackedPosition::set_backend(PackingBackend new_backend)
+{
+    if (!is_backend_supported(new_backend))
+    {
+        throw std::logic_error{"Packing backend isn't supported by this CPU"};
+    }
+
+    backend = new_backend;
+}
+
+bool PackedPosition::is_backend_supported(PackingBackend backend_to_check)
+{
+    switch (backend_to_check)
+    {
+    case PackingBackend::ScalarPacking:
+        return true;
+    case PackingBackend::Bmi2Packing:
+        return SliderAttacks::is_backend_supported(SliderAttacksBackend::Pext);
+    }
+
+    return false;
+}
+
+PackedPosition::PieceBitBoards PackedPosition::unpack_scalar_piece_bit_boards() const
+{
+    PieceBitBoards piece_bit_boards{};
+    auto remaining_bit_board{occupied_bit_board};
+    for (std::size_t piece_idx{0}; piece_idx < MAX_PIECES && remaining_bit_board;
+         ++piece_idx, remaining_bit_board &= remaining_bit_board - 1)
+    {
+        const auto piece_code{get_piece_code(piece_idx)};
+        if (piece_code < NUM_PIECE_CODES)
+        {
+            piece_bit_boards[piece_code / NUM_PIECES][piece_code % NUM_PIECES] |=
+                square_to_bit_board(Square(std::countr_zero(remaining_bit_board)));
+        }
+    }
+
+    return piece_bit_boards;
+}
+
+#ifdef PACKED_POSITION_HAS_BMI2
+[[gnu::target("bmi2")]] PackedPosition::PieceBitBoards PackedPosition::unpack_bmi2_piece_bit_boards() const
+{
+    /*
+    Split the nibbles into a byte each, back in the order of the occupied squares
+    */
+    const auto packed_codes{_mm_loadu_si128(reinterpret_cast<const __m128i *>(piece_codes.data()))};
+    const auto code_mask{_mm_set1_epi8(PIECE_CODE_MASK)};
+    const auto low_codes{_mm_and_si128(packed_codes, code_mask)};
+    const auto high_codes{_mm_and_si128(_mm_srli_epi16(packed_codes, PIECE_CODE_BITS), code_mask)};
+    const auto first_codes{_mm_unpacklo_epi8(low_codes, high_codes)};
+    const auto second_codes{_mm_unpackhi_epi8(low_codes, high_codes)};
+
+    /*
+    PDEP only uses as many bits of the mask as there are occupied squares, so the empty codes after the last piece
+    never land anywhere
+    */
+    PieceBitBoards piece_bit_boards{};
+    for (std::uint8_t piece_code{0}; piece_code < NUM_PIECE_CODES; ++piece_code)
+    {
+        const auto codes{_mm_set1_epi8(static_cast<char>(piece_code))};
+        const auto first_mask{static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(first_codes, codes)))};
+        const auto second_mask{static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(second_codes, codes)))};
+        piece_bit_boards[piece_code / NUM_PIECES][piece_code % NUM_PIECES] =
+            _pdep_u64(second_mask << 16 | first_mask, occupied_bit_board);
+    }
+
+    return piece_bit_boards;
+}
+#endif
+
+std::ostream &operator<<(std::ostream &os, PackingBackend backend)
+{
+    switch (backend)
+    {
+    case PackingBackend::ScalarPacking:
+        os << "scalar";
+        break;
+    case PackingBackend::Bmi2Packing:
+        os << "bmi2";
+        break;
+    }
+
+    return os;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "board_validity.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+
+/*
+_pdep_u64 is only declared when compiling for x86-64
+*/
+#if defined(__x86_64__)
+#define PACKED_POSITION_HAS_BMI2
+#endif
+
+enum PackingBackend : std::uint8_t
+{
+    ScalarPacking,
+    Bmi2Packing,
+};
+
+std::ostream &operator<<(std::ostream &os, PackingBackend backend);
+
+/*
+A position in 32 bytes, laid out exactly as it's stored in files, little endian:
+
+    occupied squares    8 bytes
+    piece codes         16 bytes, a nibble per occupied square from a1 up, low nibble first
+    fullmove counter    2 bytes
+    halfmove clock      1 byte
+    flags               1 byte, the player to move in the lowest bit and the castling rights above it
+    en passant square   1 byte, NO_EN_PASSANT_SQUARE if there isn't one
+    reserved            3 bytes of zeroes
+
+A piece code is the player times the number of pieces plus the piece. There's room for 32 pieces, which is as many as
+a game can ever have.
+
+Unpacking turns each piece code into a mask over the occupied squares in order, so with BMI2 every piece's bitboard is
+a single PDEP of its mask onto the occupied squares.
+*/
+class PackedPosition
+{
+  public:
+    static constexpr auto NUM_PLAYERS{2};
+    static constexpr auto NUM_PIECES{6};
+    static constexpr std::size_t MAX_PIECES{32};
+    static constexpr std::uint8_t NO_EN_PASSANT_SQUARE{BOARD_SQUARES};
+
+    using PlayerPieceBitBoards = std::array<BitBoard, NUM_PIECES>;
+    using PieceBitBoards = BoardValidity::PieceBitBoards;
+
+    /*
+    Throws if there are more than 32 pieces
+    */
+    PackedPosition(const PieceBitBoards &piece_bit_boards, Player current_player,
+                   CastlingRightsUnderlying castling_rights, std::optional<Square> en_passant_square,
+                   std::uint8_t halfmove_clock, std::uint16_t fullmove_counter);
+
+    /*
+    Codes past the last piece and squares past the 32nd occupied one are ignored, so any 32 bytes unpack to something,
+    though not always to something a Position can be built from
+    */
+    PieceBitBoards unpack_piece_bit_boards() const;
+    template <PackingBackend backend> PieceBitBoards unpack_piece_bit_boards() const;
+
+    /*
+    Whether a Position can be built from it, by the same rules as a FEN. The second takes the pieces already unpacked,
+    so they aren't unpacked twice.
+    */
+    bool is_valid() const;
+    bool is_valid(const PieceBitBoards &piece_bit_boards) const;
+
+    Player get_current_player() const;
+    CastlingRightsUnderlying get_castling_rights() const;
+    std::optional<Square> get_en_passant_square() const;
+    std::uint8_t get_halfmove_clock() const;
+    std::uint16_t get_fullmove_counter() const;
+
+    bool operator==(const PackedPosition &) const = default;
+
+    static PackingBackend get_backend();
+
+    /*
+    Not safe to call while other threads are unpacking. Throws if the CPU can't run the backend.
+    */
+    static void set_backend(PackingBackend new_backend);
+
+    static bool is_backend_supported(PackingBackend backend_to_check);
+
+  private:
+    static constexpr auto NUM_PIECE_CODES{NUM_PLAYERS * NUM_PIECES};
+    static constexpr auto PIECE_CODE_BITS{4};
+    static constexpr std::uint8_t PIECE_CODE_MASK{(1u << PIECE_CODE_BITS) - 1};
+
+    std::uint8_t get_piece_code(std::size_t piece_idx) const;
+
+    PieceBitBoards unpack_scalar_piece_bit_boards() const;
+#ifdef PACKED_POSITION_HAS_BMI2
+    [[gnu::target("bmi2")]] PieceBitBoards unpack_bmi2_piece_bit_boards() const;
+#endif
+
+    BitBoard occupied_bit_board;
+    std::array<std::uint8_t, MAX_PIECES / 2> piece_codes;
+    std::uint16_t fullmove_counter;
+    std::uint8_t halfmove_clock;
+    std::uint8_t flags;
+    std::uint8_t en_passant_square;
+    std::array<std::uint8_t, 3> reserved;
+
+    static PackingBackend backend;
+};
+
+/*
+Files are read and written as raw memory, so the layout above only holds on little endian machines
+*/
+static_assert(sizeof(PackedPosition) == 32);
+static_assert(std::endian::native == std::endian::little);
+
+inline PackedPosition::PieceBitBoards PackedPosition::unpack_piece_bit_boards() const
+{
+    if (backend == PackingBackend::Bmi2Packing)
+    {
+        return unpack_piece_bit_boards<PackingBackend::Bmi2Packing>();
+    }
+
+    return unpack_piece_bit_boards<PackingBackend::ScalarPacking>();
+}
+
+template <PackingBackend backend> PackedPosition::PieceBitBoards PackedPosition::unpack_piece_bit_boards() const
+{
+#ifdef PACKED_POSITION_HAS_BMI2
+    if constexpr (backend == PackingBackend::Bmi2Packing)
+    {
+        return unpack_bmi2_piece_bit_boards();
+    }
+#endif
+
+    return unpack_scalar_piece_bit_boards();
+}
+
+inline std::uint8_t PackedPosition::get_piece_code(std::size_t piece_idx) const
+{
+    return (piece_codes[piece_idx / 2] >> (piece_idx % 2 * PIECE_CODE_BITS)) & PIECE_CODE_MASK;
+}
+
+inline PackingBackend PackedPosition::get_backend()
+{
+    return backend;
+}
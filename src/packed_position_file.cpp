@@ -0,0 +1,40 @@
+#include "packed_position_file.hpp"
+
+#include <stdexcept>
+
+PackedPositionReader::PackedPositionReader(const std::string &path)
+    : file{path}, packed_positions{nullptr}, num_positions{0}
+{
+    const auto contents{file.get_contents()};
+    if (contents.size() % sizeof(PackedPosition))
+    {
+        throw std::logic_error{path + " isn't a whole number of packed positions"};
+    }
+
+    /*
+    Mappings start on a page boundary, so every position is aligned
+    */
+    packed_positions = reinterpret_cast<const PackedPosition *>(contents.data());
+    num_positions = contents.size() / sizeof(PackedPosition);
+}
+
+std::size_t PackedPositionReader::get_num_positions() const
+{
+    return num_positions;
+}
+
+PackedPositionWriter::PackedPositionWriter(const std::string &path) : file{path, std::ios::binary}
+{
+    if (!file)
+    {
+        throw std::logic_error{"Couldn't create " + path};
+    }
+}
+
+void PackedPositionWriter::write(const PackedPosition &packed_position)
+{
+    if (!file.write(reinterpret_cast<const char *>(&packed_position), sizeof(PackedPosition)))
+    {
+        throw std::logic_error{"Couldn't write packed position"};
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "packed_position.hpp"
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+/*
+Packed positions one after another with nothing else in between, so the nth starts 32 times n bytes in. Read through a
+memory mapping, so any of billions of positions can be picked out without reading the ones before it.
+*/
+class PackedPositionReader
+{
+  public:
+    /*
+    Throws if the file can't be mapped or isn't a whole number of positions
+    */
+    explicit PackedPositionReader(const std::string &path);
+
+    std::size_t get_num_positions() const;
+
+    /*
+    Neither the index nor the position is checked, though building a Position from an invalid one throws
+    */
+    const PackedPosition &get_packed_position(std::size_t position_idx) const;
+
+  private:
+    MappedFile file;
+    const PackedPosition *packed_positions;
+    std::size_t num_positions;
+};
+
+/*
+Appends to a new file of packed positions
+*/
+class PackedPositionWriter
+{
+  public:
+    /*
+    Throws if the file can't be created
+    */
+    explicit PackedPositionWriter(const std::string &path);
+
+    /*
+    Throws if the write fails
+    */
+    void write(const PackedPosition &packed_position);
+
+  private:
+    std::ofstream file;
+};
+
+inline const PackedPosition &PackedPositionReader::get_packed_position(std::size_t position_idx) const
+{
+    return packed_positions[position_idx];
+}
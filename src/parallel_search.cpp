@@ -0,0 +1,88 @@
+#include "parallel_search.hpp"
+
+#include <chrono>
+
+ParallelSearch::ParallelSearch(ThreadPool &thread_pool, TranspositionTable &transposition_table)
+    : thread_pool{thread_pool}, transposition_table{transposition_table}, signals{}, searches{}
+{
+    for (std::size_t thread_idx{0}; thread_idx < thread_pool.get_num_threads(); ++thread_idx)
+    {
+        searches.push_back(std::make_unique<Search>(transposition_table, signals, thread_idx));
+    }
+}
+
+void ParallelSearch::set_options(const SearchOptions &options)
+{
+    for (auto &search : searches)
+    {
+        search->set_options(options);
+    }
+}
+
+SearchResult ParallelSearch::search(const Position &root_position, const SearchLimits &limits,
+                                    const Search::Report &report)
+{
+    /*
+    Each thread would check it too, but throwing from inside the pool's tasks would end the program
+    */
+    Search::check_root_position(root_position);
+
+    const auto start_time{std::chrono::steady_clock::now()};
+    signals.stop = false;
+    signals.nodes = 0;
+    transposition_table.new_search();
+
+    std::vector<SearchResult> results(searches.size());
+    for (std::size_t thread_idx{0}; thread_idx < searches.size(); ++thread_idx)
+    {
+        thread_pool.submit([this, &root_position, &limits, &report, &results, thread_idx]() {
+            const auto is_main_thread{thread_idx == 0};
+            results[thread_idx] =
+                searches[thread_idx]->search(root_position, limits, is_main_thread ? report : Search::Report{});
+
+            /*
+            Helpers have no limits of their own, so they keep going until the main thread is done
+            */
+            if (is_main_thread)
+            {
+                signals.stop = true;
+            }
+        });
+    }
+    thread_pool.wait();
+
+    /*
+    A helper that got a whole iteration deeper is more trustworthy, but ties go to the main thread since its result is
+    the one that has been reported
+    */
+    auto best_result{results.front()};
+    for (std::size_t thread_idx{1}; thread_idx < results.size(); ++thread_idx)
+    {
+        const auto &result{results[thread_idx]};
+        if (result.depth > best_result.depth && result.best_move.has_value())
+        {
+            best_result = result;
+        }
+    }
+
+    best_result.nodes = signals.nodes;
+    best_result.beta_cutoffs = 0;
+    best_result.first_move_beta_cutoffs = 0;
+    best_result.pawn_hash_probes = 0;
+    best_result.pawn_hash_hits = 0;
+    for (const auto &result : results)
+    {
+        best_result.beta_cutoffs += result.beta_cutoffs;
+        best_result.first_move_beta_cutoffs += result.first_move_beta_cutoffs;
+        best_result.pawn_hash_probes += result.pawn_hash_probes;
+        best_result.pawn_hash_hits += result.pawn_hash_hits;
+    }
+    best_result.elapsed = std::chrono::steady_clock::now() - start_time;
+
+    return best_result;
+}
+
+std::size_t ParallelSearch::get_num_threads() const
+{
+    return searches.size();
+}
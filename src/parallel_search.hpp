@@ -0,0 +1,37 @@
+#pragma once
+
+#include "position.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+#include "transposition_table.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/*
+Lazy SMP. Every thread in the pool searches the same root with its own Search, and they only communicate through the
+shared transposition table and stop flag. Helper threads skip some depths, so they fill the table with entries the
+main thread is about to need and reach different parts of the tree than it would on its own.
+*/
+class ParallelSearch
+{
+  public:
+    ParallelSearch(ThreadPool &thread_pool, TranspositionTable &transposition_table);
+
+    void set_options(const SearchOptions &options);
+
+    /*
+    Stops once the main thread has finished. The result is from whichever thread completed the deepest iteration,
+    and the report is only called by the main thread. Throws if the root can't be searched from, as Search does.
+    */
+    SearchResult search(const Position &root_position, const SearchLimits &limits, const Search::Report &report = {});
+
+    std::size_t get_num_threads() const;
+
+  private:
+    ThreadPool &thread_pool;
+    TranspositionTable &transposition_table;
+    SearchSignals signals;
+    std::vector<std::unique_ptr<Search>> searches;
+};
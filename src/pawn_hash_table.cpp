@@ -0,0 +1,52 @@
+#include "pawn_hash_table.hpp"
+
+#include <algorithm>
+#include <bit>
+
+PawnHashTable::PawnHashTable(std::size_t kilobytes) : entries{nullptr}, num_entries{0}, statistics{}
+{
+    /*
+    A power of two number of entries lets the index be a mask of the key
+    */
+    static constexpr std::size_t KILOBYTE{1024};
+    num_entries = std::bit_floor(std::max<std::size_t>(kilobytes * KILOBYTE / sizeof(PawnHashTableEntry), 1));
+    entries = allocate_aligned_array<PawnHashTableEntry>(num_entries, false);
+    clear();
+}
+
+void PawnHashTable::clear()
+{
+    /*
+    Only a position without any pawns has a pawn key of 0, and an empty entry is exactly what that evaluates to
+    */
+    std::fill_n(entries.get(), num_entries, PawnHashTableEntry{});
+    clear_statistics();
+}
+
+std::optional<PawnHashTableEntry> PawnHashTable::probe(ZobristKey key)
+{
+    ++statistics.probes;
+    const auto &entry{get_entry(key)};
+    if (entry.key != key)
+    {
+        return std::nullopt;
+    }
+
+    ++statistics.hits;
+    return entry;
+}
+
+void PawnHashTable::store(const PawnHashTableEntry &entry)
+{
+    get_entry(entry.key) = entry;
+}
+
+PawnHashTable::Statistics PawnHashTable::get_statistics() const
+{
+    return statistics;
+}
+
+void PawnHashTable::clear_statistics()
+{
+    statistics = {};
+}
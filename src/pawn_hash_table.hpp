@@ -0,0 +1,72 @@
+#pragma once
+
+#include "memory.hpp"
+#include "piece_square_tables.hpp"
+#include "types.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/*
+Everything about a pawn structure that doesn't depend on where the other pieces are
+*/
+struct PawnHashTableEntry
+{
+    ZobristKey key;
+
+    /*
+    Positive for white
+    */
+    TaperedScore score;
+
+    /*
+    For each player, how many of their pawns would shield a king on each file's back rank
+    */
+    std::array<std::array<std::uint8_t, BOARD_WIDTH>, 2> pawn_shields;
+};
+
+/*
+Pawns move far less often than everything else, so almost every position searched shares its pawn structure with one
+evaluated just before. Each search thread has its own table, so there's no need for the lockless tricks of the
+transposition table.
+*/
+class PawnHashTable
+{
+  public:
+    struct Statistics
+    {
+        std::uint64_t probes;
+        std::uint64_t hits;
+    };
+
+    static constexpr std::size_t DEFAULT_KILOBYTES{512};
+
+    explicit PawnHashTable(std::size_t kilobytes = DEFAULT_KILOBYTES);
+
+    void clear();
+
+    std::optional<PawnHashTableEntry> probe(ZobristKey key);
+
+    /*
+    Always replaces whatever was there, since the newest pawn structure is the one most likely to come up again
+    */
+    void store(const PawnHashTableEntry &entry);
+
+    Statistics get_statistics() const;
+    void clear_statistics();
+
+  private:
+    PawnHashTableEntry &get_entry(ZobristKey key) const;
+
+    AlignedArray<PawnHashTableEntry> entries;
+    std::size_t num_entries;
+    Statistics statistics;
+};
+
+inline PawnHashTableEntry &PawnHashTable::get_entry(ZobristKey key) const
+{
+    return entries[key & (num_entries - 1)];
+}
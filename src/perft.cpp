@@ -0,0 +1,128 @@
+#include "perft.hpp"
+
+Perft::Perft(ThreadPool &thread_pool, PerftCache *cache, bool bulk_counting)
+    : thread_pool{thread_pool}, cache{cache}, bulk_counting{bulk_counting}, cache_probes{0}, cache_hits{0}
+{
+}
+
+std::uint64_t Perft::count(const Position &position, std::uint8_t depth)
+{
+    if (depth == 0)
+    {
+        return 1;
+    }
+
+    std::uint64_t node_count{0};
+    for (const auto &[move, move_node_count] : divide(position, depth))
+    {
+        node_count += move_node_count;
+    }
+
+    return node_count;
+}
+
+std::vector<Perft::DivideEntry> Perft::divide(const Position &position, std::uint8_t depth)
+{
+    cache_probes = 0;
+    cache_hits = 0;
+    if (depth == 0)
+    {
+        return {};
+    }
+
+    const auto moves{position.get_moves()};
+    std::vector<std::atomic<std::uint64_t>> node_counts(moves.size());
+
+    auto child_position{position};
+    for (std::size_t move_idx{0}; move_idx < moves.size(); ++move_idx)
+    {
+        child_position.make_move(moves[move_idx]);
+        submit_subtree(child_position, depth - 1, 1, node_counts[move_idx]);
+        child_position.unmake_move(moves[move_idx]);
+    }
+    thread_pool.wait();
+
+    std::vector<DivideEntry> divide_entries{};
+    for (std::size_t move_idx{0}; move_idx < moves.size(); ++move_idx)
+    {
+        divide_entries.emplace_back(moves[move_idx], node_counts[move_idx].load());
+    }
+
+    return divide_entries;
+}
+
+Perft::Statistics Perft::get_statistics() const
+{
+    return Statistics{cache_probes.load(), cache_hits.load()};
+}
+
+void Perft::submit_subtree(const Position &position, std::uint8_t depth, std::uint8_t ply,
+                           std::atomic<std::uint64_t> &node_count)
+{
+    thread_pool.submit([this, task_position = Position{position}, depth, ply, &node_count]() mutable {
+        if (ply < MAX_SPLIT_PLY && depth >= MIN_SPLIT_DEPTH)
+        {
+            MoveList moves{};
+            task_position.get_moves(moves);
+            for (const auto move : moves)
+            {
+                task_position.make_move(move);
+                submit_subtree(task_position, depth - 1, ply + 1, node_count);
+                task_position.unmake_move(move);
+            }
+        }
+        else
+        {
+            Statistics statistics{0, 0};
+            node_count.fetch_add(count_subtree(task_position, depth, statistics), std::memory_order_relaxed);
+            cache_probes.fetch_add(statistics.cache_probes, std::memory_order_relaxed);
+            cache_hits.fetch_add(statistics.cache_hits, std::memory_order_relaxed);
+        }
+    });
+}
+
+std::uint64_t Perft::count_subtree(Position &position, std::uint8_t depth, Statistics &statistics) const
+{
+    if (depth == 0)
+    {
+        return 1;
+    }
+    else if (depth == 1 && bulk_counting)
+    {
+        return position.count_moves();
+    }
+
+    const auto use_cache{cache != nullptr && depth >= MIN_CACHE_DEPTH};
+    if (use_cache)
+    {
+        ++statistics.cache_probes;
+        const auto cached_node_count{cache->probe(position.get_key(), depth)};
+        if (cached_node_count.has_value())
+        {
+            ++statistics.cache_hits;
+            return *cached_node_count;
+        }
+    }
+
+    MoveList moves{};
+    position.get_moves(moves);
+    if (depth == 1)
+    {
+        return moves.size();
+    }
+
+    std::uint64_t node_count{0};
+    for (const auto move : moves)
+    {
+        position.make_move(move);
+        node_count += count_subtree(position, depth - 1, statistics);
+        position.unmake_move(move);
+    }
+
+    if (use_cache)
+    {
+        cache->store(position.get_key(), depth, node_count);
+    }
+
+    return node_count;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "move.hpp"
+#include "perft_cache.hpp"
+#include "position.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/*
+Counts leaf nodes of the legal move tree, splitting the first few plies into tasks for the thread pool
+*/
+class Perft
+{
+  public:
+    using DivideEntry = std::pair<Move, std::uint64_t>;
+
+    struct Statistics
+    {
+        std::uint64_t cache_probes;
+        std::uint64_t cache_hits;
+    };
+
+    /*
+    The cache is optional, and can be shared between several Perft objects and threads. Bulk counting counts the
+    moves at depth 1 instead of generating them.
+    */
+    Perft(ThreadPool &thread_pool, PerftCache *cache = nullptr, bool bulk_counting = true);
+
+    std::uint64_t count(const Position &position, std::uint8_t depth);
+
+    /*
+    Node counts below each root move, the standard way to find which move a generator bug is under
+    */
+    std::vector<DivideEntry> divide(const Position &position, std::uint8_t depth);
+
+    /*
+    Totals for the most recent count or divide
+    */
+    Statistics get_statistics() const;
+
+  private:
+    /*
+    Splitting deeper than this just makes tasks too small to be worth copying a position for
+    */
+    static constexpr std::uint8_t MAX_SPLIT_PLY{2};
+    static constexpr std::uint8_t MIN_SPLIT_DEPTH{4};
+
+    /*
+    Below this the subtree is cheaper to count than to look up
+    */
+    static constexpr std::uint8_t MIN_CACHE_DEPTH{2};
+
+    void submit_subtree(const Position &position, std::uint8_t depth, std::uint8_t ply,
+                        std::atomic<std::uint64_t> &node_count);
+    std::uint64_t count_subtree(Position &position, std::uint8_t depth, Statistics &statistics) const;
+
+    ThreadPool &thread_pool;
+    PerftCache *cache;
+    bool bulk_counting;
+
+    /*
+    Tasks keep their own statistics and only add them here once they finish
+    */
+    std::atomic<std::uint64_t> cache_probes;
+    std::atomic<std::uint64_t> cache_hits;
+};
@@ -0,0 +1,64 @@
+#include "perft_cache.hpp"
+
+#include <algorithm>
+#include <bit>
+
+PerftCache::PerftCache(std::size_t megabytes, bool use_huge_pages)
+    : buckets{nullptr}, num_buckets{std::bit_floor(std::max<std::size_t>(megabytes * MEGABYTE / sizeof(Bucket), 1))}
+{
+    buckets = allocate_aligned_array<Bucket>(num_buckets, use_huge_pages);
+    clear();
+}
+
+void PerftCache::clear()
+{
+    for (std::size_t bucket_idx{0}; bucket_idx < num_buckets; ++bucket_idx)
+    {
+        for (auto &slot : buckets[bucket_idx].slots)
+        {
+            slot.key_xor_data.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::optional<std::uint64_t> PerftCache::probe(ZobristKey key, std::uint8_t depth) const
+{
+    for (const auto &slot : get_bucket(key).slots)
+    {
+        const auto data{slot.data.load(std::memory_order_relaxed)};
+        const auto key_xor_data{slot.key_xor_data.load(std::memory_order_relaxed)};
+        if ((key_xor_data ^ data) == key && (data >> DEPTH_SHIFT) == depth)
+        {
+            return data & NODE_COUNT_MASK;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void PerftCache::store(ZobristKey key, std::uint8_t depth, std::uint64_t node_count)
+{
+    /*
+    Deeper subtrees are far more expensive to recount, so the shallowest slot is always the one replaced
+    */
+    auto &bucket{get_bucket(key)};
+    auto *replace_slot{&bucket.slots.front()};
+    for (auto &slot : bucket.slots)
+    {
+        if ((slot.data.load(std::memory_order_relaxed) >> DEPTH_SHIFT) <
+            (replace_slot->data.load(std::memory_order_relaxed) >> DEPTH_SHIFT))
+        {
+            replace_slot = &slot;
+        }
+    }
+
+    const auto data{(static_cast<std::uint64_t>(depth) << DEPTH_SHIFT) | (node_count & NODE_COUNT_MASK)};
+    replace_slot->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    replace_slot->data.store(data, std::memory_order_relaxed);
+}
+
+PerftCache::Bucket &PerftCache::get_bucket(ZobristKey key) const
+{
+    return buckets[key & (num_buckets - 1)];
+}
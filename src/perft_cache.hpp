@@ -0,0 +1,46 @@
+#pragma once
+
+#include "memory.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/*
+Node counts of already enumerated subtrees, keyed on position and remaining depth. Lockless in the same way as the
+transposition table: a slot holds its key xor'd with its data, so torn writes fail verification.
+*/
+class PerftCache
+{
+  public:
+    PerftCache(std::size_t megabytes, bool use_huge_pages = true);
+
+    void clear();
+
+    std::optional<std::uint64_t> probe(ZobristKey key, std::uint8_t depth) const;
+    void store(ZobristKey key, std::uint8_t depth, std::uint64_t node_count);
+
+  private:
+    static constexpr auto DEPTH_SHIFT{56};
+    static constexpr std::uint64_t NODE_COUNT_MASK{(std::uint64_t{1} << DEPTH_SHIFT) - 1};
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> key_xor_data;
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(CACHE_LINE_BYTES) Bucket
+    {
+        std::array<Slot, CACHE_LINE_BYTES / sizeof(Slot)> slots;
+    };
+    static_assert(sizeof(Bucket) == CACHE_LINE_BYTES);
+
+    Bucket &get_bucket(ZobristKey key) const;
+
+    AlignedArray<Bucket> buckets;
+    std::size_t num_buckets;
+};
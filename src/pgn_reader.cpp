@@ -0,0 +1,672 @@
+#include "pgn_reader.hpp"
+
+#include "fen_parser.hpp"
+#include "newline_scan.hpp"
+
+#include <algorithm>
+
+namespace
+{
+std::optional<PgnResult> parse_result(std::string_view text)
+{
+    if (text == "1-0")
+    {
+        return PgnResult::WhiteWin;
+    }
+    if (text == "0-1")
+    {
+        return PgnResult::BlackWin;
+    }
+    if (text == "1/2-1/2")
+    {
+        return PgnResult::Draw;
+    }
+    if (text == "*")
+    {
+        return PgnResult::UnknownResult;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<Piece> parse_san_piece(char character)
+{
+    switch (character)
+    {
+    case 'N':
+        return Piece::Knight;
+    case 'B':
+        return Piece::Bishop;
+    case 'R':
+        return Piece::Rook;
+    case 'Q':
+        return Piece::Queen;
+    case 'K':
+        return Piece::King;
+    default:
+        return std::nullopt;
+    }
+}
+
+/*
+Replays the games in one chunk a line at a time, carrying comments that span lines over to the next one
+*/
+class GameReplay
+{
+  public:
+    GameReplay(const PgnOptions &options, const PgnReader::MoveCallback &move_callback,
+               const PgnReader::GameCallback &game_callback);
+
+    PgnReader::Statistics read(std::string_view chunk);
+
+  private:
+    enum GameState : std::uint8_t
+    {
+        NoGame,
+        ReadingTags,
+        ReadingMoves,
+        SkippingGame,
+    };
+
+    void read_line(std::string_view line);
+    void read_tag(std::string_view line);
+    void read_movetext(std::string_view line);
+    void read_token(std::string_view token);
+
+    /*
+    The position is only set up once the tags are all read, since any of them could be the FEN
+    */
+    void start_moves();
+    void make_move(Move move);
+
+    /*
+    A variation replaces the move before it, so that move is unmade and kept to be made again at the end
+    */
+    void start_variation();
+    void end_variation();
+
+    void end_game(PgnResult result);
+    void skip_game();
+
+    const PgnOptions &options;
+    const PgnReader::MoveCallback &move_callback;
+    const PgnReader::GameCallback &game_callback;
+    PgnReader::Statistics statistics;
+    GameState state;
+    PgnGame game;
+    FenParser fen_parser;
+    Position position;
+
+    /*
+    Whether unmaking every move on the line gets back to the standard starting position
+    */
+    bool is_from_start_position;
+
+    /*
+    Everything made on the line being played since the position was last set up, to unmake when a variation starts
+    */
+    std::vector<Move> line_moves;
+
+    /*
+    The number of moves on the line each open variation branched from, and the move it replaced
+    */
+    std::vector<std::pair<std::size_t, Move>> variations;
+
+    bool is_in_comment;
+
+    /*
+    How deep into variations that aren't being read the movetext is
+    */
+    std::size_t skipped_variation_depth;
+};
+
+GameReplay::GameReplay(const PgnOptions &options, const PgnReader::MoveCallback &move_callback,
+                       const PgnReader::GameCallback &game_callback)
+    : options{options}, move_callback{move_callback}, game_callback{game_callback}, statistics{0, 0, 0},
+      state{GameState::NoGame}, game{{}, PgnResult::UnknownResult, 0, 0}, fen_parser{}, position{},
+      is_from_start_position{true}, line_moves{}, variations{}, is_in_comment{false}, skipped_variation_depth{0}
+{
+}
+
+PgnReader::Statistics GameReplay::read(std::string_view chunk)
+{
+    NewlineScan::for_each_line(chunk, [this](std::string_view line) { read_line(line); });
+
+    /*
+    The last game in the file might not have a termination marker
+    */
+    end_game(PgnResult::UnknownResult);
+
+    return statistics;
+}
+
+void GameReplay::read_line(std::string_view line)
+{
+    if (line.empty() || line.front() == '%')
+    {
+        return;
+    }
+
+    if (line.front() == '[' && !is_in_comment)
+    {
+        read_tag(line);
+    }
+    else
+    {
+        read_movetext(line);
+    }
+}
+
+void GameReplay::read_tag(std::string_view line)
+{
+    if (state != GameState::ReadingTags)
+    {
+        end_game(PgnResult::UnknownResult);
+
+        state = GameState::ReadingTags;
+        game.tags.clear();
+        game.result = PgnResult::UnknownResult;
+        game.num_plies = 0;
+        game.variation_depth = 0;
+        is_in_comment = false;
+        skipped_variation_depth = 0;
+    }
+
+    /*
+    Malformed tags are left out rather than throwing away the whole game
+    */
+    const auto name_end{line.find(' ')};
+    const auto value_begin{line.find('"', name_end)};
+    const auto value_end{line.rfind('"')};
+    if (name_end == std::string_view::npos || value_begin == std::string_view::npos || value_end <= value_begin)
+    {
+        return;
+    }
+
+    game.tags.emplace_back(line.substr(1, name_end - 1), line.substr(value_begin + 1, value_end - value_begin - 1));
+}
+
+void GameReplay::read_movetext(std::string_view line)
+{
+    if (state == GameState::NoGame || state == GameState::ReadingTags)
+    {
+        start_moves();
+    }
+
+    /*
+    A game being skipped still has its comments followed, so a line inside one that starts like a tag doesn't start a
+    game of its own
+    */
+    std::size_t idx{0};
+    while (idx < line.size() && (state == GameState::ReadingMoves || state == GameState::SkippingGame))
+    {
+        if (is_in_comment)
+        {
+            const auto comment_end{line.find('}', idx)};
+            if (comment_end == std::string_view::npos)
+            {
+                return;
+            }
+
+            is_in_comment = false;
+            idx = comment_end + 1;
+            continue;
+        }
+
+        switch (line[idx])
+        {
+        case ' ':
+        case '\t':
+            ++idx;
+            break;
+        case '{':
+            is_in_comment = true;
+            ++idx;
+            break;
+        case ';':
+            return;
+        case '(':
+            if (state == GameState::ReadingMoves)
+            {
+                start_variation();
+            }
+            ++idx;
+            break;
+        case ')':
+            if (state == GameState::ReadingMoves)
+            {
+                end_variation();
+            }
+            ++idx;
+            break;
+        default: {
+            const auto token_end{std::min(line.find_first_of(" \t{;()", idx), line.size())};
+            if (state == GameState::ReadingMoves)
+            {
+                read_token(line.substr(idx, token_end - idx));
+            }
+            idx = token_end;
+            break;
+        }
+        }
+    }
+}
+
+void GameReplay::read_token(std::string_view token)
+{
+    if (skipped_variation_depth)
+    {
+        return;
+    }
+
+    if (const auto result{parse_result(token)})
+    {
+        if (!game.variation_depth)
+        {
+            end_game(*result);
+        }
+        return;
+    }
+
+    if (token.front() == '$')
+    {
+        return;
+    }
+
+    /*
+    Move numbers can be written straight up against the move, as in "12.Nf3" or "12...Nf3"
+    */
+    const auto number_end{token.find_first_not_of("0123456789")};
+    if (number_end != std::string_view::npos && token[number_end] == '.')
+    {
+        const auto move_begin{token.find_first_not_of('.', number_end)};
+        if (move_begin == std::string_view::npos)
+        {
+            return;
+        }
+        token.remove_prefix(move_begin);
+    }
+
+    const auto move{PgnReader::find_san_move(position, token)};
+    if (!move.has_value())
+    {
+        skip_game();
+        return;
+    }
+
+    make_move(*move);
+}
+
+void GameReplay::start_moves()
+{
+    /*
+    Most of a position is its undo stack, so unmaking the last game is much cheaper than copying in a new one when
+    it started from the same place
+    */
+    const auto fen{game.get_tag("FEN")};
+    if (fen.empty() && is_from_start_position)
+    {
+        for (; !line_moves.empty(); line_moves.pop_back())
+        {
+            position.unmake_move(line_moves.back());
+        }
+    }
+    else if (fen.empty())
+    {
+        position = Position{};
+    }
+    else if (fen_parser.parse(fen) == FenError::NoFenError)
+    {
+        position = Position{fen_parser};
+    }
+    else
+    {
+        state = GameState::ReadingMoves;
+        skip_game();
+        return;
+    }
+
+    state = GameState::ReadingMoves;
+    is_from_start_position = fen.empty();
+    line_moves.clear();
+    variations.clear();
+}
+
+void GameReplay::make_move(Move move)
+{
+    if (line_moves.size() == Position::MAX_UNDO_DEPTH)
+    {
+        if (!variations.empty())
+        {
+            skip_game();
+            return;
+        }
+
+        position = Position{position.pack()};
+        is_from_start_position = false;
+        line_moves.clear();
+    }
+
+    if (move_callback)
+    {
+        move_callback(game, position, move);
+    }
+
+    position.make_move(move);
+    line_moves.push_back(move);
+    ++statistics.moves;
+    if (!game.variation_depth)
+    {
+        ++game.num_plies;
+    }
+}
+
+void GameReplay::start_variation()
+{
+    if (!options.read_variations || skipped_variation_depth)
+    {
+        ++skipped_variation_depth;
+        return;
+    }
+
+    if (line_moves.empty())
+    {
+        skip_game();
+        return;
+    }
+
+    const auto replaced_move{line_moves.back()};
+    line_moves.pop_back();
+    position.unmake_move(replaced_move);
+    variations.emplace_back(line_moves.size(), replaced_move);
+    ++game.variation_depth;
+}
+
+void GameReplay::end_variation()
+{
+    if (skipped_variation_depth)
+    {
+        --skipped_variation_depth;
+        return;
+    }
+
+    if (variations.empty())
+    {
+        skip_game();
+        return;
+    }
+
+    const auto [num_line_moves, replaced_move]{variations.back()};
+    variations.pop_back();
+    for (; line_moves.size() > num_line_moves; line_moves.pop_back())
+    {
+        position.unmake_move(line_moves.back());
+    }
+
+    position.make_move(replaced_move);
+    line_moves.push_back(replaced_move);
+    --game.variation_depth;
+}
+
+void GameReplay::end_game(PgnResult result)
+{
+    if (state != GameState::ReadingMoves)
+    {
+        return;
+    }
+
+    /*
+    Variations left open at the end still have to be unwound to get back to the main line
+    */
+    while (!variations.empty())
+    {
+        end_variation();
+    }
+
+    game.result = result;
+    if (result == PgnResult::UnknownResult)
+    {
+        game.result = parse_result(game.get_tag("Result")).value_or(PgnResult::UnknownResult);
+    }
+
+    ++statistics.games;
+    if (game_callback)
+    {
+        game_callback(game, position);
+    }
+    state = GameState::NoGame;
+}
+
+void GameReplay::skip_game()
+{
+    ++statistics.invalid_games;
+    state = GameState::SkippingGame;
+}
+} // namespace
+
+std::string_view PgnGame::get_tag(std::string_view name) const
+{
+    for (const auto &[tag_name, tag_value] : tags)
+    {
+        if (tag_name == name)
+        {
+            return tag_value;
+        }
+    }
+
+    return {};
+}
+
+PgnReader::PgnReader(const std::string &path, const PgnOptions &options) : file{path}, options{options}
+{
+}
+
+PgnReader::Statistics PgnReader::read(const MoveCallback &move_callback, const GameCallback &game_callback) const
+{
+    return GameReplay{options, move_callback, game_callback}.read(file.get_contents());
+}
+
+PgnReader::Statistics PgnReader::read(ThreadPool &thread_pool, const MoveCallback &move_callback,
+                                      const GameCallback &game_callback) const
+{
+    const auto chunks{split_into_chunks(thread_pool.get_num_threads() * CHUNKS_PER_THREAD)};
+    std::vector<Statistics> chunk_statistics(chunks.size());
+    for (std::size_t chunk_idx{0}; chunk_idx < chunks.size(); ++chunk_idx)
+    {
+        thread_pool.submit([this, &chunks, &chunk_statistics, &move_callback, &game_callback, chunk_idx] {
+            chunk_statistics[chunk_idx] =
+                GameReplay{options, move_callback, game_callback}.read(chunks[chunk_idx]);
+        });
+    }
+    thread_pool.wait();
+
+    Statistics statistics{0, 0, 0};
+    for (const auto &[games, moves, invalid_games] : chunk_statistics)
+    {
+        statistics.games += games;
+        statistics.moves += moves;
+        statistics.invalid_games += invalid_games;
+    }
+
+    return statistics;
+}
+
+std::optional<Move> PgnReader::find_san_move(const Position &position, std::string_view san)
+{
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+    {
+        san.remove_suffix(1);
+    }
+
+    const auto legal_moves{position.get_moves()};
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+    {
+        const auto is_kingside{san.size() == 3};
+        for (const auto move : legal_moves)
+        {
+            if (move.get_flag() == MoveFlag::Castle &&
+                (square_to_file(Square(move.get_to())) == File::FG) == is_kingside)
+            {
+                return move;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    auto piece{Piece::Pawn};
+    if (const auto san_piece{san.empty() ? std::nullopt : parse_san_piece(san.front())})
+    {
+        piece = *san_piece;
+        san.remove_prefix(1);
+    }
+
+    std::optional<Piece> promotion_piece{};
+    if (!san.empty())
+    {
+        promotion_piece = parse_san_piece(san.back());
+        if (promotion_piece.has_value())
+        {
+            san.remove_suffix(1);
+            if (!san.empty() && san.back() == '=')
+            {
+                san.remove_suffix(1);
+            }
+        }
+    }
+
+    if (san.size() < 2)
+    {
+        return std::nullopt;
+    }
+
+    const auto to_file{san[san.size() - 2]};
+    const auto to_rank{san[san.size() - 1]};
+    if (to_file < 'a' || to_file > 'h' || to_rank < '1' || to_rank > '8')
+    {
+        return std::nullopt;
+    }
+    const auto to_square{Square((to_rank - '1') * BOARD_WIDTH + (to_file - 'a'))};
+    san.remove_suffix(2);
+
+    /*
+    Whatever's left says which piece moves when more than one could, by its file, its rank, or both
+    */
+    std::optional<File> from_file{};
+    std::optional<Rank> from_rank{};
+    for (const auto character : san)
+    {
+        if (character >= 'a' && character <= 'h')
+        {
+            from_file = File(character - 'a');
+        }
+        else if (character >= '1' && character <= '8')
+        {
+            from_rank = Rank(character - '1');
+        }
+        else if (character != 'x')
+        {
+            return std::nullopt;
+        }
+    }
+
+    std::optional<Move> san_move{};
+    for (const auto move : legal_moves)
+    {
+        const auto from_square{Square(move.get_from())};
+        if (move.get_to() != to_square || move.get_flag() == MoveFlag::Castle ||
+            position.get_moved_piece(move) != piece ||
+            (move.is_promotion() ? move.get_promotion_piece() != promotion_piece : promotion_piece.has_value()) ||
+            (from_file.has_value() && square_to_file(from_square) != *from_file) ||
+            (from_rank.has_value() && square_to_rank(from_square) != *from_rank))
+        {
+            continue;
+        }
+
+        if (san_move.has_value())
+        {
+            return std::nullopt;
+        }
+        san_move = move;
+    }
+
+    return san_move;
+}
+
+std::vector<std::string_view> PgnReader::split_into_chunks(std::size_t max_chunks) const
+{
+    const auto contents{file.get_contents()};
+    const auto num_chunks{std::clamp<std::size_t>(contents.size() / MIN_CHUNK_BYTES, 1, max_chunks)};
+
+    std::vector<std::string_view> chunks{};
+    std::size_t chunk_begin{0};
+    for (std::size_t chunk_idx{1}; chunk_idx <= num_chunks && chunk_begin < contents.size(); ++chunk_idx)
+    {
+        auto chunk_end{contents.size()};
+        if (chunk_idx < num_chunks)
+        {
+            auto newline_idx{contents.find('\n', std::max(chunk_begin, contents.size() * chunk_idx / num_chunks))};
+            while (newline_idx != std::string_view::npos && !is_game_start(contents, newline_idx + 1))
+            {
+                newline_idx = contents.find('\n', newline_idx + 1);
+            }
+            if (newline_idx != std::string_view::npos)
+            {
+                chunk_end = newline_idx + 1;
+            }
+        }
+
+        chunks.push_back(contents.substr(chunk_begin, chunk_end - chunk_begin));
+        chunk_begin = chunk_end;
+    }
+
+    return chunks;
+}
+
+bool PgnReader::is_game_start(std::string_view contents, std::size_t line_begin)
+{
+    if (line_begin >= contents.size() || contents[line_begin] != '[')
+    {
+        return false;
+    }
+
+    /*
+    Games are separated by a blank line, and the last line before that has to be movetext rather than another tag. A
+    comment could still have a line like this in it, but that's never seen in practice.
+    */
+    const auto previous_end{contents.find_last_not_of(" \t\r\n", line_begin - 1)};
+    if (previous_end == std::string_view::npos)
+    {
+        return true;
+    }
+    const auto separator{contents.substr(previous_end, line_begin - previous_end)};
+    if (std::count(separator.begin(), separator.end(), '\n') < 2)
+    {
+        return false;
+    }
+    const auto previous_newline{contents.rfind('\n', previous_end)};
+    const auto previous_begin{previous_newline == std::string_view::npos ? 0 : previous_newline + 1};
+
+    return contents[previous_begin] != '[';
+}
+
+std::ostream &operator<<(std::ostream &os, PgnResult result)
+{
+    switch (result)
+    {
+    case PgnResult::WhiteWin:
+        os << "1-0";
+        break;
+    case PgnResult::BlackWin:
+        os << "0-1";
+        break;
+    case PgnResult::Draw:
+        os << "1/2-1/2";
+        break;
+    case PgnResult::UnknownResult:
+        os << "*";
+        break;
+    }
+
+    return os;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "memory.hpp"
+#include "move.hpp"
+#include "position.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum PgnResult : std::uint8_t
+{
+    WhiteWin,
+    BlackWin,
+    Draw,
+    UnknownResult,
+};
+
+std::ostream &operator<<(std::ostream &os, PgnResult result);
+
+/*
+The game being replayed. Tags are views into the mapping with any escapes left in.
+*/
+struct PgnGame
+{
+    std::vector<std::pair<std::string_view, std::string_view>> tags;
+
+    /*
+    From the game termination marker, or the Result tag if the movetext ran out without one. Unknown until the game
+    is finished.
+    */
+    PgnResult result;
+
+    /*
+    Moves made on the main line so far
+    */
+    std::size_t num_plies;
+
+    /*
+    How many variations deep the move being made is, 0 on the main line
+    */
+    std::size_t variation_depth;
+
+    /*
+    Empty if the game doesn't have the tag
+    */
+    std::string_view get_tag(std::string_view name) const;
+};
+
+struct PgnOptions
+{
+    /*
+    Replays recursive variations too, unmaking moves back to where each one branches off
+    */
+    bool read_variations{false};
+};
+
+/*
+Every game in a memory mapped PGN file, replayed move by move. Lines are parsed where they are in the mapping and SAN
+is decoded by matching it against the legal moves, so nothing is copied per move. Comments, NAGs, move numbers and
+escape lines are skipped. A game with a move that isn't legal, or a FEN tag that doesn't parse, is counted as invalid
+and dropped from there to the next tag section.
+
+Main lines longer than the position's undo stack are carried on from a copy of the position without its history, so
+repetitions across that point aren't seen. A variation can't be carried on that way, since its moves have to be unmade
+again, so a game with a line that deep inside a variation is dropped and counted as invalid.
+*/
+class PgnReader
+{
+  public:
+    /*
+    Called for each move with the position before it's made
+    */
+    using MoveCallback = std::function<void(const PgnGame &game, const Position &position, Move move)>;
+
+    /*
+    Called once a game is finished, with the position at the end of its main line
+    */
+    using GameCallback = std::function<void(const PgnGame &game, const Position &position)>;
+
+    struct Statistics
+    {
+        std::uint64_t games;
+        std::uint64_t moves;
+        std::uint64_t invalid_games;
+    };
+
+    /*
+    Throws if the file can't be mapped
+    */
+    explicit PgnReader(const std::string &path, const PgnOptions &options = {});
+
+    /*
+    In file order, on the calling thread. Either callback can be empty.
+    */
+    Statistics read(const MoveCallback &move_callback, const GameCallback &game_callback = {}) const;
+
+    /*
+    Splits the file at game boundaries into several chunks per thread and replays them all at once. Games aren't called
+    back in file order, and the callbacks are called from several threads at once. Must not be called from inside one
+    of the pool's tasks.
+    */
+    Statistics read(ThreadPool &thread_pool, const MoveCallback &move_callback,
+                    const GameCallback &game_callback = {}) const;
+
+    /*
+    The legal move the SAN names, if there's exactly one. Check, mate and annotation marks are ignored, and castling
+    can be written with zeroes.
+    */
+    static std::optional<Move> find_san_move(const Position &position, std::string_view san);
+
+  private:
+    static constexpr std::size_t CHUNKS_PER_THREAD{8};
+
+    /*
+    Smaller files aren't worth handing out to other threads
+    */
+    static constexpr std::size_t MIN_CHUNK_BYTES{MEGABYTE};
+
+    /*
+    A game starts at the first tag line after its movetext, so a chunk ends just before one
+    */
+    std::vector<std::string_view> split_into_chunks(std::size_t max_chunks) const;
+    static bool is_game_start(std::string_view contents, std::size_t line_begin);
+
+    MappedFile file;
+    PgnOptions options;
+};
@@ -1,35 +1,653 @@
 #include "position.hpp"
 
-Position::Position() : white_bit_boards{}, black_bit_boards{}, current_player{Player::White}
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+consteval Lookup<CastlingRightsUnderlying> Position::create_castling_rights_mask_lookup()
+{
+    Lookup<CastlingRightsUnderlying> castling_rights_mask_lookup{};
+    castling_rights_mask_lookup.fill(CastlingRights::AllCastling);
+
+    /*
+    Moving from or capturing on any of these squares loses the corresponding rights for good
+    */
+    castling_rights_mask_lookup.at(Square::A1) &= ~CastlingRights::WhiteQueenside;
+    castling_rights_mask_lookup.at(Square::E1) &= ~(CastlingRights::WhiteKingside | CastlingRights::WhiteQueenside);
+    castling_rights_mask_lookup.at(Square::H1) &= ~CastlingRights::WhiteKingside;
+    castling_rights_mask_lookup.at(Square::A8) &= ~CastlingRights::BlackQueenside;
+    castling_rights_mask_lookup.at(Square::E8) &= ~(CastlingRights::BlackKingside | CastlingRights::BlackQueenside);
+    castling_rights_mask_lookup.at(Square::H8) &= ~CastlingRights::BlackKingside;
+
+    return castling_rights_mask_lookup;
+}
+
+constexpr Lookup<CastlingRightsUnderlying> Position::CASTLING_RIGHTS_MASK_LOOKUP{create_castling_rights_mask_lookup()};
+
+Position::Position()
+    : white_bit_boards{}, black_bit_boards{}, current_player{Player::White},
+      castling_rights{CastlingRights::AllCastling}, en_passant_bit_board{0}, halfmove_clock{0}, fullmove_counter{1},
+      key{0}, pawn_key{0}, score{}, phase{0}, nnue{nullptr}, accumulator{}, undo_stack_size{0}
 {
+    key = compute_key();
+    pawn_key = compute_pawn_key();
+    compute_score_and_phase();
 }
 
 Position::Position(const FenParser &fen_parser)
-    : white_bit_boards{fen_parser}, black_bit_boards{fen_parser}, current_player{fen_parser.get_current_player()}
+    : white_bit_boards{fen_parser}, black_bit_boards{fen_parser}, current_player{fen_parser.get_current_player()},
+      castling_rights{fen_parser.get_castling_rights()}, en_passant_bit_board{0},
+      halfmove_clock{fen_parser.get_halfmove_clock()}, fullmove_counter{fen_parser.get_fullmove_counter()},
+      key{0}, pawn_key{0}, score{}, phase{0}, nnue{nullptr}, accumulator{}, undo_stack_size{0}
 {
+    const auto en_passant_square{fen_parser.get_en_passant_square()};
+    if (en_passant_square.has_value())
+    {
+        en_passant_bit_board = square_to_bit_board(*en_passant_square);
+    }
+
+    key = compute_key();
+    pawn_key = compute_pawn_key();
+    compute_score_and_phase();
 }
 
-Evaluation Position::get_piece_difference() const
+Position::Position(const PackedPosition &packed_position)
+    : Position{packed_position, packed_position.unpack_piece_bit_boards()}
 {
-    return white_bit_boards.get_total_piece_value() - black_bit_boards.get_total_piece_value();
 }
 
-std::vector<Move> Position::get_moves() const
+Position::Position(const PackedPosition &packed_position, const PackedPosition::PieceBitBoards &piece_bit_boards)
+    : white_bit_boards{piece_bit_boards[Player::White]}, black_bit_boards{piece_bit_boards[Player::Black]},
+      current_player{packed_position.get_current_player()}, castling_rights{packed_position.get_castling_rights()},
+      en_passant_bit_board{0}, halfmove_clock{packed_position.get_halfmove_clock()},
+      fullmove_counter{packed_position.get_fullmove_counter()}, key{0}, pawn_key{0}, score{}, phase{0}, nnue{nullptr},
+      accumulator{}, undo_stack_size{0}
+{
+    if (!packed_position.is_valid(piece_bit_boards))
+    {
+        throw std::logic_error{"Packed position can't be made into a position"};
+    }
+
+    const auto en_passant_square{packed_position.get_en_passant_square()};
+    if (en_passant_square.has_value())
+    {
+        en_passant_bit_board = square_to_bit_board(*en_passant_square);
+    }
+
+    key = compute_key();
+    pawn_key = compute_pawn_key();
+    compute_score_and_phase();
+}
+
+PackedPosition Position::pack() const
+{
+    PackedPosition::PieceBitBoards piece_bit_boards{};
+    for (const auto piece : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King})
+    {
+        piece_bit_boards[Player::White][piece] = white_bit_boards.get_piece_bit_board(piece);
+        piece_bit_boards[Player::Black][piece] = black_bit_boards.get_piece_bit_board(piece);
+    }
+
+    std::optional<Square> en_passant_square{};
+    if (en_passant_bit_board)
+    {
+        en_passant_square = Square(std::countr_zero(en_passant_bit_board));
+    }
+
+    return {piece_bit_boards, current_player, castling_rights, en_passant_square, halfmove_clock, fullmove_counter};
+}
+
+Evaluation Position::get_evaluation() const
+{
+    if (nnue == nullptr)
+    {
+        return PieceSquareTables::interpolate(score, phase);
+    }
+
+    const auto evaluation{nnue->evaluate(accumulator, current_player)};
+
+    return current_player == Player::White ? evaluation : static_cast<Evaluation>(-evaluation);
+}
+
+Evaluation Position::get_evaluation(PawnHashTable &pawn_hash_table) const
+{
+    if (nnue != nullptr)
+    {
+        return get_evaluation();
+    }
+
+    auto entry{pawn_hash_table.probe(pawn_key)};
+    if (!entry.has_value())
+    {
+        entry = compute_pawn_hash_table_entry();
+        pawn_hash_table.store(*entry);
+    }
+
+    /*
+    Everything is added up before interpolating, so it all still costs one interpolation
+    */
+    auto total_score{score};
+    total_score += entry->score;
+    total_score += get_pawn_shield_score<Player::White>(*entry);
+    total_score -= get_pawn_shield_score<Player::Black>(*entry);
+
+    return PieceSquareTables::interpolate(total_score, phase);
+}
+
+void Position::set_nnue(const Nnue *new_nnue)
+{
+    nnue = new_nnue;
+    if (nnue != nullptr)
+    {
+        refresh_features<Player::White>();
+        refresh_features<Player::Black>();
+    }
+}
+
+MoveList Position::get_moves() const
+{
+    MoveList moves{};
+    get_moves(moves);
+
+    return moves;
+}
+
+std::size_t Position::count_moves() const
+{
+    MoveCounter move_counter{};
+    get_moves(move_counter);
+
+    return move_counter.size();
+}
+
+bool Position::is_legal(Move move, const CheckInfo &check_info) const
 {
     if (current_player == Player::White)
     {
-        BitBoard opponent_attacking_bit_board{0}; // TODO
-        const auto opponent_occupied_bit_board{black_bit_boards.get_occupied_bit_board()};
-        return white_bit_boards.get_moves(opponent_occupied_bit_board, opponent_attacking_bit_board);
+        return white_bit_boards.is_legal(move, black_bit_boards.get_occupied_bit_board(), check_info,
+                                         en_passant_bit_board, castling_rights);
+    }
+
+    return black_bit_boards.is_legal(move, white_bit_boards.get_occupied_bit_board(), check_info, en_passant_bit_board,
+                                     castling_rights);
+}
+
+std::optional<Piece> Position::get_captured_piece(Move move) const
+{
+    if (move.get_flag() == MoveFlag::EnPassant)
+    {
+        return Piece::Pawn;
+    }
+
+    const auto to_bit_board{square_to_bit_board(Square{move.get_to()})};
+    if (current_player == Player::White)
+    {
+        return black_bit_boards.find_piece(to_bit_board);
+    }
+
+    return white_bit_boards.find_piece(to_bit_board);
+}
+
+Piece Position::get_moved_piece(Move move) const
+{
+    const auto from_bit_board{square_to_bit_board(Square{move.get_from()})};
+    if (current_player == Player::White)
+    {
+        return white_bit_boards.get_piece(from_bit_board);
+    }
+
+    return black_bit_boards.get_piece(from_bit_board);
+}
+
+Evaluation Position::get_static_exchange_evaluation(Move move) const
+{
+    if (current_player == Player::White)
+    {
+        return get_static_exchange_evaluation<Player::White>(move);
+    }
+
+    return get_static_exchange_evaluation<Player::Black>(move);
+}
+
+void Position::make_move(Move move)
+{
+    if (current_player == Player::White)
+    {
+        make_move<Player::White>(move);
+    }
+    else
+    {
+        make_move<Player::Black>(move);
+    }
+}
+
+void Position::unmake_move(Move move)
+{
+    /*
+    The player to unmake is the one who isn't currently on move
+    */
+    if (current_player == Player::White)
+    {
+        unmake_move<Player::Black>(move);
+    }
+    else
+    {
+        unmake_move<Player::White>(move);
+    }
+}
+
+void Position::make_null_move()
+{
+    assert(undo_stack_size < MAX_UNDO_DEPTH);
+    auto &undo_record{undo_stack[undo_stack_size]};
+    ++undo_stack_size;
+    undo_record.is_capture = false;
+    undo_record.castling_rights = castling_rights;
+    undo_record.halfmove_clock = halfmove_clock;
+    undo_record.en_passant_bit_board = en_passant_bit_board;
+    undo_record.key = key;
+    undo_record.pawn_key = pawn_key;
+    undo_record.score = score;
+    undo_record.phase = phase;
+
+    halfmove_clock = 0;
+    key ^= Zobrist::get_en_passant_key(en_passant_bit_board);
+    en_passant_bit_board = 0;
+    key ^= Zobrist::get_black_to_move_key();
+    current_player = opponent_of(current_player);
+}
+
+void Position::unmake_null_move()
+{
+    --undo_stack_size;
+    const auto &undo_record{undo_stack[undo_stack_size]};
+    halfmove_clock = undo_record.halfmove_clock;
+    en_passant_bit_board = undo_record.en_passant_bit_board;
+    key = undo_record.key;
+    pawn_key = undo_record.pawn_key;
+    score = undo_record.score;
+    phase = undo_record.phase;
+    current_player = opponent_of(current_player);
+}
+
+std::size_t Position::get_undo_depth() const
+{
+    return undo_stack_size;
+}
+
+bool Position::has_non_pawn_material() const
+{
+    if (current_player == Player::White)
+    {
+        return white_bit_boards.has_non_pawn_material();
+    }
+
+    return black_bit_boards.has_non_pawn_material();
+}
+
+bool Position::is_draw() const
+{
+    if (halfmove_clock >= FIFTY_MOVE_RULE_PLIES)
+    {
+        return true;
     }
-    else if (current_player == Player::Black)
+
+    /*
+    Only positions since the last capture or pawn move with the same player to move can repeat
+    */
+    const auto num_reversible_plies{std::min<std::size_t>(halfmove_clock, undo_stack_size)};
+    for (std::size_t plies_back{2}; plies_back <= num_reversible_plies; plies_back += 2)
     {
-        BitBoard opponent_attacking_bit_board{0}; // TODO
-        const auto opponent_occupied_bit_board{white_bit_boards.get_occupied_bit_board()};
-        return black_bit_boards.get_moves(opponent_occupied_bit_board, opponent_attacking_bit_board);
+        if (undo_stack[undo_stack_size - plies_back].key == key)
+        {
+            return true;
+        }
     }
 
-    throw std::logic_error{"It was neither black nor white's turn"};
+    return false;
+}
+
+Player Position::get_current_player() const
+{
+    return current_player;
+}
+
+ZobristKey Position::get_key() const
+{
+    return key;
+}
+
+ZobristKey Position::get_pawn_key() const
+{
+    return pawn_key;
+}
+
+ZobristKey Position::compute_key() const
+{
+    auto computed_key{compute_player_key<Player::White>() ^ compute_player_key<Player::Black>()};
+    computed_key ^= Zobrist::get_castling_rights_key(castling_rights);
+    computed_key ^= Zobrist::get_en_passant_key(en_passant_bit_board);
+    if (current_player == Player::Black)
+    {
+        computed_key ^= Zobrist::get_black_to_move_key();
+    }
+
+    return computed_key;
+}
+
+ZobristKey Position::compute_pawn_key() const
+{
+    ZobristKey computed_pawn_key{0};
+    for (const auto player : {Player::White, Player::Black})
+    {
+        auto pawns_bit_board{player == Player::White ? white_bit_boards.get_piece_bit_board(Piece::Pawn)
+                                                     : black_bit_boards.get_piece_bit_board(Piece::Pawn)};
+        for (; pawns_bit_board; pawns_bit_board &= pawns_bit_board - 1)
+        {
+            const auto square{static_cast<SquareUnderlying>(std::countr_zero(pawns_bit_board))};
+            computed_pawn_key ^= Zobrist::get_piece_key(player, Piece::Pawn, square);
+        }
+    }
+
+    return computed_pawn_key;
+}
+
+PawnHashTableEntry Position::compute_pawn_hash_table_entry() const
+{
+    PawnHashTableEntry entry{};
+    entry.key = pawn_key;
+    entry.score = compute_pawn_structure_score<Player::White>();
+    entry.score -= compute_pawn_structure_score<Player::Black>();
+    entry.pawn_shields[Player::White] = white_bit_boards.get_pawn_shields();
+    entry.pawn_shields[Player::Black] = black_bit_boards.get_pawn_shields();
+
+    return entry;
+}
+
+void Position::compute_score_and_phase()
+{
+    score = {};
+    phase = 0;
+    add_player_score_and_phase<Player::White>();
+    add_player_score_and_phase<Player::Black>();
+}
+
+template <Player player> Evaluation Position::get_static_exchange_evaluation(Move move) const
+{
+    using Constants = BitBoardsConstants<player>;
+    const auto &self_bit_boards{get_bit_boards<player>()};
+    const auto &opponent_bit_boards{get_bit_boards<opponent_of(player)>()};
+    const auto self_occupied_bit_board{self_bit_boards.get_occupied_bit_board()};
+    const auto opponent_occupied_bit_board{opponent_bit_boards.get_occupied_bit_board()};
+
+    const auto to{move.get_to()};
+    const auto flag{move.get_flag()};
+    if (flag == MoveFlag::Castle)
+    {
+        return 0;
+    }
+
+    const auto from_bit_board{square_to_bit_board(Square{move.get_from()})};
+    const auto to_bit_board{square_to_bit_board(Square{to})};
+    auto occupied_bit_board{(self_occupied_bit_board | opponent_occupied_bit_board) ^ from_bit_board};
+
+    /*
+    Each gain is what the side making that capture has won so far, assuming nothing gets captured back
+    */
+    std::array<Evaluation, MAX_EXCHANGE_LENGTH> gains{};
+    if (flag == MoveFlag::EnPassant)
+    {
+        const auto captured_square{static_cast<SquareUnderlying>(to - Constants::PAWN_PUSH_DIRECTION)};
+        occupied_bit_board ^= square_to_bit_board(Square{captured_square});
+        gains[0] = BitBoards<player>::get_piece_value(Piece::Pawn);
+    }
+    else if (const auto captured_piece{opponent_bit_boards.find_piece(to_bit_board)}; captured_piece.has_value())
+    {
+        gains[0] = BitBoards<player>::get_piece_value(*captured_piece);
+    }
+
+    auto target_value{BitBoards<player>::get_piece_value(self_bit_boards.get_piece(from_bit_board))};
+    if (move.is_promotion())
+    {
+        target_value = BitBoards<player>::get_piece_value(move.get_promotion_piece());
+        gains[0] += target_value - BitBoards<player>::get_piece_value(Piece::Pawn);
+    }
+
+    std::size_t length{0};
+    auto is_opponent_to_capture{true};
+    while (length + 1 < MAX_EXCHANGE_LENGTH)
+    {
+        const auto attackers_bit_board{self_bit_boards.get_attackers_bit_board(to, occupied_bit_board) |
+                                       opponent_bit_boards.get_attackers_bit_board(to, occupied_bit_board)};
+        const auto capturing_occupied_bit_board{is_opponent_to_capture ? opponent_occupied_bit_board
+                                                                       : self_occupied_bit_board};
+        const auto capturers_bit_board{attackers_bit_board & capturing_occupied_bit_board};
+        if (!capturers_bit_board)
+        {
+            break;
+        }
+
+        ++length;
+        gains[length] = static_cast<Evaluation>(target_value - gains[length - 1]);
+
+        const auto [piece, piece_bit_board]{is_opponent_to_capture
+                                                ? opponent_bit_boards.get_least_valuable_piece(capturers_bit_board)
+                                                : self_bit_boards.get_least_valuable_piece(capturers_bit_board)};
+        if (piece == Piece::King && (attackers_bit_board & ~capturing_occupied_bit_board))
+        {
+            --length;
+            break;
+        }
+
+        occupied_bit_board ^= piece_bit_board;
+        target_value = BitBoards<player>::get_piece_value(piece);
+        is_opponent_to_capture = !is_opponent_to_capture;
+    }
+
+    /*
+    Work back from the end, where each side either makes its capture or stops if that would be worse
+    */
+    for (; length > 0; --length)
+    {
+        gains[length - 1] = static_cast<Evaluation>(-std::max<int>(-gains[length - 1], gains[length]));
+    }
+
+    return gains[0];
+}
+
+template <Player player> void Position::make_move(Move move)
+{
+    using Constants = BitBoardsConstants<player>;
+    auto &self_bit_boards{get_bit_boards<player>()};
+    auto &opponent_bit_boards{get_bit_boards<opponent_of(player)>()};
+
+    assert(undo_stack_size < MAX_UNDO_DEPTH);
+    auto &undo_record{undo_stack[undo_stack_size]};
+    ++undo_stack_size;
+    undo_record.is_capture = false;
+    undo_record.castling_rights = castling_rights;
+    undo_record.halfmove_clock = halfmove_clock;
+    undo_record.en_passant_bit_board = en_passant_bit_board;
+    undo_record.key = key;
+    undo_record.pawn_key = pawn_key;
+    undo_record.score = score;
+    undo_record.phase = phase;
+
+    const auto from{move.get_from()};
+    const auto to{move.get_to()};
+    const auto flag{move.get_flag()};
+    const auto from_bit_board{square_to_bit_board(Square{from})};
+    const auto to_bit_board{square_to_bit_board(Square{to})};
+    const auto piece{self_bit_boards.get_piece(from_bit_board)};
+
+    ++halfmove_clock;
+    if (flag == MoveFlag::EnPassant)
+    {
+        const auto captured_square{static_cast<SquareUnderlying>(to - Constants::PAWN_PUSH_DIRECTION)};
+        opponent_bit_boards.remove_piece(Piece::Pawn, square_to_bit_board(Square{captured_square}));
+        undo_record.is_capture = true;
+        undo_record.captured_piece = Piece::Pawn;
+        key ^= Zobrist::get_piece_key(opponent_of(player), Piece::Pawn, captured_square);
+        pawn_key ^= Zobrist::get_piece_key(opponent_of(player), Piece::Pawn, captured_square);
+        remove_piece_score(opponent_of(player), Piece::Pawn, captured_square);
+        remove_piece_features(opponent_of(player), Piece::Pawn, captured_square);
+    }
+    else if (const auto captured_piece{opponent_bit_boards.find_piece(to_bit_board)}; captured_piece.has_value())
+    {
+        opponent_bit_boards.remove_piece(*captured_piece, to_bit_board);
+        undo_record.is_capture = true;
+        undo_record.captured_piece = *captured_piece;
+        halfmove_clock = 0;
+        key ^= Zobrist::get_piece_key(opponent_of(player), *captured_piece, to);
+        if (*captured_piece == Piece::Pawn)
+        {
+            pawn_key ^= Zobrist::get_piece_key(opponent_of(player), Piece::Pawn, to);
+        }
+        remove_piece_score(opponent_of(player), *captured_piece, to);
+        remove_piece_features(opponent_of(player), *captured_piece, to);
+    }
+
+    if (move.is_promotion())
+    {
+        const auto promotion_piece{move.get_promotion_piece()};
+        self_bit_boards.remove_piece(Piece::Pawn, from_bit_board);
+        self_bit_boards.add_piece(promotion_piece, to_bit_board);
+        key ^= Zobrist::get_piece_key(player, Piece::Pawn, from);
+        key ^= Zobrist::get_piece_key(player, promotion_piece, to);
+        pawn_key ^= Zobrist::get_piece_key(player, Piece::Pawn, from);
+        remove_piece_score(player, Piece::Pawn, from);
+        add_piece_score(player, promotion_piece, to);
+        remove_piece_features(player, Piece::Pawn, from);
+        add_piece_features(player, promotion_piece, to);
+    }
+    else
+    {
+        self_bit_boards.move_piece(piece, from_bit_board | to_bit_board);
+        key ^= Zobrist::get_piece_key(player, piece, from);
+        key ^= Zobrist::get_piece_key(player, piece, to);
+        score -= PieceSquareTables::get_score(player, piece, from);
+        score += PieceSquareTables::get_score(player, piece, to);
+        move_piece_features(player, piece, from, to);
+    }
+
+    if (flag == MoveFlag::Castle)
+    {
+        const auto kingside{to == Constants::KINGSIDE_CASTLING_KING_TO};
+        const auto rook_from{kingside ? Constants::KINGSIDE_CASTLING_ROOK_FROM
+                                      : Constants::QUEENSIDE_CASTLING_ROOK_FROM};
+        const auto rook_to{kingside ? Constants::KINGSIDE_CASTLING_ROOK_TO : Constants::QUEENSIDE_CASTLING_ROOK_TO};
+        self_bit_boards.move_piece(Piece::Rook, square_to_bit_board(rook_from) | square_to_bit_board(rook_to));
+        key ^= Zobrist::get_piece_key(player, Piece::Rook, rook_from);
+        key ^= Zobrist::get_piece_key(player, Piece::Rook, rook_to);
+        score -= PieceSquareTables::get_score(player, Piece::Rook, rook_from);
+        score += PieceSquareTables::get_score(player, Piece::Rook, rook_to);
+        move_piece_features(player, Piece::Rook, rook_from, rook_to);
+    }
+
+    if (piece == Piece::Pawn)
+    {
+        halfmove_clock = 0;
+        if (!move.is_promotion())
+        {
+            pawn_key ^= Zobrist::get_piece_key(player, Piece::Pawn, from);
+            pawn_key ^= Zobrist::get_piece_key(player, Piece::Pawn, to);
+        }
+    }
+    else if (piece == Piece::King && nnue != nullptr)
+    {
+        refresh_features<player>();
+    }
+
+    key ^= Zobrist::get_en_passant_key(en_passant_bit_board);
+    en_passant_bit_board = 0;
+    if (flag == MoveFlag::DoublePush)
+    {
+        en_passant_bit_board = direction_shift<Constants::PAWN_PUSH_DIRECTION>(from_bit_board);
+        key ^= Zobrist::get_en_passant_key(en_passant_bit_board);
+    }
+
+    key ^= Zobrist::get_castling_rights_key(castling_rights);
+    castling_rights &= CASTLING_RIGHTS_MASK_LOOKUP[from] & CASTLING_RIGHTS_MASK_LOOKUP[to];
+    key ^= Zobrist::get_castling_rights_key(castling_rights);
+    key ^= Zobrist::get_black_to_move_key();
+
+    if constexpr (player == Player::Black)
+    {
+        ++fullmove_counter;
+    }
+    current_player = opponent_of(player);
+}
+
+template <Player player> void Position::unmake_move(Move move)
+{
+    using Constants = BitBoardsConstants<player>;
+    auto &self_bit_boards{get_bit_boards<player>()};
+    auto &opponent_bit_boards{get_bit_boards<opponent_of(player)>()};
+
+    --undo_stack_size;
+    const auto &undo_record{undo_stack[undo_stack_size]};
+
+    const auto from{move.get_from()};
+    const auto to{move.get_to()};
+    const auto flag{move.get_flag()};
+    const auto from_bit_board{square_to_bit_board(Square{from})};
+    const auto to_bit_board{square_to_bit_board(Square{to})};
+
+    const auto piece{move.is_promotion() ? Piece::Pawn : self_bit_boards.get_piece(to_bit_board)};
+    if (move.is_promotion())
+    {
+        const auto promotion_piece{move.get_promotion_piece()};
+        self_bit_boards.remove_piece(promotion_piece, to_bit_board);
+        self_bit_boards.add_piece(Piece::Pawn, from_bit_board);
+        remove_piece_features(player, promotion_piece, to);
+        add_piece_features(player, Piece::Pawn, from);
+    }
+    else
+    {
+        self_bit_boards.move_piece(piece, from_bit_board | to_bit_board);
+        move_piece_features(player, piece, to, from);
+    }
+
+    if (flag == MoveFlag::Castle)
+    {
+        const auto kingside{to == Constants::KINGSIDE_CASTLING_KING_TO};
+        const auto rook_from{kingside ? Constants::KINGSIDE_CASTLING_ROOK_FROM
+                                      : Constants::QUEENSIDE_CASTLING_ROOK_FROM};
+        const auto rook_to{kingside ? Constants::KINGSIDE_CASTLING_ROOK_TO : Constants::QUEENSIDE_CASTLING_ROOK_TO};
+        self_bit_boards.move_piece(Piece::Rook, square_to_bit_board(rook_from) | square_to_bit_board(rook_to));
+        move_piece_features(player, Piece::Rook, rook_to, rook_from);
+    }
+
+    if (flag == MoveFlag::EnPassant)
+    {
+        const auto captured_square{static_cast<SquareUnderlying>(to - Constants::PAWN_PUSH_DIRECTION)};
+        opponent_bit_boards.add_piece(Piece::Pawn, square_to_bit_board(Square{captured_square}));
+        add_piece_features(opponent_of(player), Piece::Pawn, captured_square);
+    }
+    else if (undo_record.is_capture)
+    {
+        opponent_bit_boards.add_piece(undo_record.captured_piece, to_bit_board);
+        add_piece_features(opponent_of(player), undo_record.captured_piece, to);
+    }
+
+    if (piece == Piece::King && nnue != nullptr)
+    {
+        refresh_features<player>();
+    }
+
+    castling_rights = undo_record.castling_rights;
+    halfmove_clock = undo_record.halfmove_clock;
+    en_passant_bit_board = undo_record.en_passant_bit_board;
+    key = undo_record.key;
+    pawn_key = undo_record.pawn_key;
+    score = undo_record.score;
+    phase = undo_record.phase;
+
+    if constexpr (player == Player::Black)
+    {
+        --fullmove_counter;
+    }
+    current_player = player;
 }
 
 std::ostream &operator<<(std::ostream &os, Position position)
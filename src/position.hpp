@@ -3,23 +3,447 @@
 #include "bit_board.hpp"
 #include "fen_parser.hpp"
 #include "move.hpp"
+#include "move_list.hpp"
+#include "nnue.hpp"
+#include "pawn_hash_table.hpp"
+#include "piece_square_tables.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
 
 class Position
 {
   public:
+    /*
+    Most moves that can be made without unmaking any, which is only asserted. Whatever makes moves on a position it
+    was handed has to check there's room left for them.
+    */
+    static constexpr std::size_t MAX_UNDO_DEPTH{1024};
+
     Position();
     Position(const FenParser &fen_parser);
 
     /*
-    Positive for white, negative for black
+    Throws if it isn't valid, as one read from a corrupt or foreign file might not be
+    */
+    Position(const PackedPosition &packed_position);
+
+    PackedPosition pack() const;
+
+    /*
+    Material and piece-square bonuses in centipawns, blended between the middlegame and endgame by how much material is
+    left, or the network's evaluation once one is set. Positive for white, negative for black.
+    */
+    Evaluation get_evaluation() const;
+
+    /*
+    Also scores the pawn structure, which is cached in the table. The network doesn't need it.
+    */
+    Evaluation get_evaluation(PawnHashTable &pawn_hash_table) const;
+
+    /*
+    Evaluates with the network from then on, or with the piece-square tables again if it's null. The network has to
+    outlive the position and every copy of it.
+    */
+    void set_nnue(const Nnue *new_nnue);
+    MoveList get_moves() const;
+    template <MoveSink Moves> void get_moves(Moves &moves) const;
+
+    /*
+    For generating moves in stages, so the check info is only worked out once for all of them
+    */
+    CheckInfo get_check_info() const;
+    template <MoveGeneration generation = MoveGeneration::AllMoves, MoveSink Moves>
+    void get_moves(Moves &moves, const CheckInfo &check_info) const;
+
+    /*
+    Whether a move from somewhere other than get_moves, like the transposition table, can be played here
+    */
+    bool is_legal(Move move, const CheckInfo &check_info) const;
+
+    /*
+    Empty for moves that don't capture anything
+    */
+    std::optional<Piece> get_captured_piece(Move move) const;
+
+    /*
+    The piece on the move's from square, which has to belong to the player to move
+    */
+    Piece get_moved_piece(Move move) const;
+
+    /*
+    Material the move wins in pawns once every capture back on its square has been played out, each side capturing with
+    its least valuable piece and free to stop whenever carrying on would lose more. Pieces lined up behind each other
+    join in as the ones in front leave, but pins are ignored.
+    */
+    Evaluation get_static_exchange_evaluation(Move move) const;
+
+    /*
+    Number of moves get_moves would produce, without building any of them
     */
-    Evaluation get_piece_difference() const;
-    std::vector<Move> get_moves() const;
+    std::size_t count_moves() const;
+
+    /*
+    Moves must be unmade in the reverse order that they were made
+    */
+    void make_move(Move move);
+    void unmake_move(Move move);
+
+    /*
+    Passes the turn. Positions from before the null move don't count as repetitions of ones after it, since passing
+    isn't a legal move.
+    */
+    void make_null_move();
+    void unmake_null_move();
+
+    /*
+    Moves made and not yet unmade, each holding a place on the undo stack
+    */
+    std::size_t get_undo_depth() const;
+
+    bool has_non_pawn_material() const;
+
+    /*
+    By the fifty move rule or by repeating any earlier position, which is as good as a draw for the search
+    */
+    bool is_draw() const;
+
+    Player get_current_player() const;
+    ZobristKey get_key() const;
+
+    /*
+    Only covers the pawns, so it stays the same while every other piece moves around
+    */
+    ZobristKey get_pawn_key() const;
 
   private:
+    /*
+    Everything make_move destroys that can't be recovered from the move itself. Trivial to construct, so the stack of
+    them doesn't have to be written when a position is.
+    */
+    struct UndoRecord
+    {
+        bool is_capture;
+        Piece captured_piece;
+        CastlingRightsUnderlying castling_rights;
+        std::uint8_t halfmove_clock;
+        BitBoard en_passant_bit_board;
+        ZobristKey key;
+        ZobristKey pawn_key;
+        TaperedScore score;
+        std::uint8_t phase;
+    };
+    static_assert(std::is_trivially_default_constructible_v<UndoRecord>);
+
+    static constexpr std::uint8_t FIFTY_MOVE_RULE_PLIES{100};
+
+    /*
+    Every capture takes a piece off the board, so an exchange can't be longer than this
+    */
+    static constexpr std::size_t MAX_EXCHANGE_LENGTH{32};
+
+    /*
+    By how far the pawn has got, from its own side
+    */
+    static constexpr std::array<TaperedScore, BOARD_WIDTH> PASSED_PAWN_BONUSES{
+        {{0, 0}, {0, 5}, {5, 10}, {10, 20}, {20, 40}, {35, 70}, {60, 110}, {0, 0}}};
+    static constexpr TaperedScore ISOLATED_PAWN_PENALTY{-10, -15};
+    static constexpr TaperedScore DOUBLED_PAWN_PENALTY{-10, -20};
+    static constexpr TaperedScore BACKWARD_PAWN_PENALTY{-8, -10};
+
+    /*
+    Per pawn in front of a king still on its back rank. Worthless once there's nothing left to attack the king with.
+    */
+    static constexpr TaperedScore PAWN_SHIELD_BONUS{10, 0};
+
+    static consteval Lookup<CastlingRightsUnderlying> create_castling_rights_mask_lookup();
+    static const Lookup<CastlingRightsUnderlying> CASTLING_RIGHTS_MASK_LOOKUP;
+
+    /*
+    Lets the public constructor unpack the pieces once for both players' bitboards
+    */
+    Position(const PackedPosition &packed_position, const PackedPosition::PieceBitBoards &piece_bit_boards);
+
+    template <Player player> BitBoards<player> &get_bit_boards();
+    template <Player player> const BitBoards<player> &get_bit_boards() const;
+
+    template <Player player> CheckInfo get_check_info() const;
+    template <Player player, MoveGeneration generation, MoveSink Moves>
+    void add_moves(Moves &moves, const CheckInfo &check_info) const;
+    template <Player player> Evaluation get_static_exchange_evaluation(Move move) const;
+    template <Player player> void make_move(Move move);
+    template <Player player> void unmake_move(Move move);
+
+    /*
+    Only used on construction, afterwards the key, score and phase are kept up to date incrementally
+    */
+    ZobristKey compute_key() const;
+    template <Player player> ZobristKey compute_player_key() const;
+    ZobristKey compute_pawn_key() const;
+    void compute_score_and_phase();
+    template <Player player> void add_player_score_and_phase();
+
+    PawnHashTableEntry compute_pawn_hash_table_entry() const;
+    template <Player player> TaperedScore compute_pawn_structure_score() const;
+    template <Player player> TaperedScore get_pawn_shield_score(const PawnHashTableEntry &entry) const;
+
+    /*
+    Keep the score and phase in step with a piece being put on or taken off the board
+    */
+    void add_piece_score(Player player, Piece piece, SquareUnderlying square);
+    void remove_piece_score(Player player, Piece piece, SquareUnderlying square);
+
+    /*
+    The same for the network's accumulator, which unmaking moves has to update in reverse since it's too big to keep a
+    copy of for every move. Kings aren't features, and moving one means its player's half has to be refreshed.
+    */
+    void add_piece_features(Player player, Piece piece, SquareUnderlying square);
+    void remove_piece_features(Player player, Piece piece, SquareUnderlying square);
+    void move_piece_features(Player player, Piece piece, SquareUnderlying from, SquareUnderlying to);
+    template <Player perspective> void refresh_features();
+    SquareUnderlying get_king_square(Player player) const;
+
     BitBoards<Player::White> white_bit_boards;
     BitBoards<Player::Black> black_bit_boards;
     Player current_player;
+    CastlingRightsUnderlying castling_rights;
+    BitBoard en_passant_bit_board;
+    std::uint8_t halfmove_clock;
+    std::uint16_t fullmove_counter;
+    ZobristKey key;
+    ZobristKey pawn_key;
+    TaperedScore score;
+    std::uint8_t phase;
+    const Nnue *nnue;
+    Nnue::Accumulator accumulator;
+
+    std::array<UndoRecord, MAX_UNDO_DEPTH> undo_stack;
+    std::size_t undo_stack_size;
 
     friend std::ostream &operator<<(std::ostream &os, Position position);
 };
+
+template <MoveSink Moves> void Position::get_moves(Moves &moves) const
+{
+    get_moves(moves, get_check_info());
+}
+
+inline CheckInfo Position::get_check_info() const
+{
+    if (current_player == Player::White)
+    {
+        return get_check_info<Player::White>();
+    }
+    else if (current_player == Player::Black)
+    {
+        return get_check_info<Player::Black>();
+    }
+
+    throw std::logic_error{"It was neither black nor white's turn"};
+}
+
+template <MoveGeneration generation, MoveSink Moves>
+void Position::get_moves(Moves &moves, const CheckInfo &check_info) const
+{
+    if (current_player == Player::White)
+    {
+        add_moves<Player::White, generation>(moves, check_info);
+    }
+    else if (current_player == Player::Black)
+    {
+        add_moves<Player::Black, generation>(moves, check_info);
+    }
+    else
+    {
+        throw std::logic_error{"It was neither black nor white's turn"};
+    }
+}
+
+template <Player player> inline BitBoards<player> &Position::get_bit_boards()
+{
+    if constexpr (player == Player::White)
+    {
+        return white_bit_boards;
+    }
+    else
+    {
+        return black_bit_boards;
+    }
+}
+
+template <Player player> inline const BitBoards<player> &Position::get_bit_boards() const
+{
+    if constexpr (player == Player::White)
+    {
+        return white_bit_boards;
+    }
+    else
+    {
+        return black_bit_boards;
+    }
+}
+
+template <Player player> ZobristKey Position::compute_player_key() const
+{
+    ZobristKey player_key{0};
+    const auto &bit_boards{get_bit_boards<player>()};
+    for (SquareUnderlying square{0}; square < BOARD_SQUARES; ++square)
+    {
+        const auto piece{bit_boards.find_piece(square_to_bit_board(Square{square}))};
+        if (piece.has_value())
+        {
+            player_key ^= Zobrist::get_piece_key(player, *piece, square);
+        }
+    }
+
+    return player_key;
+}
+
+template <Player player> void Position::add_player_score_and_phase()
+{
+    const auto &bit_boards{get_bit_boards<player>()};
+    for (SquareUnderlying square{0}; square < BOARD_SQUARES; ++square)
+    {
+        const auto piece{bit_boards.find_piece(square_to_bit_board(Square{square}))};
+        if (piece.has_value())
+        {
+            add_piece_score(player, *piece, square);
+        }
+    }
+}
+
+inline void Position::add_piece_score(Player player, Piece piece, SquareUnderlying square)
+{
+    score += PieceSquareTables::get_score(player, piece, square);
+    phase = static_cast<std::uint8_t>(phase + PieceSquareTables::get_phase(piece));
+}
+
+inline void Position::remove_piece_score(Player player, Piece piece, SquareUnderlying square)
+{
+    score -= PieceSquareTables::get_score(player, piece, square);
+    phase = static_cast<std::uint8_t>(phase - PieceSquareTables::get_phase(piece));
+}
+
+inline void Position::add_piece_features(Player player, Piece piece, SquareUnderlying square)
+{
+    if (nnue == nullptr || piece == Piece::King)
+    {
+        return;
+    }
+
+    for (const auto perspective : {Player::White, Player::Black})
+    {
+        nnue->add_feature(accumulator.perspectives[perspective],
+                          Nnue::get_feature_idx(perspective, get_king_square(perspective), player, piece, square));
+    }
+}
+
+inline void Position::remove_piece_features(Player player, Piece piece, SquareUnderlying square)
+{
+    if (nnue == nullptr || piece == Piece::King)
+    {
+        return;
+    }
+
+    for (const auto perspective : {Player::White, Player::Black})
+    {
+        nnue->remove_feature(accumulator.perspectives[perspective],
+                             Nnue::get_feature_idx(perspective, get_king_square(perspective), player, piece, square));
+    }
+}
+
+inline void Position::move_piece_features(Player player, Piece piece, SquareUnderlying from, SquareUnderlying to)
+{
+    if (nnue == nullptr || piece == Piece::King)
+    {
+        return;
+    }
+
+    for (const auto perspective : {Player::White, Player::Black})
+    {
+        const auto king_square{get_king_square(perspective)};
+        nnue->move_feature(accumulator.perspectives[perspective],
+                           Nnue::get_feature_idx(perspective, king_square, player, piece, from),
+                           Nnue::get_feature_idx(perspective, king_square, player, piece, to));
+    }
+}
+
+template <Player perspective> void Position::refresh_features()
+{
+    auto &values{accumulator.perspectives[perspective]};
+    nnue->reset_features(values);
+
+    const auto &const_white_bit_boards{white_bit_boards};
+    const auto &const_black_bit_boards{black_bit_boards};
+    const auto king_square{get_king_square(perspective)};
+    for (const auto player : {Player::White, Player::Black})
+    {
+        for (const auto piece : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen})
+        {
+            auto pieces_bit_board{player == Player::White ? const_white_bit_boards.get_piece_bit_board(piece)
+                                                          : const_black_bit_boards.get_piece_bit_board(piece)};
+            for (; pieces_bit_board; pieces_bit_board &= pieces_bit_board - 1)
+            {
+                const auto square{static_cast<SquareUnderlying>(std::countr_zero(pieces_bit_board))};
+                nnue->add_feature(values, Nnue::get_feature_idx(perspective, king_square, player, piece, square));
+            }
+        }
+    }
+}
+
+inline SquareUnderlying Position::get_king_square(Player player) const
+{
+    const auto king_bit_board{player == Player::White ? white_bit_boards.get_king_bit_board()
+                                                      : black_bit_boards.get_king_bit_board()};
+
+    return static_cast<SquareUnderlying>(std::countr_zero(king_bit_board));
+}
+
+template <Player player> TaperedScore Position::compute_pawn_structure_score() const
+{
+    const auto &bit_boards{get_bit_boards<player>()};
+    const auto pawn_structure{bit_boards.get_pawn_structure(get_bit_boards<opponent_of(player)>())};
+
+    TaperedScore pawn_structure_score{};
+    pawn_structure_score += ISOLATED_PAWN_PENALTY * std::popcount(pawn_structure.isolated_bit_board);
+    pawn_structure_score += DOUBLED_PAWN_PENALTY * std::popcount(pawn_structure.doubled_bit_board);
+    pawn_structure_score += BACKWARD_PAWN_PENALTY * std::popcount(pawn_structure.backward_bit_board);
+    for (auto passed_bit_board{pawn_structure.passed_bit_board}; passed_bit_board;
+         passed_bit_board &= passed_bit_board - 1)
+    {
+        const auto rank{square_to_rank(Square(std::countr_zero(passed_bit_board)))};
+        pawn_structure_score += PASSED_PAWN_BONUSES[player == Player::White ? rank : BOARD_WIDTH - 1 - rank];
+    }
+
+    return pawn_structure_score;
+}
+
+template <Player player> TaperedScore Position::get_pawn_shield_score(const PawnHashTableEntry &entry) const
+{
+    const auto king_bit_board{get_bit_boards<player>().get_king_bit_board()};
+    if (!(king_bit_board & BitBoardsConstants<player>::BACK_RANK_BIT_BOARD))
+    {
+        return {};
+    }
+
+    const auto king_file{square_to_file(Square(std::countr_zero(king_bit_board)))};
+
+    return PAWN_SHIELD_BONUS * entry.pawn_shields[player][king_file];
+}
+
+template <Player player> CheckInfo Position::get_check_info() const
+{
+    return get_bit_boards<player>().get_check_info(get_bit_boards<opponent_of(player)>());
+}
+
+template <Player player, MoveGeneration generation, MoveSink Moves>
+void Position::add_moves(Moves &moves, const CheckInfo &check_info) const
+{
+    get_bit_boards<player>().template get_moves<generation>(
+        moves, get_bit_boards<opponent_of(player)>().get_occupied_bit_board(), check_info, en_passant_bit_board,
+        castling_rights);
+}
@@ -0,0 +1,621 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <stdexcept>
+
+double SearchResult::get_nodes_per_second() const
+{
+    return elapsed.count() > 0 ? static_cast<double>(nodes) / elapsed.count() : 0;
+}
+
+double SearchResult::get_first_move_cutoff_rate() const
+{
+    return beta_cutoffs ? static_cast<double>(first_move_beta_cutoffs) / static_cast<double>(beta_cutoffs) : 0;
+}
+
+double SearchResult::get_pawn_hash_hit_rate() const
+{
+    return pawn_hash_probes ? static_cast<double>(pawn_hash_hits) / static_cast<double>(pawn_hash_probes) : 0;
+}
+
+consteval Lookup<Lookup<std::uint8_t>> Search::create_late_move_reductions_lookup()
+{
+    Lookup<Lookup<std::uint8_t>> late_move_reductions_lookup{};
+    for (unsigned depth{1}; depth < BOARD_SQUARES; ++depth)
+    {
+        for (unsigned move_number{1}; move_number < BOARD_SQUARES; ++move_number)
+        {
+            const auto log_depth{std::bit_width(depth) - 1};
+            const auto log_move_number{std::bit_width(move_number) - 1};
+            late_move_reductions_lookup[depth][move_number] =
+                static_cast<std::uint8_t>(1 + log_depth * log_move_number / REDUCTION_DIVISOR);
+        }
+    }
+
+    return late_move_reductions_lookup;
+}
+
+constexpr Lookup<Lookup<std::uint8_t>> Search::LATE_MOVE_REDUCTIONS_LOOKUP{create_late_move_reductions_lookup()};
+
+Search::Search(TranspositionTable &transposition_table) : Search{transposition_table, own_signals, 0}
+{
+}
+
+Search::Search(TranspositionTable &transposition_table, SearchSignals &shared_signals, std::size_t thread_idx)
+    : transposition_table{transposition_table}, own_signals{}, signals{shared_signals}, thread_idx{thread_idx},
+      options{}, position{}, limits{}, start_time{}, root_depth{0}, nodes{0}, flushed_nodes{0},
+      next_limits_check_nodes{0}, stopped{false}, beta_cutoffs{0}, first_move_beta_cutoffs{0}, principal_variations{},
+      principal_variation_lengths{}, killer_moves{}, move_history{}, pawn_hash_table{},
+      played_moves{}
+{
+}
+
+void Search::set_options(const SearchOptions &options)
+{
+    this->options = options;
+}
+
+SearchResult Search::search(const Position &root_position, const SearchLimits &limits, const Report &report)
+{
+    check_root_position(root_position);
+
+    position = root_position;
+    this->limits = limits;
+    start_time = std::chrono::steady_clock::now();
+    nodes = 0;
+    flushed_nodes = 0;
+    next_limits_check_nodes = 0;
+    stopped = false;
+    beta_cutoffs = 0;
+    first_move_beta_cutoffs = 0;
+    killer_moves = {};
+    move_history.clear();
+    pawn_hash_table.clear_statistics();
+
+    /*
+    When the signals are shared, whoever started the threads resets them and the table
+    */
+    if (&signals == &own_signals)
+    {
+        signals.stop = false;
+        signals.nodes = 0;
+        transposition_table.new_search();
+    }
+
+    SearchResult result{std::nullopt, 0, 0, {}, 0, {}, 0, 0, 0, 0};
+    const auto max_depth{std::min(limits.depth.value_or(MAX_PLY - 1), static_cast<std::uint8_t>(MAX_PLY - 1))};
+    for (std::uint8_t depth{1}; depth <= max_depth; ++depth)
+    {
+        if (should_skip_depth(depth))
+        {
+            continue;
+        }
+
+        root_depth = depth;
+        const auto score{search_aspiration_window(depth, result.score)};
+        if (stopped)
+        {
+            break;
+        }
+
+        result.score = score;
+        result.depth = depth;
+        result.principal_variation.assign(principal_variations[0].begin(),
+                                          principal_variations[0].begin() + principal_variation_lengths[0]);
+        result.best_move = result.principal_variation.empty()
+                               ? std::nullopt
+                               : std::optional<Move>{result.principal_variation.front()};
+        result.nodes = flush_nodes();
+        result.elapsed = std::chrono::steady_clock::now() - start_time;
+        result.beta_cutoffs = beta_cutoffs;
+        result.first_move_beta_cutoffs = first_move_beta_cutoffs;
+        result.pawn_hash_probes = pawn_hash_table.get_statistics().probes;
+        result.pawn_hash_hits = pawn_hash_table.get_statistics().hits;
+
+        if (report)
+        {
+            report(result);
+        }
+
+        /*
+        No legal moves, so deeper iterations would all say the same
+        */
+        if (!result.best_move.has_value())
+        {
+            break;
+        }
+    }
+
+    result.nodes = flush_nodes();
+    result.elapsed = std::chrono::steady_clock::now() - start_time;
+    result.beta_cutoffs = beta_cutoffs;
+    result.first_move_beta_cutoffs = first_move_beta_cutoffs;
+    result.pawn_hash_probes = pawn_hash_table.get_statistics().probes;
+    result.pawn_hash_hits = pawn_hash_table.get_statistics().hits;
+
+    return result;
+}
+
+void Search::check_root_position(const Position &root_position)
+{
+    if (root_position.get_undo_depth() + MAX_PLY > Position::MAX_UNDO_DEPTH)
+    {
+        throw std::logic_error{"Root position has too many moves behind it to search from"};
+    }
+}
+
+Evaluation Search::search_aspiration_window(std::uint8_t depth, Evaluation previous_score)
+{
+    if (depth < MIN_ASPIRATION_DEPTH)
+    {
+        return search_node(-INFINITE_SCORE, INFINITE_SCORE, depth, 0);
+    }
+
+    auto window{ASPIRATION_WINDOW};
+    auto alpha{static_cast<Evaluation>(std::max<int>(previous_score - window, -INFINITE_SCORE))};
+    auto beta{static_cast<Evaluation>(std::min<int>(previous_score + window, INFINITE_SCORE))};
+    while (true)
+    {
+        const auto score{search_node(alpha, beta, depth, 0)};
+        if (stopped)
+        {
+            return score;
+        }
+
+        if (score <= alpha)
+        {
+            alpha = static_cast<Evaluation>(std::max<int>(score - window, -INFINITE_SCORE));
+        }
+        else if (score >= beta)
+        {
+            beta = static_cast<Evaluation>(std::min<int>(score + window, INFINITE_SCORE));
+        }
+        else
+        {
+            return score;
+        }
+
+        window = static_cast<Evaluation>(std::min<int>(2 * window, INFINITE_SCORE));
+    }
+}
+
+Evaluation Search::search_node(Evaluation alpha, Evaluation beta, int depth, std::uint8_t ply)
+{
+    if (depth <= 0)
+    {
+        return search_quiescence(alpha, beta, ply);
+    }
+
+    ++nodes;
+    principal_variation_lengths[ply] = 0;
+    if (ply >= MAX_PLY - 1)
+    {
+        return evaluate();
+    }
+
+    if (should_stop())
+    {
+        return 0;
+    }
+
+    const auto is_root{ply == 0};
+    if (!is_root && position.is_draw())
+    {
+        return 0;
+    }
+
+    /*
+    A null window means every move is only being checked against a bound, so nothing here can join the principal
+    variation and a hash table bound is good enough to stop on
+    */
+    const auto is_principal_variation{beta - alpha > 1};
+    const auto key{position.get_key()};
+    const auto entry{transposition_table.probe(key)};
+    std::optional<Move> hash_move{};
+    if (entry.has_value())
+    {
+        hash_move = entry->move;
+
+        const auto entry_score{score_from_transposition_table(entry->score, ply)};
+        if (!is_principal_variation && entry->depth >= depth &&
+            (entry->bound == Bound::ExactBound || (entry->bound == Bound::LowerBound && entry_score >= beta) ||
+             (entry->bound == Bound::UpperBound && entry_score <= alpha)))
+        {
+            return entry_score;
+        }
+    }
+
+    const auto check_info{position.get_check_info()};
+    const auto is_in_check{check_info.checkers_bit_board != 0};
+    const auto static_evaluation{evaluate()};
+    const auto previous_move{is_root ? Move{} : played_moves[ply - 1]};
+
+    if (!is_principal_variation && !is_in_check)
+    {
+        /*
+        Material can't be weighed against a mate, so neither kind of futility applies while one is being proven
+        */
+        if (options.use_reverse_futility_pruning && depth <= MAX_REVERSE_FUTILITY_DEPTH &&
+            std::abs(beta) < MATE_BOUND && static_evaluation - REVERSE_FUTILITY_MARGIN * depth >= beta)
+        {
+            return static_evaluation;
+        }
+
+        /*
+        Never twice in a row, since that just searches the same position shallower
+        */
+        if (options.use_null_move_pruning && depth >= MIN_NULL_MOVE_DEPTH && !is_root && previous_move != Move{} &&
+            static_evaluation >= beta && position.has_non_pawn_material())
+        {
+            const auto reduction{NULL_MOVE_REDUCTION + depth / NULL_MOVE_DEPTH_DIVISOR};
+            played_moves[ply] = Move{};
+            position.make_null_move();
+            const auto score{static_cast<Evaluation>(-search_node(-beta, -beta + 1, depth - 1 - reduction, ply + 1))};
+            position.unmake_null_move();
+
+            if (stopped)
+            {
+                return 0;
+            }
+
+            /*
+            A mate found after passing isn't a real one
+            */
+            if (score >= beta)
+            {
+                return score >= MATE_BOUND ? beta : score;
+            }
+        }
+    }
+
+    const auto can_prune_quiet_moves{options.use_futility_pruning && !is_principal_variation && !is_in_check &&
+                                     depth <= MAX_FUTILITY_DEPTH && std::abs(alpha) < MATE_BOUND &&
+                                     static_evaluation + FUTILITY_MARGIN * depth <= alpha};
+    const auto countermove{previous_move != Move{} ? move_history.get_countermove(previous_move) : Move{}};
+    MovePicker move_picker{position, check_info, move_history, hash_move, killer_moves[ply], countermove};
+
+    const auto original_alpha{alpha};
+    Evaluation best_score{-INFINITE_SCORE};
+    std::optional<Move> best_move{};
+    std::size_t num_moves{0};
+    MoveList searched_quiet_moves{};
+    while (const auto move{move_picker.next()})
+    {
+        const auto is_quiet{!move->is_promotion() && !position.get_captured_piece(*move).has_value()};
+        ++num_moves;
+
+        /*
+        The first move is always searched, so there's a score to return even if every other move is pruned
+        */
+        if (can_prune_quiet_moves && is_quiet && num_moves > 1)
+        {
+            continue;
+        }
+
+        const auto reduction{
+            !is_in_check && is_quiet ? get_late_move_reduction(*move, depth, num_moves, is_principal_variation) : 0};
+
+        played_moves[ply] = *move;
+        position.make_move(*move);
+        transposition_table.prefetch(position.get_key());
+
+        /*
+        The first move is expected to be best, so the rest only have to prove they aren't with a null window, and are
+        searched again properly if that fails. Late quiet moves first try to prove it with a shallower search.
+        */
+        Evaluation score{0};
+        if (num_moves == 1)
+        {
+            score = -search_node(-beta, -alpha, depth - 1, ply + 1);
+        }
+        else
+        {
+            score = -search_node(-alpha - 1, -alpha, depth - 1 - reduction, ply + 1);
+            if (score > alpha && reduction)
+            {
+                score = -search_node(-alpha - 1, -alpha, depth - 1, ply + 1);
+            }
+            if (score > alpha && score < beta)
+            {
+                score = -search_node(-beta, -alpha, depth - 1, ply + 1);
+            }
+        }
+        position.unmake_move(*move);
+
+        if (stopped)
+        {
+            return 0;
+        }
+
+        if (score > best_score)
+        {
+            best_score = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                best_move = move;
+                update_principal_variation(*move, ply);
+
+                if (score >= beta)
+                {
+                    ++beta_cutoffs;
+                    if (num_moves == 1)
+                    {
+                        ++first_move_beta_cutoffs;
+                    }
+                    if (is_quiet)
+                    {
+                        update_quiet_move_history(*move, searched_quiet_moves, depth, ply);
+                    }
+                    break;
+                }
+            }
+        }
+
+        if (is_quiet)
+        {
+            searched_quiet_moves.push_back(*move);
+        }
+    }
+
+    if (!num_moves)
+    {
+        return check_info.checkers_bit_board ? static_cast<Evaluation>(-MATE_SCORE + ply) : 0;
+    }
+
+    auto bound{Bound::UpperBound};
+    if (best_score >= beta)
+    {
+        bound = Bound::LowerBound;
+    }
+    else if (best_score > original_alpha)
+    {
+        bound = Bound::ExactBound;
+    }
+
+    /*
+    Keep the old move when nothing beat alpha, since it's still a better guess than none
+    */
+    transposition_table.store(key, TranspositionTableEntry{best_move.value_or(hash_move.value_or(Move{})),
+                                                           score_to_transposition_table(best_score, ply),
+                                                           static_evaluation, static_cast<std::uint8_t>(depth),
+                                                           bound});
+
+    return best_score;
+}
+
+int Search::get_late_move_reduction(Move move, int depth, std::size_t move_number, bool is_principal_variation) const
+{
+    if (!options.use_late_move_reductions || depth < MIN_REDUCTION_DEPTH || move_number < MIN_REDUCTION_MOVES)
+    {
+        return 0;
+    }
+
+    const auto history_score{move_history.get_history_score(position.get_current_player(), move)};
+    const auto reduction{LATE_MOVE_REDUCTIONS_LOOKUP[std::min<int>(depth, BOARD_SQUARES - 1)]
+                                                    [std::min<std::size_t>(move_number, BOARD_SQUARES - 1)] -
+                         history_score / HISTORY_REDUCTION_DIVISOR - is_principal_variation};
+
+    /*
+    Principal variation nodes are reduced a ply less since their score matters, and nothing is reduced straight into
+    quiescence search
+    */
+    return std::clamp(reduction, 0, depth - 2);
+}
+
+Evaluation Search::search_quiescence(Evaluation alpha, Evaluation beta, std::uint8_t ply)
+{
+    ++nodes;
+    principal_variation_lengths[ply] = 0;
+    if (ply >= MAX_PLY - 1)
+    {
+        return evaluate();
+    }
+
+    if (should_stop())
+    {
+        return 0;
+    }
+
+    if (position.is_draw())
+    {
+        return 0;
+    }
+
+    /*
+    Out of check the side to move can always stand pat instead of capturing. In check every evasion is searched, so
+    mates at the horizon are still found.
+    */
+    const auto check_info{position.get_check_info()};
+    const auto is_in_check{check_info.checkers_bit_board != 0};
+    Evaluation best_score{-INFINITE_SCORE};
+    if (!is_in_check)
+    {
+        best_score = evaluate();
+        if (best_score >= beta)
+        {
+            return best_score;
+        }
+        alpha = std::max(alpha, best_score);
+    }
+
+    MovePicker move_picker{position, check_info, move_history};
+    std::size_t num_moves{0};
+    while (const auto move{move_picker.next()})
+    {
+        ++num_moves;
+        if (!is_in_check && position.get_static_exchange_evaluation(*move) < 0)
+        {
+            continue;
+        }
+
+        position.make_move(*move);
+        const auto score{static_cast<Evaluation>(-search_quiescence(-beta, -alpha, ply + 1))};
+        position.unmake_move(*move);
+
+        if (stopped)
+        {
+            return 0;
+        }
+
+        if (score > best_score)
+        {
+            best_score = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                if (score >= beta)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (is_in_check && !num_moves)
+    {
+        return static_cast<Evaluation>(-MATE_SCORE + ply);
+    }
+
+    return best_score;
+}
+
+Evaluation Search::evaluate()
+{
+    const auto score{position.get_evaluation(pawn_hash_table)};
+
+    return position.get_current_player() == Player::White ? score : static_cast<Evaluation>(-score);
+}
+
+bool Search::should_stop()
+{
+    if (nodes < next_limits_check_nodes)
+    {
+        return stopped;
+    }
+    next_limits_check_nodes = nodes + NODES_PER_LIMITS_CHECK;
+    const auto total_nodes{flush_nodes()};
+
+    /*
+    The main thread's first iteration always finishes so there's a move to play
+    */
+    if (is_main_thread())
+    {
+        const auto is_out_of_nodes{limits.nodes.has_value() && total_nodes >= *limits.nodes};
+        const auto is_out_of_time{limits.time.has_value() &&
+                                  std::chrono::steady_clock::now() - start_time >= *limits.time};
+        if (root_depth > 1 && (is_out_of_nodes || is_out_of_time))
+        {
+            signals.stop.store(true, std::memory_order_relaxed);
+            stopped = true;
+        }
+    }
+    else
+    {
+        stopped = signals.stop.load(std::memory_order_relaxed);
+    }
+
+    return stopped;
+}
+
+std::uint64_t Search::flush_nodes()
+{
+    const auto total_nodes{signals.nodes.fetch_add(nodes - flushed_nodes, std::memory_order_relaxed) + nodes -
+                           flushed_nodes};
+    flushed_nodes = nodes;
+
+    return total_nodes;
+}
+
+bool Search::is_main_thread() const
+{
+    return thread_idx == 0;
+}
+
+bool Search::should_skip_depth(std::uint8_t depth) const
+{
+    if (is_main_thread())
+    {
+        return false;
+    }
+
+    const auto skip_idx{(thread_idx - 1) % NUM_HELPER_SKIPS};
+
+    return ((depth + HELPER_SKIP_PHASES[skip_idx]) / HELPER_SKIP_SIZES[skip_idx]) % 2;
+}
+
+void Search::update_principal_variation(Move move, std::uint8_t ply)
+{
+    auto &principal_variation{principal_variations[ply]};
+    const auto &child_principal_variation{principal_variations[ply + 1]};
+    const auto child_length{principal_variation_lengths[ply + 1]};
+
+    principal_variation[0] = move;
+    std::copy(child_principal_variation.begin(), child_principal_variation.begin() + child_length,
+              principal_variation.begin() + 1);
+    principal_variation_lengths[ply] = child_length + 1;
+}
+
+void Search::update_killer_moves(Move move, std::uint8_t ply)
+{
+    auto &ply_killer_moves{killer_moves[ply]};
+    if (ply_killer_moves[0] != move)
+    {
+        std::copy_backward(ply_killer_moves.begin(), ply_killer_moves.end() - 1, ply_killer_moves.end());
+        ply_killer_moves[0] = move;
+    }
+}
+
+void Search::update_quiet_move_history(Move move, const MoveList &searched_quiet_moves, int depth, std::uint8_t ply)
+{
+    if (options.use_killer_moves)
+    {
+        update_killer_moves(move, ply);
+    }
+
+    if (options.use_history)
+    {
+        const auto player{position.get_current_player()};
+        const auto bonus{std::min(depth * depth, MAX_HISTORY_BONUS)};
+        move_history.update_history_score(player, move, bonus);
+        for (const auto searched_quiet_move : searched_quiet_moves)
+        {
+            move_history.update_history_score(player, searched_quiet_move, -bonus);
+        }
+    }
+
+    if (options.use_countermoves && ply > 0 && played_moves[ply - 1] != Move{})
+    {
+        move_history.set_countermove(played_moves[ply - 1], move);
+    }
+}
+
+Evaluation Search::score_to_transposition_table(Evaluation score, std::uint8_t ply)
+{
+    if (score >= MATE_BOUND)
+    {
+        return static_cast<Evaluation>(score + ply);
+    }
+    else if (score <= -MATE_BOUND)
+    {
+        return static_cast<Evaluation>(score - ply);
+    }
+
+    return score;
+}
+
+Evaluation Search::score_from_transposition_table(Evaluation score, std::uint8_t ply)
+{
+    if (score >= MATE_BOUND)
+    {
+        return static_cast<Evaluation>(score - ply);
+    }
+    else if (score <= -MATE_BOUND)
+    {
+        return static_cast<Evaluation>(score + ply);
+    }
+
+    return score;
+}
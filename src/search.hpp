@@ -0,0 +1,255 @@
+#pragma once
+
+#include "move.hpp"
+#include "move_history.hpp"
+#include "move_list.hpp"
+#include "move_picker.hpp"
+#include "pawn_hash_table.hpp"
+#include "position.hpp"
+#include "transposition_table.hpp"
+#include "types.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+/*
+Whichever limit is reached first stops the search. With none set it only stops at the maximum depth.
+*/
+struct SearchLimits
+{
+    std::optional<std::uint8_t> depth;
+    std::optional<std::uint64_t> nodes;
+    std::optional<std::chrono::milliseconds> time;
+};
+
+/*
+Heuristics that can be switched off to measure what they're worth
+*/
+struct SearchOptions
+{
+    bool use_killer_moves{true};
+    bool use_history{true};
+    bool use_countermoves{true};
+    bool use_null_move_pruning{true};
+    bool use_late_move_reductions{true};
+    bool use_reverse_futility_pruning{true};
+    bool use_futility_pruning{true};
+};
+
+/*
+From the last fully searched iteration
+*/
+struct SearchResult
+{
+    std::optional<Move> best_move;
+    Evaluation score;
+    std::uint8_t depth;
+    std::vector<Move> principal_variation;
+
+    /*
+    Counted over every iteration, including one that was cut short
+    */
+    std::uint64_t nodes;
+    std::chrono::duration<double> elapsed;
+
+    /*
+    Outside quiescence search. The share of cutoffs made by the first move searched is how good the move ordering is.
+    */
+    std::uint64_t beta_cutoffs;
+    std::uint64_t first_move_beta_cutoffs;
+
+    /*
+    Probes of the thread's pawn hash table, which hits for most positions since pawns rarely move
+    */
+    std::uint64_t pawn_hash_probes;
+    std::uint64_t pawn_hash_hits;
+
+    double get_nodes_per_second() const;
+    double get_first_move_cutoff_rate() const;
+    double get_pawn_hash_hit_rate() const;
+};
+
+/*
+Shared by every thread searching the same root. Threads only touch it every few thousand nodes, so it's never
+contended.
+*/
+struct SearchSignals
+{
+    std::atomic<bool> stop;
+    std::atomic<std::uint64_t> nodes;
+};
+
+/*
+Iterative deepening principal variation search. Every iteration after the first few starts with an aspiration window
+around the previous score. Scores are fail-soft and from the point of view of the player to move.
+
+Everything a node needs lives on the stack or in fixed size tables owned by the search, so nothing is allocated below
+the root.
+*/
+class Search
+{
+  public:
+    /*
+    Called after every completed iteration
+    */
+    using Report = std::function<void(const SearchResult &)>;
+
+    static constexpr std::uint8_t MAX_PLY{128};
+    static constexpr Evaluation MATE_SCORE{30000};
+    static constexpr Evaluation INFINITE_SCORE{MATE_SCORE + 1};
+
+    /*
+    Any score at least this far from zero is a forced mate
+    */
+    static constexpr Evaluation MATE_BOUND{MATE_SCORE - MAX_PLY};
+
+    explicit Search(TranspositionTable &transposition_table);
+
+    /*
+    One of several threads searching the same root, which only communicate through the transposition table and the
+    signals. Thread 0 is the main thread, which is the only one that checks the limits and the only one guaranteed to
+    finish its first iteration. The others skip some depths so they're spread over more of the tree.
+    */
+    Search(TranspositionTable &transposition_table, SearchSignals &shared_signals, std::size_t thread_idx);
+
+    void set_options(const SearchOptions &options);
+
+    /*
+    Throws if the root can't be searched from, see check_root_position
+    */
+    SearchResult search(const Position &root_position, const SearchLimits &limits, const Report &report = {});
+
+    /*
+    Throws if the root's undo stack doesn't have room for the MAX_PLY moves a search can make on top of it
+    */
+    static void check_root_position(const Position &root_position);
+
+  private:
+    /*
+    Aspiration windows start at this many centipawns either side of the previous score, and double every time the
+    score falls outside
+    */
+    static constexpr Evaluation ASPIRATION_WINDOW{25};
+    static constexpr std::uint8_t MIN_ASPIRATION_DEPTH{4};
+
+    /*
+    History bonuses grow with the square of the depth, since a cutoff high in the tree saves far more work
+    */
+    static constexpr int MAX_HISTORY_BONUS{1024};
+
+    /*
+    Passing and still failing high with a reduced search means the position is good enough to not need a full one
+    */
+    static constexpr int MIN_NULL_MOVE_DEPTH{3};
+    static constexpr int NULL_MOVE_REDUCTION{3};
+    static constexpr int NULL_MOVE_DEPTH_DIVISOR{6};
+
+    /*
+    Quiet moves late in the ordering are searched shallower first, by 1 + floor(log2 depth) * floor(log2 move number)
+    / 4 plies with the division rounding down. That is 1 ply at depth 3 before the sixteenth move and at least 2 from
+    depth 4. Moves with a good history are cut less.
+    */
+    static constexpr int MIN_REDUCTION_DEPTH{3};
+    static constexpr std::size_t MIN_REDUCTION_MOVES{4};
+    static constexpr int REDUCTION_DIVISOR{4};
+    static constexpr int HISTORY_REDUCTION_DIVISOR{8192};
+
+    /*
+    Near the leaves, a static evaluation this many centipawns per ply above beta is trusted to fail high, and one this
+    far below alpha is trusted to make quiet moves pointless
+    */
+    static constexpr int MAX_REVERSE_FUTILITY_DEPTH{6};
+    static constexpr Evaluation REVERSE_FUTILITY_MARGIN{120};
+    static constexpr int MAX_FUTILITY_DEPTH{2};
+    static constexpr Evaluation FUTILITY_MARGIN{150};
+
+    static consteval Lookup<Lookup<std::uint8_t>> create_late_move_reductions_lookup();
+    static const Lookup<Lookup<std::uint8_t>> LATE_MOVE_REDUCTIONS_LOOKUP;
+
+    /*
+    Checking the clock every node would cost more than a slightly late stop
+    */
+    static constexpr std::uint64_t NODES_PER_LIMITS_CHECK{1024};
+
+    /*
+    Helper threads cycle through these, skipping a depth when (depth + phase) / size is odd
+    */
+    static constexpr std::size_t NUM_HELPER_SKIPS{20};
+    static constexpr Lookup<std::uint8_t, NUM_HELPER_SKIPS> HELPER_SKIP_SIZES{1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                                                              3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    static constexpr Lookup<std::uint8_t, NUM_HELPER_SKIPS> HELPER_SKIP_PHASES{0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                                                               4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+    bool is_main_thread() const;
+    bool should_skip_depth(std::uint8_t depth) const;
+
+    Evaluation search_aspiration_window(std::uint8_t depth, Evaluation previous_score);
+    Evaluation search_node(Evaluation alpha, Evaluation beta, int depth, std::uint8_t ply);
+    int get_late_move_reduction(Move move, int depth, std::size_t move_number, bool is_principal_variation) const;
+
+    /*
+    Only plays noisy moves, so the evaluation is never taken in the middle of an exchange. Captures that lose material
+    by static exchange evaluation are skipped, since standing pat is already at least as good.
+    */
+    Evaluation search_quiescence(Evaluation alpha, Evaluation beta, std::uint8_t ply);
+    Evaluation evaluate();
+
+    bool should_stop();
+    std::uint64_t flush_nodes();
+    void update_principal_variation(Move move, std::uint8_t ply);
+    void update_killer_moves(Move move, std::uint8_t ply);
+
+    /*
+    The move that cut off gets a bonus and every quiet move tried before it a malus
+    */
+    void update_quiet_move_history(Move move, const MoveList &searched_quiet_moves, int depth, std::uint8_t ply);
+
+    /*
+    Mate scores are stored relative to the node rather than the root, so they stay right wherever the position is
+    found again
+    */
+    static Evaluation score_to_transposition_table(Evaluation score, std::uint8_t ply);
+    static Evaluation score_from_transposition_table(Evaluation score, std::uint8_t ply);
+
+    TranspositionTable &transposition_table;
+    SearchSignals own_signals;
+    SearchSignals &signals;
+    std::size_t thread_idx;
+
+    SearchOptions options;
+    Position position;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point start_time;
+    std::uint8_t root_depth;
+    std::uint64_t nodes;
+    std::uint64_t flushed_nodes;
+    std::uint64_t next_limits_check_nodes;
+    bool stopped;
+    std::uint64_t beta_cutoffs;
+    std::uint64_t first_move_beta_cutoffs;
+
+    /*
+    Each ply's principal variation is built from the move found there plus the one from the ply below
+    */
+    std::array<std::array<Move, MAX_PLY>, MAX_PLY> principal_variations;
+    std::array<std::uint8_t, MAX_PLY> principal_variation_lengths;
+    std::array<MovePicker::KillerMoves, MAX_PLY> killer_moves;
+    MoveHistory move_history;
+
+    /*
+    Kept per thread, so it's never written to by two threads at once
+    */
+    PawnHashTable pawn_hash_table;
+
+    /*
+    The move made at each ply on the way to the current node, for looking up countermoves. A null move is stored as
+    the default move.
+    */
+    std::array<Move, MAX_PLY> played_moves;
+};
@@ -0,0 +1,411 @@
+#include "slider_attacks.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+#include <cpuid.h>
+#endif
+
+template <Direction direction> consteval Lookup<BitBoard> SliderAttacks::create_rays_bit_board_lookup()
+{
+    /*
+    Stops a ray wrapping around to the other side of the board
+    */
+    BitBoard not_wrapping_bit_board{~BitBoard{0}};
+    if constexpr (direction == Direction::E || direction == Direction::NE || direction == Direction::SE)
+    {
+        not_wrapping_bit_board = NOT_H_FILE_BIT_BOARD;
+    }
+    else if constexpr (direction == Direction::W || direction == Direction::NW || direction == Direction::SW)
+    {
+        not_wrapping_bit_board = NOT_A_FILE_BIT_BOARD;
+    }
+
+    Lookup<BitBoard> rays_bit_board_lookup{};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        auto ray_bit_board{square_to_bit_board(Square{from})};
+        while (ray_bit_board)
+        {
+            ray_bit_board = direction_shift<direction>(ray_bit_board & not_wrapping_bit_board);
+            rays_bit_board_lookup.at(from) |= ray_bit_board;
+        }
+    }
+
+    return rays_bit_board_lookup;
+}
+
+template <Direction direction>
+consteval BitBoard SliderAttacks::create_ray_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    auto ray_bit_board{RAYS_BIT_BOARD_LOOKUP<direction>.at(from)};
+
+    /*
+    Everything past the nearest blocker is exactly the ray starting from that blocker
+    */
+    const auto blockers_bit_board{ray_bit_board & occupied_bit_board};
+    if (blockers_bit_board)
+    {
+        const auto blocker{direction > 0 ? std::countr_zero(blockers_bit_board)
+                                         : BOARD_SQUARES - 1 - std::countl_zero(blockers_bit_board)};
+        ray_bit_board ^= RAYS_BIT_BOARD_LOOKUP<direction>.at(blocker);
+    }
+
+    return ray_bit_board;
+}
+
+consteval BitBoard SliderAttacks::create_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    BitBoard attacks_bit_board{0};
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::NE>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::SE>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::SW>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::NW>(from, occupied_bit_board);
+
+    return attacks_bit_board;
+}
+
+consteval BitBoard SliderAttacks::create_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    BitBoard attacks_bit_board{0};
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::N>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::E>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::S>(from, occupied_bit_board);
+    attacks_bit_board |= create_ray_attacks_bit_board<Direction::W>(from, occupied_bit_board);
+
+    return attacks_bit_board;
+}
+
+consteval Lookup<BitBoard> SliderAttacks::create_bishop_relevant_occupancies_bit_board_lookup()
+{
+    /*
+    Blockers on the edge of the board never change the attacks, so they're left out
+    */
+    const auto not_edge_bit_board{~(rank_to_bit_board(Rank::R1) | rank_to_bit_board(Rank::R8) |
+                                    file_to_bit_board(File::FA) | file_to_bit_board(File::FH))};
+
+    Lookup<BitBoard> bishop_relevant_occupancies_bit_board_lookup{};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        bishop_relevant_occupancies_bit_board_lookup.at(from) = create_bishop_attacks_bit_board(from, 0) &
+                                                                not_edge_bit_board;
+    }
+
+    return bishop_relevant_occupancies_bit_board_lookup;
+}
+
+consteval Lookup<BitBoard> SliderAttacks::create_rook_relevant_occupancies_bit_board_lookup()
+{
+    Lookup<BitBoard> rook_relevant_occupancies_bit_board_lookup{};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        /*
+        Only the last square of each ray is irrelevant, so the edges can't just be masked off like for bishops
+        */
+        BitBoard relevant_occupancies_bit_board{0};
+        relevant_occupancies_bit_board |= RAYS_BIT_BOARD_LOOKUP<Direction::N>.at(from) & ~rank_to_bit_board(Rank::R8);
+        relevant_occupancies_bit_board |= RAYS_BIT_BOARD_LOOKUP<Direction::E>.at(from) & ~file_to_bit_board(File::FH);
+        relevant_occupancies_bit_board |= RAYS_BIT_BOARD_LOOKUP<Direction::S>.at(from) & ~rank_to_bit_board(Rank::R1);
+        relevant_occupancies_bit_board |= RAYS_BIT_BOARD_LOOKUP<Direction::W>.at(from) & ~file_to_bit_board(File::FA);
+
+        rook_relevant_occupancies_bit_board_lookup.at(from) = relevant_occupancies_bit_board;
+    }
+
+    return rook_relevant_occupancies_bit_board_lookup;
+}
+
+/*
+Found offline by trial of sparse random numbers. A bad one fails the build when the attack lookup is created.
+*/
+consteval Lookup<Magic> SliderAttacks::create_bishop_magics_lookup()
+{
+    // clang-format off
+    return {
+        0x0920011122108201, 0x0004D01081010000, 0x0042008200800000, 0x0A08061040000041,
+        0x8101104010004008, 0x0002080288008800, 0x4003940120120000, 0x0040120110080403,
+        0x0070081044180052, 0x4800210401204100, 0x00225004820C5800, 0x0100082040410405,
+        0x0080084840008400, 0x0820020211050100, 0x0100004C02201082, 0x0000020500884480,
+        0x2040200882044401, 0x80A010104200A105, 0x4022006404140208, 0x6002000C02120522,
+        0x0002854400A02A40, 0x024200410100D200, 0xA208800400884800, 0x301D30010092100C,
+        0x0002408421440400, 0x001004564808A083, 0x0228180021004500, 0x004004800400A080,
+        0x580101400C004040, 0x100C8200B4221000, 0x9001090084040100, 0x0000828002026422,
+        0x0004024201087000, 0x1801412000981800, 0x069084010470004C, 0x9812020080080080,
+        0x0010008220020200, 0x0000900100408080, 0x02A40102000400A0, 0x1018120049488040,
+        0x1048141008028505, 0x000048080520C808, 0x001302C12A001000, 0x42228A4208040C80,
+        0x0400400102108102, 0x8040080800451020, 0x0050902083040480, 0x0808020080220A10,
+        0x0009241002288100, 0x0800420811084000, 0x8010011841100A40, 0x0028000042088006,
+        0x0040101002121400, 0x8884204501120420, 0x8012200835004800, 0x4004010404088A03,
+        0x5080210120904008, 0x00D042010C490401, 0x00A0002084088880, 0x6000102000840421,
+        0x200D008010021A04, 0x0020806002328208, 0x01C0042108022080, 0x0410100158042041,
+    };
+    // clang-format on
+}
+
+consteval Lookup<Magic> SliderAttacks::create_rook_magics_lookup()
+{
+    // clang-format off
+    return {
+        0x0280012010C00A80, 0x2140100040002009, 0x2080200080100008, 0x4100081000200700,
+        0x0200040200201009, 0x0900010008040002, 0x0400011090380204, 0x0200002410804502,
+        0x0310800040089025, 0x0100400020005000, 0x8021001049002000, 0x8001002100100008,
+        0x0102800400080080, 0x000A00082E00104D, 0x0004001842011084, 0x1005000100007082,
+        0x0080208000400084, 0xB000808020004000, 0x0302110045002000, 0x4000848010010800,
+        0x0022020010200408, 0x3501010008040002, 0x000004004810A102, 0x10000200005100A4,
+        0x0510800080204000, 0x0040400080200080, 0x2000110100200040, 0x0080900480080080,
+        0x0001011100080004, 0x044C008080020004, 0x00A021040050A208, 0x0800802180015100,
+        0x180040008180022F, 0x0400400080802000, 0x0240450011002000, 0x8010100080800800,
+        0x1000800400800800, 0x0000020080800400, 0x0040880144000230, 0x004100008F002142,
+        0x0000400080088020, 0x0010002000444000, 0x0420001000208080, 0x520010010021000A,
+        0x0008000500090010, 0x0002005008A20004, 0x2800821088040001, 0x0840208041020004,
+        0x8011244009800180, 0x0045048026004200, 0x004A002840108600, 0x002A4022000A1200,
+        0x0020080004008080, 0x4401044020100801, 0x004221B008020400, 0x2400364100840200,
+        0x00010229128000C1, 0x0009002010820042, 0x004A200040102903, 0x0C04090004100021,
+        0x4041000208000411, 0x080A000408108102, 0x0800081001020084, 0x6000089025040042,
+    };
+    // clang-format on
+}
+
+consteval Lookup<SliderAttacks::SliderEntry> SliderAttacks::create_slider_entries_lookup(
+    const Lookup<BitBoard> &relevant_occupancies_bit_board_lookup, const Lookup<Magic> &magics_lookup,
+    std::size_t first_offset, std::size_t num_attacks)
+{
+    Lookup<SliderEntry> slider_entries_lookup{};
+    auto offset{first_offset};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto relevant_occupancies_bit_board{relevant_occupancies_bit_board_lookup.at(from)};
+        const auto num_relevant_occupancies{std::popcount(relevant_occupancies_bit_board)};
+
+        auto &slider_entry{slider_entries_lookup.at(from)};
+        slider_entry.relevant_occupancies_bit_board = relevant_occupancies_bit_board;
+        slider_entry.magic = magics_lookup.at(from);
+        slider_entry.offset = static_cast<std::uint32_t>(offset);
+        slider_entry.shift = static_cast<std::uint8_t>(BOARD_SQUARES - num_relevant_occupancies);
+
+        offset += std::size_t{1} << num_relevant_occupancies;
+    }
+
+    if (offset - first_offset != num_attacks)
+    {
+        throw std::logic_error{"Attack lookup is the wrong size for the relevant occupancies"};
+    }
+
+    return slider_entries_lookup;
+}
+
+alignas(CACHE_LINE_BYTES) constexpr Lookup<SliderAttacks::SliderEntry> SliderAttacks::BISHOP_SLIDER_ENTRIES_LOOKUP{
+    create_slider_entries_lookup(create_bishop_relevant_occupancies_bit_board_lookup(), create_bishop_magics_lookup(),
+                                 0, NUM_BISHOP_ATTACKS)};
+alignas(CACHE_LINE_BYTES) constexpr Lookup<SliderAttacks::SliderEntry> SliderAttacks::ROOK_SLIDER_ENTRIES_LOOKUP{
+    create_slider_entries_lookup(create_rook_relevant_occupancies_bit_board_lookup(), create_rook_magics_lookup(),
+                                 NUM_BISHOP_ATTACKS, NUM_ROOK_ATTACKS)};
+
+template <SliderAttacksBackend backend>
+consteval SliderAttacks::SliderAttacksLookup SliderAttacks::create_slider_attacks_bit_board_lookup()
+{
+    SliderAttacksLookup slider_attacks_bit_board_lookup{};
+
+    const auto add_attacks{[&slider_attacks_bit_board_lookup](const Lookup<SliderEntry> &slider_entries_lookup,
+                                                              auto create_attacks_bit_board) {
+        for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+        {
+            const auto &slider_entry{slider_entries_lookup.at(from)};
+
+            /*
+            Carry-Rippler trick to visit every subset of the relevant occupancies, starting and ending with none. It
+            counts up through them in the same order as their PEXT indices.
+            */
+            BitBoard occupied_bit_board{0};
+            std::size_t pext_idx{0};
+            do
+            {
+                std::size_t idx{slider_entry.offset + pext_idx};
+                if constexpr (backend == SliderAttacksBackend::Magics)
+                {
+                    idx = slider_entry.offset + ((occupied_bit_board * slider_entry.magic) >> slider_entry.shift);
+                }
+                const auto attacks_bit_board{create_attacks_bit_board(from, occupied_bit_board)};
+
+                /*
+                Sliders always attack at least one square, so a zero entry has never been written. Two occupancies
+                sharing an entry is fine as long as their attacks are the same.
+                */
+                auto &entry{slider_attacks_bit_board_lookup.at(idx)};
+                if (entry && entry != attacks_bit_board)
+                {
+                    throw std::logic_error{"Magic maps occupancies with different attacks to the same entry"};
+                }
+                entry = attacks_bit_board;
+
+                occupied_bit_board = (occupied_bit_board - slider_entry.relevant_occupancies_bit_board) &
+                                     slider_entry.relevant_occupancies_bit_board;
+                ++pext_idx;
+            } while (occupied_bit_board);
+        }
+    }};
+
+    add_attacks(BISHOP_SLIDER_ENTRIES_LOOKUP, create_bishop_attacks_bit_board);
+    add_attacks(ROOK_SLIDER_ENTRIES_LOOKUP, create_rook_attacks_bit_board);
+
+    return slider_attacks_bit_board_lookup;
+}
+
+alignas(CACHE_LINE_BYTES) constexpr SliderAttacks::SliderAttacksLookup
+    SliderAttacks::MAGIC_SLIDER_ATTACKS_BIT_BOARD_LOOKUP{
+        create_slider_attacks_bit_board_lookup<SliderAttacksBackend::Magics>()};
+alignas(CACHE_LINE_BYTES) constexpr SliderAttacks::SliderAttacksLookup
+    SliderAttacks::PEXT_SLIDER_ATTACKS_BIT_BOARD_LOOKUP{
+        create_slider_attacks_bit_board_lookup<SliderAttacksBackend::Pext>()};
+
+template <Direction direction> consteval void SliderAttacks::add_between_bit_boards(SquaresBitBoardLookup &lookup)
+{
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto ray_bit_board{RAYS_BIT_BOARD_LOOKUP<direction>.at(from)};
+        auto to_bit_board{ray_bit_board};
+        while (to_bit_board)
+        {
+            const auto to{std::countr_zero(to_bit_board)};
+
+            /*
+            The ray from the far square covers everything past it, which leaves it and whatever's between
+            */
+            lookup.at(from).at(to) = ray_bit_board & ~RAYS_BIT_BOARD_LOOKUP<direction>.at(to) &
+                                     ~square_to_bit_board(Square{static_cast<SquareUnderlying>(to)});
+
+            to_bit_board &= to_bit_board - 1;
+        }
+    }
+}
+
+template <Direction direction> consteval void SliderAttacks::add_line_bit_boards(SquaresBitBoardLookup &lookup)
+{
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto line_bit_board{RAYS_BIT_BOARD_LOOKUP<direction>.at(from) |
+                                  RAYS_BIT_BOARD_LOOKUP<Direction{-direction}>.at(from) |
+                                  square_to_bit_board(Square{from})};
+        auto to_bit_board{RAYS_BIT_BOARD_LOOKUP<direction>.at(from)};
+        while (to_bit_board)
+        {
+            lookup.at(from).at(std::countr_zero(to_bit_board)) = line_bit_board;
+            to_bit_board &= to_bit_board - 1;
+        }
+    }
+}
+
+consteval SliderAttacks::SquaresBitBoardLookup SliderAttacks::create_between_bit_board_lookup()
+{
+    SquaresBitBoardLookup between_bit_board_lookup{};
+    add_between_bit_boards<Direction::N>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::NE>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::E>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::SE>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::S>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::SW>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::W>(between_bit_board_lookup);
+    add_between_bit_boards<Direction::NW>(between_bit_board_lookup);
+
+    return between_bit_board_lookup;
+}
+
+consteval SliderAttacks::SquaresBitBoardLookup SliderAttacks::create_line_bit_board_lookup()
+{
+    SquaresBitBoardLookup line_bit_board_lookup{};
+    add_line_bit_boards<Direction::N>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::NE>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::E>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::SE>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::S>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::SW>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::W>(line_bit_board_lookup);
+    add_line_bit_boards<Direction::NW>(line_bit_board_lookup);
+
+    return line_bit_board_lookup;
+}
+
+alignas(CACHE_LINE_BYTES) constexpr SliderAttacks::SquaresBitBoardLookup SliderAttacks::BETWEEN_BIT_BOARD_LOOKUP{
+    create_between_bit_board_lookup()};
+alignas(CACHE_LINE_BYTES) constexpr SliderAttacks::SquaresBitBoardLookup SliderAttacks::LINE_BIT_BOARD_LOOKUP{
+    create_line_bit_board_lookup()};
+
+SliderAttacksBackend SliderAttacks::backend{SliderAttacks::detect_fastest_backend()};
+
+void SliderAttacks::set_backend(SliderAttacksBackend new_backend)
+{
+    if (!is_backend_supported(new_backend))
+    {
+        throw std::logic_error{"Slider attacks backend isn't supported by this CPU"};
+    }
+
+    backend = new_backend;
+}
+
+bool SliderAttacks::is_backend_supported(SliderAttacksBackend backend_to_check)
+{
+    switch (backend_to_check)
+    {
+    case SliderAttacksBackend::Magics:
+        return true;
+    case SliderAttacksBackend::Pext:
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+    {
+        unsigned int eax{0};
+        unsigned int ebx{0};
+        unsigned int ecx{0};
+        unsigned int edx{0};
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_BMI2);
+    }
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+SliderAttacksBackend SliderAttacks::detect_fastest_backend()
+{
+    if (!is_backend_supported(SliderAttacksBackend::Pext))
+    {
+        return SliderAttacksBackend::Magics;
+    }
+
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+    /*
+    Zen and Zen 2 (family 17h) and older AMD advertise BMI2 but run PEXT in microcode, taking up to hundreds of cycles
+    depending on the mask
+    */
+    unsigned int eax{0};
+    unsigned int ebx{0};
+    unsigned int ecx{0};
+    unsigned int edx{0};
+    __cpuid(0, eax, ebx, ecx, edx);
+    const auto is_amd{ebx == 0x68747541 && edx == 0x69746E65 && ecx == 0x444D4163}; /* "AuthenticAMD" */
+
+    __cpuid(1, eax, ebx, ecx, edx);
+    const auto family{((eax >> 8) & 0xF) + ((eax >> 20) & 0xFF)};
+    if (is_amd && family < ZEN_3_FAMILY)
+    {
+        return SliderAttacksBackend::Magics;
+    }
+#endif
+
+    return SliderAttacksBackend::Pext;
+}
+
+std::ostream &operator<<(std::ostream &os, SliderAttacksBackend backend)
+{
+    switch (backend)
+    {
+    case SliderAttacksBackend::Magics:
+        os << "magics";
+        break;
+    case SliderAttacksBackend::Pext:
+        os << "pext";
+        break;
+    }
+
+    return os;
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "memory.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/*
+The 64 bit PEXT only exists in 64 bit mode
+*/
+#if defined(__x86_64__)
+#define SLIDER_ATTACKS_HAS_PEXT
+#endif
+
+/*
+How a slider's relevant occupancies are turned into an index into its slice of the attack lookup
+*/
+enum SliderAttacksBackend : std::uint8_t
+{
+    Magics,
+    Pext,
+};
+
+std::ostream &operator<<(std::ostream &os, SliderAttacksBackend backend);
+
+/*
+Bishop and rook attacks for any occupancy. Every square gets its own slice of one contiguous attack lookup sized by how
+many relevant occupancies it has, and every lookup is built at compile time.
+
+The backend is picked once at startup from what the CPU supports. PEXT is only used where it's actually fast, because
+AMD before Zen 3 implements it in microcode and magics win by a long way there.
+*/
+class SliderAttacks
+{
+  public:
+    static BitBoard get_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+    static BitBoard get_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+    static BitBoard get_queen_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+
+    /*
+    Both are empty unless the squares share a rank, file or diagonal. Between excludes both squares, line is the whole
+    line through them edge to edge.
+    */
+    static BitBoard get_between_bit_board(SquareUnderlying from, SquareUnderlying to);
+    static BitBoard get_line_bit_board(SquareUnderlying from, SquareUnderlying to);
+
+    template <SliderAttacksBackend backend>
+    static BitBoard get_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+    template <SliderAttacksBackend backend>
+    static BitBoard get_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+
+    static SliderAttacksBackend get_backend();
+
+    /*
+    Not safe to call while other threads are generating moves. Throws if the CPU can't run the backend.
+    */
+    static void set_backend(SliderAttacksBackend new_backend);
+
+    static bool is_backend_supported(SliderAttacksBackend backend_to_check);
+    static SliderAttacksBackend detect_fastest_backend();
+
+  private:
+    /*
+    Everything needed for one lookup, aligned so it never straddles two cache lines. PEXT only needs the relevant
+    occupancies and offset.
+    */
+    struct alignas(32) SliderEntry
+    {
+        BitBoard relevant_occupancies_bit_board;
+        Magic magic;
+        std::uint32_t offset;
+        std::uint8_t shift;
+    };
+    static_assert(CACHE_LINE_BYTES % sizeof(SliderEntry) == 0);
+
+    /*
+    Sum of 2^(number of relevant occupancies) over every square, checked against the lookups when they're built
+    */
+    static constexpr std::size_t NUM_BISHOP_ATTACKS{5248};
+    static constexpr std::size_t NUM_ROOK_ATTACKS{102400};
+    using SliderAttacksLookup = Lookup<BitBoard, NUM_BISHOP_ATTACKS + NUM_ROOK_ATTACKS>;
+    using SquaresBitBoardLookup = Lookup<Lookup<BitBoard>>;
+
+    template <Direction direction> static consteval Lookup<BitBoard> create_rays_bit_board_lookup();
+    template <Direction direction> static constexpr Lookup<BitBoard> RAYS_BIT_BOARD_LOOKUP{
+        create_rays_bit_board_lookup<direction>()};
+
+    template <Direction direction>
+    static consteval BitBoard create_ray_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+    static consteval BitBoard create_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+    static consteval BitBoard create_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board);
+
+    static consteval Lookup<BitBoard> create_bishop_relevant_occupancies_bit_board_lookup();
+    static consteval Lookup<BitBoard> create_rook_relevant_occupancies_bit_board_lookup();
+    static consteval Lookup<Magic> create_bishop_magics_lookup();
+    static consteval Lookup<Magic> create_rook_magics_lookup();
+    static consteval Lookup<SliderEntry> create_slider_entries_lookup(
+        const Lookup<BitBoard> &relevant_occupancies_bit_board_lookup, const Lookup<Magic> &magics_lookup,
+        std::size_t first_offset, std::size_t num_attacks);
+    template <SliderAttacksBackend backend>
+    static consteval SliderAttacksLookup create_slider_attacks_bit_board_lookup();
+    template <Direction direction> static consteval void add_between_bit_boards(SquaresBitBoardLookup &lookup);
+    template <Direction direction> static consteval void add_line_bit_boards(SquaresBitBoardLookup &lookup);
+    static consteval SquaresBitBoardLookup create_between_bit_board_lookup();
+    static consteval SquaresBitBoardLookup create_line_bit_board_lookup();
+
+    alignas(CACHE_LINE_BYTES) static const Lookup<SliderEntry> BISHOP_SLIDER_ENTRIES_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const Lookup<SliderEntry> ROOK_SLIDER_ENTRIES_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const SliderAttacksLookup MAGIC_SLIDER_ATTACKS_BIT_BOARD_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const SliderAttacksLookup PEXT_SLIDER_ATTACKS_BIT_BOARD_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const SquaresBitBoardLookup BETWEEN_BIT_BOARD_LOOKUP;
+    alignas(CACHE_LINE_BYTES) static const SquaresBitBoardLookup LINE_BIT_BOARD_LOOKUP;
+
+    template <SliderAttacksBackend backend>
+    static BitBoard get_attacks_bit_board(const SliderEntry &slider_entry, BitBoard occupied_bit_board);
+
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+    /*
+    Inline assembly rather than the intrinsic, which needs the whole caller compiled for BMI2 before it can be inlined.
+    The rest of the binary has to keep running on CPUs without it.
+    */
+    static BitBoard pext(BitBoard bit_board, BitBoard mask_bit_board);
+#endif
+
+    /*
+    Extended family reported by CPUID on AMD, the first one where PEXT is done in hardware
+    */
+    static constexpr unsigned int ZEN_3_FAMILY{0x19};
+
+    static SliderAttacksBackend backend;
+};
+
+inline BitBoard SliderAttacks::get_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    if (backend == SliderAttacksBackend::Pext)
+    {
+        return get_bishop_attacks_bit_board<SliderAttacksBackend::Pext>(from, occupied_bit_board);
+    }
+
+    return get_bishop_attacks_bit_board<SliderAttacksBackend::Magics>(from, occupied_bit_board);
+}
+
+inline BitBoard SliderAttacks::get_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    if (backend == SliderAttacksBackend::Pext)
+    {
+        return get_rook_attacks_bit_board<SliderAttacksBackend::Pext>(from, occupied_bit_board);
+    }
+
+    return get_rook_attacks_bit_board<SliderAttacksBackend::Magics>(from, occupied_bit_board);
+}
+
+inline BitBoard SliderAttacks::get_queen_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    return get_bishop_attacks_bit_board(from, occupied_bit_board) |
+           get_rook_attacks_bit_board(from, occupied_bit_board);
+}
+
+template <SliderAttacksBackend backend>
+inline BitBoard SliderAttacks::get_bishop_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    return get_attacks_bit_board<backend>(BISHOP_SLIDER_ENTRIES_LOOKUP[from], occupied_bit_board);
+}
+
+template <SliderAttacksBackend backend>
+inline BitBoard SliderAttacks::get_rook_attacks_bit_board(SquareUnderlying from, BitBoard occupied_bit_board)
+{
+    return get_attacks_bit_board<backend>(ROOK_SLIDER_ENTRIES_LOOKUP[from], occupied_bit_board);
+}
+
+inline BitBoard SliderAttacks::get_between_bit_board(SquareUnderlying from, SquareUnderlying to)
+{
+    return BETWEEN_BIT_BOARD_LOOKUP[from][to];
+}
+
+inline BitBoard SliderAttacks::get_line_bit_board(SquareUnderlying from, SquareUnderlying to)
+{
+    return LINE_BIT_BOARD_LOOKUP[from][to];
+}
+
+inline SliderAttacksBackend SliderAttacks::get_backend()
+{
+    return backend;
+}
+
+template <SliderAttacksBackend backend>
+inline BitBoard SliderAttacks::get_attacks_bit_board(const SliderEntry &slider_entry, BitBoard occupied_bit_board)
+{
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+    if constexpr (backend == SliderAttacksBackend::Pext)
+    {
+        const auto idx{pext(occupied_bit_board, slider_entry.relevant_occupancies_bit_board)};
+
+        return PEXT_SLIDER_ATTACKS_BIT_BOARD_LOOKUP[slider_entry.offset + idx];
+    }
+#endif
+
+    const auto idx{((occupied_bit_board & slider_entry.relevant_occupancies_bit_board) * slider_entry.magic) >>
+                   slider_entry.shift};
+
+    return MAGIC_SLIDER_ATTACKS_BIT_BOARD_LOOKUP[slider_entry.offset + idx];
+}
+
+#ifdef SLIDER_ATTACKS_HAS_PEXT
+inline BitBoard SliderAttacks::pext(BitBoard bit_board, BitBoard mask_bit_board)
+{
+    BitBoard extracted_bit_board;
+    asm("pextq %2, %1, %0" : "=r"(extracted_bit_board) : "r"(bit_board), "r"(mask_bit_board));
+
+    return extracted_bit_board;
+}
+#endif
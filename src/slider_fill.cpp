@@ -0,0 +1,111 @@
+#include "slider_fill.hpp"
+
+#include <stdexcept>
+
+#ifdef SLIDER_FILL_HAS_AVX2
+#include <immintrin.h>
+#endif
+
+SliderFillBackend SliderFill::backend{SliderFill::is_backend_supported(SliderFillBackend::Avx2Fill)
+                                          ? SliderFillBackend::Avx2Fill
+                                          : SliderFillBackend::ScalarFill};
+
+void SliderFill::set_backend(SliderFillBackend new_backend)
+{
+    if (!is_backend_supported(new_backend))
+    {
+        throw std::logic_error{"Slider fill backend isn't supported by this CPU"};
+    }
+
+    backend = new_backend;
+}
+
+bool SliderFill::is_backend_supported(SliderFillBackend backend_to_check)
+{
+    switch (backend_to_check)
+    {
+    case SliderFillBackend::ScalarFill:
+        return true;
+    case SliderFillBackend::Avx2Fill:
+#ifdef SLIDER_FILL_HAS_AVX2
+        /*
+        Needed because this also runs during static initialisation, possibly before libgcc has detected the CPU
+        */
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+#ifdef SLIDER_FILL_HAS_AVX2
+[[gnu::target("avx2")]] BitBoard SliderFill::get_avx2_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                                        BitBoard orthogonal_sliders_bit_board,
+                                                                        BitBoard occupied_bit_board)
+{
+    /*
+    Lanes are N, NE, E and NW, shifted left, then S, SW, W and SE, shifted right by the same amounts. That pairs every
+    direction with its opposite, so both halves share their shift amounts and sliders.
+    */
+    const auto shift{_mm256_setr_epi64x(Direction::N, Direction::NE, Direction::E, Direction::NW)};
+    const auto left_not_wrapped{_mm256_setr_epi64x(~BitBoard{0}, NOT_A_FILE_BIT_BOARD, NOT_A_FILE_BIT_BOARD,
+                                                   NOT_H_FILE_BIT_BOARD)};
+    const auto right_not_wrapped{_mm256_setr_epi64x(~BitBoard{0}, NOT_H_FILE_BIT_BOARD, NOT_H_FILE_BIT_BOARD,
+                                                    NOT_A_FILE_BIT_BOARD)};
+
+    const auto sliders{_mm256_setr_epi64x(orthogonal_sliders_bit_board, diagonal_sliders_bit_board,
+                                          orthogonal_sliders_bit_board, diagonal_sliders_bit_board)};
+    const auto empty{_mm256_set1_epi64x(~occupied_bit_board)};
+
+    auto left_sliders{sliders};
+    auto left_propagator{_mm256_and_si256(empty, left_not_wrapped)};
+    auto right_sliders{sliders};
+    auto right_propagator{_mm256_and_si256(empty, right_not_wrapped)};
+
+    /*
+    Same steps as the scalar fill, with the shift doubling each time
+    */
+    auto step_shift{shift};
+    for (auto step{0}; step < NUM_FILL_STEPS; ++step)
+    {
+        const auto left_step_sliders{_mm256_sllv_epi64(left_sliders, step_shift)};
+        left_sliders = _mm256_or_si256(left_sliders, _mm256_and_si256(left_propagator, left_step_sliders));
+        left_propagator = _mm256_and_si256(left_propagator, _mm256_sllv_epi64(left_propagator, step_shift));
+
+        const auto right_step_sliders{_mm256_srlv_epi64(right_sliders, step_shift)};
+        right_sliders = _mm256_or_si256(right_sliders, _mm256_and_si256(right_propagator, right_step_sliders));
+        right_propagator = _mm256_and_si256(right_propagator, _mm256_srlv_epi64(right_propagator, step_shift));
+
+        step_shift = _mm256_add_epi64(step_shift, step_shift);
+    }
+
+    const auto left_attacks{_mm256_and_si256(_mm256_sllv_epi64(left_sliders, shift), left_not_wrapped)};
+    const auto right_attacks{_mm256_and_si256(_mm256_srlv_epi64(right_sliders, shift), right_not_wrapped)};
+    const auto attacks{_mm256_or_si256(left_attacks, right_attacks)};
+
+    /*
+    OR the four lanes together
+    */
+    const auto half_attacks{_mm_or_si128(_mm256_castsi256_si128(attacks), _mm256_extracti128_si256(attacks, 1))};
+
+    return static_cast<BitBoard>(_mm_cvtsi128_si64(half_attacks) | _mm_extract_epi64(half_attacks, 1));
+}
+#endif
+
+std::ostream &operator<<(std::ostream &os, SliderFillBackend backend)
+{
+    switch (backend)
+    {
+    case SliderFillBackend::ScalarFill:
+        os << "scalar";
+        break;
+    case SliderFillBackend::Avx2Fill:
+        os << "avx2";
+        break;
+    }
+
+    return os;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <iostream>
+
+/*
+Moving the 64 bit lanes back into a bitboard needs 64 bit mode
+*/
+#if defined(__x86_64__)
+#define SLIDER_FILL_HAS_AVX2
+#endif
+
+enum SliderFillBackend : std::uint8_t
+{
+    ScalarFill,
+    Avx2Fill,
+};
+
+std::ostream &operator<<(std::ostream &os, SliderFillBackend backend);
+
+/*
+Every square attacked by a whole side's sliders at once, using Kogge-Stone occluded fills instead of a table lookup per
+piece. Each of the eight directions is an independent fill, so the AVX2 backend runs four of them per vector.
+*/
+class SliderFill
+{
+  public:
+    static BitBoard get_attacks_bit_board(BitBoard diagonal_sliders_bit_board, BitBoard orthogonal_sliders_bit_board,
+                                          BitBoard occupied_bit_board);
+
+    template <SliderFillBackend backend>
+    static BitBoard get_attacks_bit_board(BitBoard diagonal_sliders_bit_board, BitBoard orthogonal_sliders_bit_board,
+                                          BitBoard occupied_bit_board);
+
+    static SliderFillBackend get_backend();
+
+    /*
+    Not safe to call while other threads are generating moves. Throws if the CPU can't run the backend.
+    */
+    static void set_backend(SliderFillBackend new_backend);
+
+    static bool is_backend_supported(SliderFillBackend backend_to_check);
+
+  private:
+    /*
+    Steps of 1, 2 and 4 squares reach 7, the furthest any ray goes
+    */
+    static constexpr auto NUM_FILL_STEPS{3};
+
+    template <Direction direction>
+    static BitBoard fill_attacks_bit_board(BitBoard sliders_bit_board, BitBoard empty_bit_board);
+
+    static BitBoard get_scalar_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                 BitBoard orthogonal_sliders_bit_board, BitBoard occupied_bit_board);
+#ifdef SLIDER_FILL_HAS_AVX2
+    /*
+    Compiled for AVX2 on its own so the rest of the binary still runs on CPUs without it. Worth the call, since it
+    replaces a lookup for every slider.
+    */
+    [[gnu::target("avx2")]] static BitBoard get_avx2_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                                       BitBoard orthogonal_sliders_bit_board,
+                                                                       BitBoard occupied_bit_board);
+#endif
+
+    static SliderFillBackend backend;
+};
+
+inline BitBoard SliderFill::get_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                  BitBoard orthogonal_sliders_bit_board, BitBoard occupied_bit_board)
+{
+    if (backend == SliderFillBackend::Avx2Fill)
+    {
+        return get_attacks_bit_board<SliderFillBackend::Avx2Fill>(diagonal_sliders_bit_board,
+                                                                  orthogonal_sliders_bit_board, occupied_bit_board);
+    }
+
+    return get_attacks_bit_board<SliderFillBackend::ScalarFill>(diagonal_sliders_bit_board,
+                                                                orthogonal_sliders_bit_board, occupied_bit_board);
+}
+
+template <SliderFillBackend backend>
+inline BitBoard SliderFill::get_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                  BitBoard orthogonal_sliders_bit_board, BitBoard occupied_bit_board)
+{
+#ifdef SLIDER_FILL_HAS_AVX2
+    if constexpr (backend == SliderFillBackend::Avx2Fill)
+    {
+        return get_avx2_attacks_bit_board(diagonal_sliders_bit_board, orthogonal_sliders_bit_board,
+                                          occupied_bit_board);
+    }
+#endif
+
+    return get_scalar_attacks_bit_board(diagonal_sliders_bit_board, orthogonal_sliders_bit_board, occupied_bit_board);
+}
+
+inline SliderFillBackend SliderFill::get_backend()
+{
+    return backend;
+}
+
+template <Direction direction>
+inline BitBoard SliderFill::fill_attacks_bit_board(BitBoard sliders_bit_board, BitBoard empty_bit_board)
+{
+    /*
+    Squares a ray can't have come from without wrapping around the board
+    */
+    BitBoard not_wrapped_bit_board{~BitBoard{0}};
+    if constexpr (direction == Direction::E || direction == Direction::NE || direction == Direction::SE)
+    {
+        not_wrapped_bit_board = NOT_A_FILE_BIT_BOARD;
+    }
+    else if constexpr (direction == Direction::W || direction == Direction::NW || direction == Direction::SW)
+    {
+        not_wrapped_bit_board = NOT_H_FILE_BIT_BOARD;
+    }
+
+    /*
+    Each step doubles how far the fill has reached, through empty squares only
+    */
+    auto propagator_bit_board{empty_bit_board & not_wrapped_bit_board};
+    sliders_bit_board |= propagator_bit_board & direction_shift<direction>(sliders_bit_board);
+    propagator_bit_board &= direction_shift<direction>(propagator_bit_board);
+    sliders_bit_board |= propagator_bit_board & direction_shift<Direction{2 * direction}>(sliders_bit_board);
+    propagator_bit_board &= direction_shift<Direction{2 * direction}>(propagator_bit_board);
+    sliders_bit_board |= propagator_bit_board & direction_shift<Direction{4 * direction}>(sliders_bit_board);
+
+    /*
+    One more step onto the first blocker
+    */
+    return direction_shift<direction>(sliders_bit_board) & not_wrapped_bit_board;
+}
+
+inline BitBoard SliderFill::get_scalar_attacks_bit_board(BitBoard diagonal_sliders_bit_board,
+                                                         BitBoard orthogonal_sliders_bit_board,
+                                                         BitBoard occupied_bit_board)
+{
+    const auto empty_bit_board{~occupied_bit_board};
+
+    BitBoard attacks_bit_board{0};
+    attacks_bit_board |= fill_attacks_bit_board<Direction::N>(orthogonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::E>(orthogonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::S>(orthogonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::W>(orthogonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::NE>(diagonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::SE>(diagonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::SW>(diagonal_sliders_bit_board, empty_bit_board);
+    attacks_bit_board |= fill_attacks_bit_board<Direction::NW>(diagonal_sliders_bit_board, empty_bit_board);
+
+    return attacks_bit_board;
+}
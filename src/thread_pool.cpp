@@ -0,0 +1,141 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+thread_local const ThreadPool *ThreadPool::current_pool{nullptr};
+thread_local std::size_t ThreadPool::current_worker_idx{ThreadPool::NO_WORKER};
+
+ThreadPool::ThreadPool(std::size_t num_threads)
+    : workers{}, threads{}, wake_mutex{}, wake_condition{}, done_condition{}, num_queued{0}, num_pending{0},
+      next_worker_idx{0}, stopping{false}
+{
+    num_threads = std::max<std::size_t>(num_threads, 1);
+    for (std::size_t worker_idx{0}; worker_idx < num_threads; ++worker_idx)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t worker_idx{0}; worker_idx < num_threads; ++worker_idx)
+    {
+        threads.emplace_back([this, worker_idx]() { run(worker_idx); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard lock{wake_mutex};
+        stopping = true;
+    }
+    wake_condition.notify_all();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(Task task)
+{
+    auto worker_idx{current_worker_idx};
+    if (current_pool != this)
+    {
+        worker_idx = next_worker_idx.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    }
+
+    /*
+    Counted before being pushed so the counts can never underflow when another worker grabs the task straight away
+    */
+    num_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        const std::lock_guard lock{wake_mutex};
+        num_queued.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        auto &worker{*workers[worker_idx]};
+        const std::lock_guard lock{worker.mutex};
+        worker.tasks.push_back(std::move(task));
+    }
+    wake_condition.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock lock{wake_mutex};
+    done_condition.wait(lock, [this]() { return num_pending.load() == 0; });
+}
+
+std::size_t ThreadPool::get_num_threads() const
+{
+    return threads.size();
+}
+
+void ThreadPool::run(std::size_t worker_idx)
+{
+    current_pool = this;
+    current_worker_idx = worker_idx;
+
+    while (true)
+    {
+        auto task{pop_task(worker_idx)};
+        if (!task.has_value())
+        {
+            task = steal_task(worker_idx);
+        }
+
+        if (task.has_value())
+        {
+            (*task)();
+
+            if (num_pending.fetch_sub(1) == 1)
+            {
+                const std::lock_guard lock{wake_mutex};
+                done_condition.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock{wake_mutex};
+        wake_condition.wait(lock, [this]() { return stopping || num_queued.load() > 0; });
+        if (stopping)
+        {
+            return;
+        }
+    }
+}
+
+std::optional<ThreadPool::Task> ThreadPool::pop_task(std::size_t worker_idx)
+{
+    auto &worker{*workers[worker_idx]};
+    const std::lock_guard lock{worker.mutex};
+    if (worker.tasks.empty())
+    {
+        return std::nullopt;
+    }
+
+    auto task{std::move(worker.tasks.back())};
+    worker.tasks.pop_back();
+    num_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    return task;
+}
+
+std::optional<ThreadPool::Task> ThreadPool::steal_task(std::size_t thief_idx)
+{
+    for (std::size_t offset{1}; offset < workers.size(); ++offset)
+    {
+        auto &victim{*workers[(thief_idx + offset) % workers.size()]};
+        const std::lock_guard lock{victim.mutex};
+        if (!victim.tasks.empty())
+        {
+            auto task{std::move(victim.tasks.front())};
+            victim.tasks.pop_front();
+            num_queued.fetch_sub(1, std::memory_order_relaxed);
+
+            return task;
+        }
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/*
+Every worker owns a deque. Tasks submitted from a worker go on the back of its own deque and are popped LIFO, so a
+worker keeps splitting the subtree it is already in. Idle workers steal from the front of other deques, which is where
+the oldest and therefore largest tasks are.
+*/
+class ThreadPool
+{
+  public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /*
+    Safe to call from inside a running task
+    */
+    void submit(Task task);
+
+    /*
+    Blocks until every submitted task, including ones submitted by other tasks, has finished. Must not be called from
+    inside a task.
+    */
+    void wait();
+
+    std::size_t get_num_threads() const;
+
+  private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr std::size_t NO_WORKER{static_cast<std::size_t>(-1)};
+
+    void run(std::size_t worker_idx);
+    std::optional<Task> pop_task(std::size_t worker_idx);
+    std::optional<Task> steal_task(std::size_t thief_idx);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex wake_mutex;
+    std::condition_variable wake_condition;
+    std::condition_variable done_condition;
+    std::atomic<std::size_t> num_queued;
+    std::atomic<std::size_t> num_pending;
+    std::atomic<std::size_t> next_worker_idx;
+    bool stopping;
+
+    static thread_local const ThreadPool *current_pool;
+    static thread_local std::size_t current_worker_idx;
+};
@@ -0,0 +1,161 @@
+#include "transposition_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+TranspositionTable::TranspositionTable(std::size_t megabytes, bool use_huge_pages)
+    : buckets{nullptr}, num_buckets{0}, generation{0}
+{
+    resize(megabytes, use_huge_pages);
+}
+
+void TranspositionTable::resize(std::size_t megabytes, bool use_huge_pages)
+{
+    /*
+    A power of two number of buckets lets the index be a mask of the key
+    */
+    num_buckets = std::bit_floor(std::max<std::size_t>(megabytes * MEGABYTE / sizeof(Bucket), 1));
+    buckets.reset();
+    buckets = allocate_aligned_array<Bucket>(num_buckets, use_huge_pages);
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (std::size_t bucket_idx{0}; bucket_idx < num_buckets; ++bucket_idx)
+    {
+        for (auto &slot : buckets[bucket_idx].slots)
+        {
+            slot.key_xor_data.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+void TranspositionTable::new_search()
+{
+    generation = (generation + 1) & GENERATION_MASK;
+}
+
+std::optional<TranspositionTableEntry> TranspositionTable::probe(ZobristKey key) const
+{
+    for (const auto &slot : get_bucket(key).slots)
+    {
+        const auto data{slot.data.load(std::memory_order_relaxed)};
+        const auto key_xor_data{slot.key_xor_data.load(std::memory_order_relaxed)};
+        if (data && (key_xor_data ^ data) == key)
+        {
+            return unpack(data);
+        }
+    }
+
+    return std::nullopt;
+}
+
+void TranspositionTable::store(ZobristKey key, const TranspositionTableEntry &entry)
+{
+    auto &bucket{get_bucket(key)};
+
+    /*
+    Prefer the slot already holding this position, then an empty slot, then the shallowest and oldest entry
+    */
+    Slot *replace_slot{&bucket.slots.front()};
+    auto replace_value{std::numeric_limits<int>::max()};
+    for (auto &slot : bucket.slots)
+    {
+        const auto data{slot.data.load(std::memory_order_relaxed)};
+        const auto key_xor_data{slot.key_xor_data.load(std::memory_order_relaxed)};
+        if (!data)
+        {
+            replace_slot = &slot;
+            break;
+        }
+
+        if ((key_xor_data ^ data) == key)
+        {
+            /*
+            Don't let a shallow search from this iteration throw away a deeper result for the same position
+            */
+            if (entry.bound != Bound::ExactBound && entry.depth < get_depth(data) &&
+                get_generation(data) == generation)
+            {
+                return;
+            }
+
+            replace_slot = &slot;
+            break;
+        }
+
+        const auto age{(generation - get_generation(data)) & GENERATION_MASK};
+        const auto value{get_depth(data) - AGE_DEPTH_WEIGHT * age};
+        if (value < replace_value)
+        {
+            replace_value = value;
+            replace_slot = &slot;
+        }
+    }
+
+    const auto data{pack(entry, generation)};
+    replace_slot->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+    replace_slot->data.store(data, std::memory_order_relaxed);
+}
+
+std::size_t TranspositionTable::get_size_bytes() const
+{
+    return num_buckets * sizeof(Bucket);
+}
+
+std::size_t TranspositionTable::get_hashfull() const
+{
+    static constexpr std::size_t SAMPLE_SLOTS{1000};
+
+    std::size_t num_sampled{0};
+    std::size_t num_full{0};
+    for (std::size_t bucket_idx{0}; bucket_idx < num_buckets && num_sampled < SAMPLE_SLOTS; ++bucket_idx)
+    {
+        for (const auto &slot : buckets[bucket_idx].slots)
+        {
+            const auto data{slot.data.load(std::memory_order_relaxed)};
+            num_full += data && get_generation(data) == generation;
+            ++num_sampled;
+        }
+    }
+
+    return num_full * SAMPLE_SLOTS / num_sampled;
+}
+
+std::uint64_t TranspositionTable::pack(const TranspositionTableEntry &entry, std::uint8_t generation)
+{
+    std::uint64_t data{0};
+    data |= static_cast<std::uint64_t>(entry.move.get_underlying()) << MOVE_SHIFT;
+    data |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.score)) << SCORE_SHIFT;
+    data |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.static_evaluation)) << STATIC_EVALUATION_SHIFT;
+    data |= static_cast<std::uint64_t>(entry.depth) << DEPTH_SHIFT;
+    data |= static_cast<std::uint64_t>(entry.bound & BOUND_MASK) << BOUND_SHIFT;
+    data |= static_cast<std::uint64_t>(generation & GENERATION_MASK) << GENERATION_SHIFT;
+
+    return data;
+}
+
+TranspositionTableEntry TranspositionTable::unpack(std::uint64_t data)
+{
+    return TranspositionTableEntry{
+        Move{static_cast<MoveUnderlying>(data >> MOVE_SHIFT)},
+        static_cast<Evaluation>(static_cast<std::uint16_t>(data >> SCORE_SHIFT)),
+        static_cast<Evaluation>(static_cast<std::uint16_t>(data >> STATIC_EVALUATION_SHIFT)),
+        get_depth(data),
+        Bound((data >> BOUND_SHIFT) & BOUND_MASK),
+    };
+}
+
+std::uint8_t TranspositionTable::get_depth(std::uint64_t data)
+{
+    return static_cast<std::uint8_t>(data >> DEPTH_SHIFT);
+}
+
+std::uint8_t TranspositionTable::get_generation(std::uint64_t data)
+{
+    return (data >> GENERATION_SHIFT) & GENERATION_MASK;
+}
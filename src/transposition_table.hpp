@@ -0,0 +1,113 @@
+#pragma once
+
+#include "memory.hpp"
+#include "move.hpp"
+#include "types.hpp"
+#include "zobrist.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+enum Bound : std::uint8_t
+{
+    NoBound,
+    UpperBound,
+    LowerBound,
+    ExactBound,
+};
+
+struct TranspositionTableEntry
+{
+    Move move;
+    Evaluation score;
+    Evaluation static_evaluation;
+    std::uint8_t depth;
+    Bound bound;
+};
+
+/*
+Shared between search threads without any locking. Each slot stores its key xor'd with its data, so a slot torn by
+two threads writing at once simply fails verification on the next probe instead of returning garbage.
+*/
+class TranspositionTable
+{
+  public:
+    TranspositionTable(std::size_t megabytes, bool use_huge_pages = true);
+
+    /*
+    Not safe to call while other threads are using the table
+    */
+    void resize(std::size_t megabytes, bool use_huge_pages = true);
+    void clear();
+
+    /*
+    Call once per search so older entries become preferred for replacement
+    */
+    void new_search();
+
+    std::optional<TranspositionTableEntry> probe(ZobristKey key) const;
+    void store(ZobristKey key, const TranspositionTableEntry &entry);
+
+    /*
+    Meant to be called straight after making a move, so the bucket is in cache by the time it's probed
+    */
+    void prefetch(ZobristKey key) const;
+
+    std::size_t get_size_bytes() const;
+
+    /*
+    Permille of sampled slots written during the current search
+    */
+    std::size_t get_hashfull() const;
+
+  private:
+    static constexpr auto MOVE_SHIFT{0};
+    static constexpr auto SCORE_SHIFT{16};
+    static constexpr auto STATIC_EVALUATION_SHIFT{32};
+    static constexpr auto DEPTH_SHIFT{48};
+    static constexpr auto BOUND_SHIFT{56};
+    static constexpr auto GENERATION_SHIFT{58};
+    static constexpr std::uint8_t BOUND_MASK{0x3};
+    static constexpr std::uint8_t GENERATION_MASK{0x3F};
+
+    /*
+    Age counts for this many plies of depth when choosing which slot to replace
+    */
+    static constexpr auto AGE_DEPTH_WEIGHT{8};
+
+    struct Slot
+    {
+        std::atomic<std::uint64_t> key_xor_data;
+        std::atomic<std::uint64_t> data;
+    };
+
+    struct alignas(CACHE_LINE_BYTES) Bucket
+    {
+        std::array<Slot, CACHE_LINE_BYTES / sizeof(Slot)> slots;
+    };
+    static_assert(sizeof(Bucket) == CACHE_LINE_BYTES);
+
+    static std::uint64_t pack(const TranspositionTableEntry &entry, std::uint8_t generation);
+    static TranspositionTableEntry unpack(std::uint64_t data);
+    static std::uint8_t get_depth(std::uint64_t data);
+    static std::uint8_t get_generation(std::uint64_t data);
+
+    Bucket &get_bucket(ZobristKey key) const;
+
+    AlignedArray<Bucket> buckets;
+    std::size_t num_buckets;
+    std::uint8_t generation;
+};
+
+inline TranspositionTable::Bucket &TranspositionTable::get_bucket(ZobristKey key) const
+{
+    return buckets[key & (num_buckets - 1)];
+}
+
+inline void TranspositionTable::prefetch(ZobristKey key) const
+{
+    __builtin_prefetch(&get_bucket(key));
+}
@@ -16,6 +16,7 @@ using RankUnderlying = std::uint8_t;
 using FileUnderlying = std::uint8_t;
 using SquareUnderlying = std::uint8_t;
 using DirectionUnderlying = std::int8_t;
+using CastlingRightsUnderlying = std::uint8_t;
 
 enum Rank : RankUnderlying
 {
@@ -94,6 +95,24 @@ enum Piece : std::uint8_t
     King,
 };
 
+/*
+Used as bit flags, so a set of rights is just the bitwise or of these
+*/
+enum CastlingRights : CastlingRightsUnderlying
+{
+    NoCastling = 0u,
+    WhiteKingside = 1u << 0,
+    WhiteQueenside = 1u << 1,
+    BlackKingside = 1u << 2,
+    BlackQueenside = 1u << 3,
+    AllCastling = WhiteKingside | WhiteQueenside | BlackKingside | BlackQueenside,
+};
+
+inline constexpr Player opponent_of(Player player)
+{
+    return player == Player::White ? Player::Black : Player::White;
+}
+
 inline constexpr BitBoard rank_to_bit_board(Rank rank)
 {
     return BitBoard{0xFF} << (BOARD_WIDTH * rank);
@@ -109,6 +128,12 @@ inline constexpr BitBoard square_to_bit_board(Square square)
     return BitBoard{1} << square;
 }
 
+/*
+Masks out squares that would wrap around to the other side of the board when shifted east or west
+*/
+inline constexpr auto NOT_A_FILE_BIT_BOARD{~file_to_bit_board(File::FA)};
+inline constexpr auto NOT_H_FILE_BIT_BOARD{~file_to_bit_board(File::FH)};
+
 template <Direction direction> inline constexpr BitBoard direction_shift(BitBoard bit_board)
 {
     if constexpr (direction > 0)
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "types.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+using ZobristKey = std::uint64_t;
+
+/*
+Random keys are generated at compile time, so every build hashes positions identically
+*/
+class Zobrist
+{
+  public:
+    static ZobristKey get_piece_key(Player player, Piece piece, SquareUnderlying square);
+    static ZobristKey get_black_to_move_key();
+    static ZobristKey get_castling_rights_key(CastlingRightsUnderlying castling_rights);
+    static ZobristKey get_en_passant_key(BitBoard en_passant_bit_board);
+
+  private:
+    static constexpr auto NUM_PLAYERS{2};
+    static constexpr auto NUM_PIECES{6};
+    static constexpr auto NUM_CASTLING_RIGHTS{CastlingRights::AllCastling + 1};
+
+    using PieceKeysLookup = std::array<std::array<Lookup<ZobristKey>, NUM_PIECES>, NUM_PLAYERS>;
+    using CastlingRightsKeysLookup = Lookup<ZobristKey, NUM_CASTLING_RIGHTS>;
+    using EnPassantKeysLookup = Lookup<ZobristKey, BOARD_WIDTH>;
+
+    /*
+    SplitMix64, chosen because it is tiny and good enough for hashing
+    */
+    static consteval ZobristKey next_random(ZobristKey &state);
+
+    static consteval PieceKeysLookup create_piece_keys_lookup();
+    static consteval ZobristKey create_black_to_move_key();
+    static consteval CastlingRightsKeysLookup create_castling_rights_keys_lookup();
+    static consteval EnPassantKeysLookup create_en_passant_keys_lookup();
+
+    static const PieceKeysLookup PIECE_KEYS_LOOKUP;
+    static const ZobristKey BLACK_TO_MOVE_KEY;
+    static const CastlingRightsKeysLookup CASTLING_RIGHTS_KEYS_LOOKUP;
+    static const EnPassantKeysLookup EN_PASSANT_KEYS_LOOKUP;
+
+    /*
+    Each table gets its own seed so they never share keys
+    */
+    static constexpr ZobristKey PIECE_KEYS_SEED{0x9E3779B97F4A7C15};
+    static constexpr ZobristKey BLACK_TO_MOVE_KEY_SEED{0xD1B54A32D192ED03};
+    static constexpr ZobristKey CASTLING_RIGHTS_KEYS_SEED{0x8CB92BA72F3D8DD7};
+    static constexpr ZobristKey EN_PASSANT_KEYS_SEED{0xABC98388FB8FAC03};
+};
+
+inline ZobristKey Zobrist::get_piece_key(Player player, Piece piece, SquareUnderlying square)
+{
+    return PIECE_KEYS_LOOKUP[player][piece][square];
+}
+
+inline ZobristKey Zobrist::get_black_to_move_key()
+{
+    return BLACK_TO_MOVE_KEY;
+}
+
+inline ZobristKey Zobrist::get_castling_rights_key(CastlingRightsUnderlying castling_rights)
+{
+    return CASTLING_RIGHTS_KEYS_LOOKUP[castling_rights];
+}
+
+/*
+Only the file matters, and no en passant square hashes to 0
+*/
+inline ZobristKey Zobrist::get_en_passant_key(BitBoard en_passant_bit_board)
+{
+    if (!en_passant_bit_board)
+    {
+        return 0;
+    }
+
+    return EN_PASSANT_KEYS_LOOKUP[square_to_file(Square(std::countr_zero(en_passant_bit_board)))];
+}
+
+consteval ZobristKey Zobrist::next_random(ZobristKey &state)
+{
+    state += 0x9E3779B97F4A7C15;
+    auto random{state};
+    random = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9;
+    random = (random ^ (random >> 27)) * 0x94D049BB133111EB;
+
+    return random ^ (random >> 31);
+}
+
+consteval Zobrist::PieceKeysLookup Zobrist::create_piece_keys_lookup()
+{
+    PieceKeysLookup piece_keys_lookup{};
+    ZobristKey state{PIECE_KEYS_SEED};
+    for (auto &player_keys : piece_keys_lookup)
+    {
+        for (auto &piece_keys : player_keys)
+        {
+            for (auto &key : piece_keys)
+            {
+                key = next_random(state);
+            }
+        }
+    }
+
+    return piece_keys_lookup;
+}
+
+consteval ZobristKey Zobrist::create_black_to_move_key()
+{
+    ZobristKey state{BLACK_TO_MOVE_KEY_SEED};
+
+    return next_random(state);
+}
+
+consteval Zobrist::CastlingRightsKeysLookup Zobrist::create_castling_rights_keys_lookup()
+{
+    /*
+    Keys for combined rights are the xor of the individual rights, so losing one right is a single xor
+    */
+    CastlingRightsKeysLookup castling_rights_keys_lookup{};
+    ZobristKey state{CASTLING_RIGHTS_KEYS_SEED};
+    std::array<ZobristKey, 4> individual_keys{};
+    for (auto &key : individual_keys)
+    {
+        key = next_random(state);
+    }
+
+    for (CastlingRightsUnderlying castling_rights{0}; castling_rights < NUM_CASTLING_RIGHTS; ++castling_rights)
+    {
+        for (std::size_t right{0}; right < individual_keys.size(); ++right)
+        {
+            if (castling_rights & (1u << right))
+            {
+                castling_rights_keys_lookup[castling_rights] ^= individual_keys[right];
+            }
+        }
+    }
+
+    return castling_rights_keys_lookup;
+}
+
+consteval Zobrist::EnPassantKeysLookup Zobrist::create_en_passant_keys_lookup()
+{
+    EnPassantKeysLookup en_passant_keys_lookup{};
+    ZobristKey state{EN_PASSANT_KEYS_SEED};
+    for (auto &key : en_passant_keys_lookup)
+    {
+        key = next_random(state);
+    }
+
+    return en_passant_keys_lookup;
+}
+
+inline constexpr Zobrist::PieceKeysLookup Zobrist::PIECE_KEYS_LOOKUP{create_piece_keys_lookup()};
+inline constexpr ZobristKey Zobrist::BLACK_TO_MOVE_KEY{create_black_to_move_key()};
+inline constexpr Zobrist::CastlingRightsKeysLookup Zobrist::CASTLING_RIGHTS_KEYS_LOOKUP{
+    create_castling_rights_keys_lookup()};
+inline constexpr Zobrist::EnPassantKeysLookup Zobrist::EN_PASSANT_KEYS_LOOKUP{create_en_passant_keys_lookup()};
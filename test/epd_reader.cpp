@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "epd_reader.hpp"
+#include "newline_scan.hpp"
+#include "temporary_file.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/*
+Every kind of line, with the clocks of each position as a label to check it was read from the right line
+*/
+const std::string LINES{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+                        "\n"
+                        "r3k2r/8/8/8/8/8/8/R3K2R b Kq - 2 3\r\n"
+                        "4k3/8/8/8/8/8/8/4K3 w - - bm Ke2; id \"lone kings\";\n"
+                        "4k3/8/8/8/8/8/8/4K3 w - - hmvc 4; fmvn 5;\n"
+                        "not a position\n"
+                        "4k3/8/8/8/4P3/8/8/4K3 b - e3 6 7"};
+} // namespace
+
+TEST(epd_reader, reads_every_kind_of_line)
+{
+    const TemporaryFile file{"lines.epd", LINES};
+    std::vector<std::pair<std::string, std::string>> lines{};
+    std::vector<int> fullmove_counters{};
+    const auto statistics{EpdReader{file.get_path()}.read([&](const EpdLine &line, const FenParser &fen_parser) {
+        lines.emplace_back(line.text, line.operations);
+        fullmove_counters.push_back(fen_parser.get_fullmove_counter());
+    })};
+
+    EXPECT_EQ(5u, statistics.positions);
+    EXPECT_EQ(1u, statistics.invalid_lines);
+
+    const std::vector<std::pair<std::string, std::string>> expected_lines{
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", ""},
+        {"r3k2r/8/8/8/8/8/8/R3K2R b Kq - 2 3", ""},
+        {"4k3/8/8/8/8/8/8/4K3 w - - bm Ke2; id \"lone kings\";", "bm Ke2; id \"lone kings\";"},
+        {"4k3/8/8/8/8/8/8/4K3 w - - hmvc 4; fmvn 5;", "hmvc 4; fmvn 5;"},
+        {"4k3/8/8/8/4P3/8/8/4K3 b - e3 6 7", ""},
+    };
+    EXPECT_EQ(expected_lines, lines);
+    EXPECT_EQ((std::vector<int>{1, 3, 1, 1, 7}), fullmove_counters);
+}
+
+TEST(epd_reader, threads_read_the_same_positions)
+{
+    /* Enough to be split into several chunks, with lines straddling the scan's blocks and the chunk boundaries */
+    static constexpr std::size_t NUM_REPEATS{80000};
+    std::string contents{};
+    for (std::size_t repeat{0}; repeat < NUM_REPEATS; ++repeat)
+    {
+        contents += LINES;
+        contents += '\n';
+    }
+    const TemporaryFile file{"repeated.epd", contents};
+    const EpdReader epd_reader{file.get_path()};
+
+    const auto default_backend{NewlineScan::get_backend()};
+    for (const auto backend : {NewlineScanBackend::ScalarScan, NewlineScanBackend::Avx2Scan})
+    {
+        if (!NewlineScan::is_backend_supported(backend))
+        {
+            continue;
+        }
+        NewlineScan::set_backend(backend);
+
+        std::vector<std::string> lines{};
+        const auto statistics{
+            epd_reader.read([&lines](const EpdLine &line, const FenParser &) { lines.emplace_back(line.text); })};
+        EXPECT_EQ(5 * NUM_REPEATS, statistics.positions) << backend;
+        EXPECT_EQ(NUM_REPEATS, statistics.invalid_lines) << backend;
+
+        ThreadPool thread_pool{4};
+        std::mutex lines_mutex{};
+        std::vector<std::string> thread_lines{};
+        const auto thread_statistics{epd_reader.read(thread_pool, [&](const EpdLine &line, const FenParser &) {
+            const std::lock_guard lock{lines_mutex};
+            thread_lines.emplace_back(line.text);
+        })};
+        EXPECT_EQ(statistics.positions, thread_statistics.positions) << backend;
+        EXPECT_EQ(statistics.invalid_lines, thread_statistics.invalid_lines) << backend;
+
+        std::sort(lines.begin(), lines.end());
+        std::sort(thread_lines.begin(), thread_lines.end());
+        EXPECT_TRUE(lines == thread_lines) << backend;
+    }
+
+    NewlineScan::set_backend(default_backend);
+}
+
+TEST(epd_reader, reads_nothing_from_an_empty_file)
+{
+    const TemporaryFile file{"empty.epd", ""};
+    std::size_t num_lines{0};
+    const auto statistics{
+        EpdReader{file.get_path()}.read([&num_lines](const EpdLine &, const FenParser &) { ++num_lines; })};
+
+    EXPECT_EQ(0u, statistics.positions);
+    EXPECT_EQ(0u, statistics.invalid_lines);
+    EXPECT_EQ(0u, num_lines);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+TEST(fen_parser, parses_every_field)
+{
+    const FenParser fen_parser{"r3k2r/8/8/3pP3/8/8/8/R3K2R w Kq d6 12 34"};
+    EXPECT_EQ(square_to_bit_board(Square::E5), fen_parser.get_piece_bit_board(Player::White, Piece::Pawn));
+    EXPECT_EQ(square_to_bit_board(Square::D5), fen_parser.get_piece_bit_board(Player::Black, Piece::Pawn));
+    EXPECT_EQ(square_to_bit_board(Square::A1) | square_to_bit_board(Square::H1),
+              fen_parser.get_piece_bit_board(Player::White, Piece::Rook));
+    EXPECT_EQ(square_to_bit_board(Square::E8), fen_parser.get_piece_bit_board(Player::Black, Piece::King));
+    EXPECT_EQ(0u, fen_parser.get_piece_bit_board(Player::White, Piece::Queen));
+    EXPECT_EQ(Player::White, fen_parser.get_current_player());
+    EXPECT_EQ(CastlingRights::WhiteKingside | CastlingRights::BlackQueenside, fen_parser.get_castling_rights());
+    EXPECT_EQ(Square::D6, fen_parser.get_en_passant_square());
+    EXPECT_EQ(12, fen_parser.get_halfmove_clock());
+    EXPECT_EQ(34, fen_parser.get_fullmove_counter());
+}
+
+TEST(fen_parser, clocks_are_optional)
+{
+    const FenParser fen_parser{"4k3/8/8/8/8/8/8/4K3 b - -"};
+    EXPECT_EQ(Player::Black, fen_parser.get_current_player());
+    EXPECT_EQ(CastlingRights::NoCastling, fen_parser.get_castling_rights());
+    EXPECT_FALSE(fen_parser.get_en_passant_square().has_value());
+    EXPECT_EQ(0, fen_parser.get_halfmove_clock());
+    EXPECT_EQ(1, fen_parser.get_fullmove_counter());
+}
+
+TEST(fen_parser, reports_first_invalid_field)
+{
+    const std::vector<std::pair<std::string_view, FenError>> fens{
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::NoFenError},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR/8 w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKXNR w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbq1bnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQ - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBKKBNR w kq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnP/pppppppp/8/8/8/8/PPPPPPP1/RNBQKBNR w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/ppppppp1/8/8/8/8/PPPPPPPP/RNBQKBNp w KQkq - 0 1", FenError::InvalidPiecePlacement},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", FenError::InvalidSideToMove},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkk - 0 1", FenError::InvalidCastlingAbility},
+        {"4k3/8/8/8/8/8/8/4K3 w K - 0 1", FenError::InvalidCastlingAbility},
+        {"4k3/8/8/8/8/8/8/K7 w Q - 0 1", FenError::InvalidCastlingAbility},
+        {"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1", FenError::NoFenError},
+        {"r3k2r/8/8/8/8/8/8/R2K3R w KQkq - 0 1", FenError::InvalidCastlingAbility},
+        {"r3k1r1/8/8/8/8/8/8/R3K2R w KQkq - 0 1", FenError::InvalidCastlingAbility},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e9 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/8/8/8/8/8/3P4/4K3 w - e3 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/8/8/3pP3/8/8/8/4K3 b - d6 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/8/8/4P3/8/8/8/4K3 w - d6 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/8/3n4/3pP3/8/8/8/4K3 w - d6 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/3n4/8/3pP3/8/8/8/4K3 w - d6 0 1", FenError::InvalidEnPassantSquare},
+        {"4k3/8/8/8/3Pp3/8/8/4K3 b - d3 0 1", FenError::NoFenError},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 256 1", FenError::InvalidHalfmoveClock},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0", FenError::InvalidFullmoveCounter},
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 x", FenError::TrailingCharacters},
+    };
+
+    /* One parser for all of them, so nothing from a bad FEN can leak into the next */
+    FenParser fen_parser{};
+    for (const auto &[fen, error] : fens)
+    {
+        EXPECT_EQ(error, fen_parser.parse(fen)) << fen;
+    }
+
+    EXPECT_EQ(FenError::NoFenError, fen_parser.parse("4k3/8/8/8/8/8/8/4K3 w - - 0 1"));
+    EXPECT_EQ(square_to_bit_board(Square::E1), fen_parser.get_piece_bit_board(Player::White, Piece::King));
+    EXPECT_EQ(0u, fen_parser.get_piece_bit_board(Player::White, Piece::Pawn));
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/*
+Each position against the same one with the colours swapped and the board flipped, which any evaluation has to score as
+exact opposites
+*/
+inline const std::vector<std::pair<std::string_view, std::string_view>> MIRRORED_FENS{
+    {"r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+     "rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3"},
+    {"8/5pk1/6p1/8/3P4/8/5PK1/8 w - - 0 1", "8/5pk1/8/3p4/8/6P1/5PK1/8 b - - 0 1"},
+};
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "move_picker.hpp"
+#include "position.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+std::vector<Move> pick_all(const Position &position, std::optional<Move> hash_move,
+                           const MovePicker::KillerMoves &killer_moves, Move countermove = {},
+                           const MoveHistory &move_history = {})
+{
+    const auto check_info{position.get_check_info()};
+    MovePicker move_picker{position, check_info, move_history, hash_move, killer_moves, countermove};
+
+    std::vector<Move> picked_moves{};
+    while (const auto move{move_picker.next()})
+    {
+        picked_moves.push_back(*move);
+    }
+
+    return picked_moves;
+}
+
+std::vector<Move> sorted(std::vector<Move> moves)
+{
+    std::sort(moves.begin(), moves.end(),
+              [](Move lhs, Move rhs) { return lhs.get_underlying() < rhs.get_underlying(); });
+
+    return moves;
+}
+} // namespace
+
+TEST(move_picker, picks_every_legal_move_once)
+{
+    static const std::vector<std::string_view> FENS{
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    };
+
+    for (const auto fen : FENS)
+    {
+        const Position position{FenParser{fen}};
+        const auto moves{position.get_moves()};
+        const auto expected_moves{sorted(std::vector<Move>{moves.begin(), moves.end()})};
+
+        /*
+        Once with nothing to go on, then with a real move and an illegal one in every slot
+        */
+        EXPECT_EQ(expected_moves, sorted(pick_all(position, std::nullopt, {}))) << fen;
+
+        const Move illegal_move{Square::A1, Square::H8};
+        const MovePicker::KillerMoves killer_moves{moves[moves.size() - 1], illegal_move};
+        EXPECT_EQ(expected_moves, sorted(pick_all(position, moves[0], killer_moves, moves[moves.size() / 2]))) << fen;
+        EXPECT_EQ(expected_moves, sorted(pick_all(position, illegal_move, killer_moves, illegal_move))) << fen;
+        EXPECT_EQ(expected_moves, sorted(pick_all(position, std::nullopt, killer_moves, killer_moves[0]))) << fen;
+    }
+}
+
+TEST(move_picker, picks_in_stages)
+{
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    const Position position{FenParser{FEN}};
+
+    const Move hash_move{Square::E1, Square::G1, MoveFlag::Castle};
+    const Move killer_move{Square::A2, Square::A3};
+    const auto picked_moves{pick_all(position, hash_move, {killer_move, Move{}})};
+
+    ASSERT_FALSE(picked_moves.empty());
+    EXPECT_EQ(hash_move, picked_moves.front());
+
+    /*
+    Every capture comes before the killer, which comes before every other quiet move
+    */
+    const auto killer_it{std::find(picked_moves.begin(), picked_moves.end(), killer_move)};
+    ASSERT_NE(picked_moves.end(), killer_it);
+    for (auto move_it{picked_moves.begin() + 1}; move_it != picked_moves.end(); ++move_it)
+    {
+        const auto is_noisy{position.get_captured_piece(*move_it).has_value() || move_it->is_promotion()};
+        EXPECT_EQ(is_noisy, move_it < killer_it) << *move_it;
+    }
+
+    /*
+    The bishop on a6 is the most valuable victim
+    */
+    EXPECT_EQ(Square::A6, picked_moves[1].get_to());
+}
+
+TEST(move_picker, orders_captures_by_mvv_lva)
+{
+    /*
+    The queen on d5 can be taken by the pawn, the knight or the rook, and the rook on h5 by the queen
+    */
+    static constexpr auto FEN{"4k3/8/8/3q3r/4P3/2N5/8/3RK2Q w - - 0 1"};
+    const Position position{FenParser{FEN}};
+    const auto picked_moves{pick_all(position, std::nullopt, {})};
+
+    ASSERT_GT(picked_moves.size(), 4u);
+    EXPECT_EQ(Move(Square::E4, Square::D5), picked_moves[0]);
+    EXPECT_EQ(Move(Square::C3, Square::D5), picked_moves[1]);
+    EXPECT_EQ(Move(Square::D1, Square::D5), picked_moves[2]);
+    EXPECT_EQ(Move(Square::H1, Square::H5), picked_moves[3]);
+}
+
+TEST(move_picker, orders_quiets_by_history_after_countermove)
+{
+    static constexpr auto FEN{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+    const Position position{FenParser{FEN}};
+
+    const Move countermove{Square::G1, Square::F3};
+    const Move history_move{Square::E2, Square::E4, MoveFlag::DoublePush};
+    const Move other_history_move{Square::D2, Square::D4, MoveFlag::DoublePush};
+    MoveHistory move_history{};
+    move_history.update_history_score(Player::White, history_move, 200);
+    move_history.update_history_score(Player::White, other_history_move, 100);
+    move_history.update_history_score(Player::Black, Move{Square::A2, Square::A3}, 300);
+
+    const auto picked_moves{pick_all(position, std::nullopt, {}, countermove, move_history)};
+
+    ASSERT_GT(picked_moves.size(), 3u);
+    EXPECT_EQ(countermove, picked_moves[0]);
+    EXPECT_EQ(history_move, picked_moves[1]);
+    EXPECT_EQ(other_history_move, picked_moves[2]);
+    EXPECT_EQ(1, std::count(picked_moves.begin(), picked_moves.end(), countermove));
+}
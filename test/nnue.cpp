@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "mirrored_fens.hpp"
+#include "nnue.hpp"
+#include "position.hpp"
+#include "temporary_file.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+const std::vector<std::string_view> FENS{
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+};
+
+template <typename T>
+void append_random_values(std::string &contents, std::size_t size, int min_value, int max_value, std::mt19937 &random)
+{
+    std::uniform_int_distribution distribution{min_value, max_value};
+    for (std::size_t idx{0}; idx < size; ++idx)
+    {
+        const auto value{static_cast<T>(distribution(random))};
+        contents.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+}
+
+/*
+Small enough weights that most neurons are somewhere between off and saturated, so every layer matters
+*/
+const Nnue &get_random_nnue()
+{
+    static const auto nnue{[] {
+        std::string contents(Nnue::HEADER_BYTES, '\0');
+        std::copy(Nnue::MAGIC.begin(), Nnue::MAGIC.end(), contents.begin());
+
+        std::mt19937 random{0};
+        append_random_values<std::int16_t>(contents, Nnue::NUM_FEATURES * Nnue::ACCUMULATOR_SIZE, -64, 64, random);
+        append_random_values<std::int16_t>(contents, Nnue::ACCUMULATOR_SIZE, 0, 64, random);
+        append_random_values<std::int8_t>(contents, Nnue::NUM_PERSPECTIVES * Nnue::ACCUMULATOR_SIZE * Nnue::HIDDEN_SIZE,
+                                          -8, 8, random);
+        append_random_values<std::int32_t>(contents, Nnue::HIDDEN_SIZE, -2048, 2048, random);
+        append_random_values<std::int8_t>(contents, Nnue::HIDDEN_SIZE * Nnue::HIDDEN_SIZE, -32, 32, random);
+        append_random_values<std::int32_t>(contents, Nnue::HIDDEN_SIZE, -2048, 2048, random);
+        append_random_values<std::int8_t>(contents, Nnue::HIDDEN_SIZE, -64, 64, random);
+        append_random_values<std::int32_t>(contents, 1, -256, 256, random);
+
+        /* Removed again as soon as the network is loaded, since mapped pages stay readable once the file is gone */
+        const TemporaryFile file{"random.nnue", contents};
+
+        return std::make_unique<Nnue>(file.get_path());
+    }()};
+
+    return *nnue;
+}
+
+/*
+Random legal moves, so every kind of move gets made and unmade
+*/
+std::vector<Move> get_random_moves(const Position &start_position, std::size_t num_moves, std::mt19937 &random)
+{
+    auto position{start_position};
+    std::vector<Move> moves{};
+    for (std::size_t idx{0}; idx < num_moves; ++idx)
+    {
+        const auto legal_moves{position.get_moves()};
+        if (!legal_moves.size())
+        {
+            break;
+        }
+
+        const auto move{legal_moves[std::uniform_int_distribution<std::size_t>{0, legal_moves.size() - 1}(random)]};
+        position.make_move(move);
+        moves.push_back(move);
+    }
+
+    return moves;
+}
+} // namespace
+
+TEST(nnue, incremental_matches_refresh)
+{
+    static constexpr std::size_t NUM_MOVES{60};
+    const auto &nnue{get_random_nnue()};
+    std::mt19937 random{0};
+    for (const auto fen : FENS)
+    {
+        for (auto playout{0}; playout < 20; ++playout)
+        {
+            Position position{FenParser{fen}};
+            position.set_nnue(&nnue);
+            const auto moves{get_random_moves(position, NUM_MOVES, random)};
+
+            std::vector<Evaluation> evaluations{position.get_evaluation()};
+            for (const auto move : moves)
+            {
+                position.make_move(move);
+                auto refreshed{position};
+                refreshed.set_nnue(&nnue);
+                ASSERT_EQ(refreshed.get_evaluation(), position.get_evaluation()) << fen << ' ' << move;
+                evaluations.push_back(position.get_evaluation());
+            }
+
+            for (auto move_it{moves.rbegin()}; move_it != moves.rend(); ++move_it)
+            {
+                evaluations.pop_back();
+                position.unmake_move(*move_it);
+                ASSERT_EQ(evaluations.back(), position.get_evaluation()) << fen << ' ' << *move_it;
+            }
+        }
+    }
+}
+
+TEST(nnue, backends_agree)
+{
+    const auto &nnue{get_random_nnue()};
+    const auto default_backend{Nnue::get_backend()};
+    for (const auto backend : {NnueBackend::SseNnue, NnueBackend::Avx2Nnue})
+    {
+        if (!Nnue::is_backend_supported(backend))
+        {
+            continue;
+        }
+
+        std::mt19937 random{0};
+        for (const auto fen : FENS)
+        {
+            Position position{FenParser{fen}};
+            for (const auto move : get_random_moves(position, 40, random))
+            {
+                position.make_move(move);
+
+                Nnue::set_backend(NnueBackend::ScalarNnue);
+                position.set_nnue(&nnue);
+                const auto scalar_evaluation{position.get_evaluation()};
+
+                Nnue::set_backend(backend);
+                position.set_nnue(&nnue);
+                EXPECT_EQ(scalar_evaluation, position.get_evaluation()) << backend << ' ' << fen;
+            }
+        }
+    }
+
+    Nnue::set_backend(default_backend);
+}
+
+TEST(nnue, evaluation_is_symmetric)
+{
+    const auto &nnue{get_random_nnue()};
+    for (const auto &[fen, mirrored_fen] : MIRRORED_FENS)
+    {
+        Position position{FenParser{fen}};
+        position.set_nnue(&nnue);
+        Position mirrored_position{FenParser{mirrored_fen}};
+        mirrored_position.set_nnue(&nnue);
+        EXPECT_EQ(position.get_evaluation(), -mirrored_position.get_evaluation()) << fen;
+    }
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "packed_position.hpp"
+#include "packed_position_file.hpp"
+#include "position.hpp"
+#include "temporary_file.hpp"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+const std::vector<std::string_view> FENS{
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "8/5k2/3p4/1p1Pp2p/pP2Pp1P/P4P1K/8/8 b - - 99 50",
+    "4k3/8/8/8/8/8/8/4K3 w - - 0 300",
+};
+
+struct RandomPosition
+{
+    PackedPosition packed_position;
+    ZobristKey key;
+};
+
+/*
+Every position on the way through some random games, so there's every mix of pieces and rights
+*/
+std::vector<RandomPosition> get_random_positions(std::size_t num_games)
+{
+    std::mt19937 random{0};
+    std::vector<RandomPosition> positions{};
+    for (std::size_t game{0}; game < num_games; ++game)
+    {
+        Position position{};
+        for (auto ply{0}; ply < 100; ++ply)
+        {
+            positions.push_back({position.pack(), position.get_key()});
+            const auto moves{position.get_moves()};
+            if (!moves.size())
+            {
+                break;
+            }
+            position.make_move(moves[std::uniform_int_distribution<std::size_t>{0, moves.size() - 1}(random)]);
+        }
+    }
+
+    return positions;
+}
+} // namespace
+
+TEST(packed_position, unpacks_to_fen)
+{
+    for (const auto fen : FENS)
+    {
+        const FenParser fen_parser{fen};
+        const Position position{fen_parser};
+        const auto packed_position{position.pack()};
+
+        const auto piece_bit_boards{packed_position.unpack_piece_bit_boards()};
+        for (const auto player : {Player::White, Player::Black})
+        {
+            for (const auto piece : {Piece::Pawn, Piece::Knight, Piece::Bishop, Piece::Rook, Piece::Queen, Piece::King})
+            {
+                EXPECT_EQ(fen_parser.get_piece_bit_board(player, piece), piece_bit_boards[player][piece]) << fen;
+            }
+        }
+        EXPECT_EQ(fen_parser.get_current_player(), packed_position.get_current_player()) << fen;
+        EXPECT_EQ(fen_parser.get_castling_rights(), packed_position.get_castling_rights()) << fen;
+        EXPECT_EQ(fen_parser.get_en_passant_square(), packed_position.get_en_passant_square()) << fen;
+        EXPECT_EQ(fen_parser.get_halfmove_clock(), packed_position.get_halfmove_clock()) << fen;
+        EXPECT_EQ(fen_parser.get_fullmove_counter(), packed_position.get_fullmove_counter()) << fen;
+
+        const Position unpacked_position{packed_position};
+        EXPECT_EQ(position.get_key(), unpacked_position.get_key()) << fen;
+        EXPECT_EQ(position.get_evaluation(), unpacked_position.get_evaluation()) << fen;
+        EXPECT_EQ(position.get_moves().size(), unpacked_position.get_moves().size()) << fen;
+    }
+}
+
+TEST(packed_position, backends_agree)
+{
+    for (const auto &[packed_position, key] : get_random_positions(20))
+    {
+        const Position position{packed_position};
+        EXPECT_EQ(key, position.get_key());
+        EXPECT_EQ(packed_position, position.pack());
+
+        if (PackedPosition::is_backend_supported(PackingBackend::Bmi2Packing))
+        {
+            EXPECT_EQ(packed_position.unpack_piece_bit_boards<PackingBackend::ScalarPacking>(),
+                      packed_position.unpack_piece_bit_boards<PackingBackend::Bmi2Packing>());
+        }
+    }
+}
+
+TEST(packed_position, rejects_positions_that_cant_be_built)
+{
+    for (const auto fen : FENS)
+    {
+        EXPECT_TRUE(Position{FenParser{fen}}.pack().is_valid()) << fen;
+    }
+
+    /* None of these could come from a FEN, but a corrupt file could hold any of them */
+    const auto kings_bit_boards{Position{FenParser{"4k3/8/8/8/8/8/8/4K3 w - - 0 1"}}.pack().unpack_piece_bit_boards()};
+    auto no_king_bit_boards{kings_bit_boards};
+    no_king_bit_boards[Player::Black][Piece::King] = 0;
+    auto back_rank_pawn_bit_boards{kings_bit_boards};
+    back_rank_pawn_bit_boards[Player::White][Piece::Pawn] = square_to_bit_board(Square::A8);
+    auto pushed_pawn_bit_boards{kings_bit_boards};
+    pushed_pawn_bit_boards[Player::Black][Piece::Pawn] = square_to_bit_board(Square::D5);
+
+    std::array<std::uint8_t, sizeof(PackedPosition)> all_ones{};
+    all_ones.fill(0xFF);
+
+    const std::vector<PackedPosition> packed_positions{
+        {no_king_bit_boards, Player::White, CastlingRights::NoCastling, std::nullopt, 0, 1},
+        {back_rank_pawn_bit_boards, Player::White, CastlingRights::NoCastling, std::nullopt, 0, 1},
+        {kings_bit_boards, Player::White, CastlingRights::WhiteKingside, std::nullopt, 0, 1},
+        {pushed_pawn_bit_boards, Player::White, CastlingRights::NoCastling, Square::E6, 0, 1},
+        {pushed_pawn_bit_boards, Player::Black, CastlingRights::NoCastling, Square::D6, 0, 1},
+        std::bit_cast<PackedPosition>(all_ones),
+    };
+    for (const auto &packed_position : packed_positions)
+    {
+        EXPECT_FALSE(packed_position.is_valid());
+        EXPECT_THROW(Position{packed_position}, std::logic_error);
+    }
+
+    EXPECT_TRUE(PackedPosition(pushed_pawn_bit_boards, Player::White, CastlingRights::NoCastling, Square::D6, 0, 1)
+                    .is_valid());
+}
+
+TEST(packed_position, file_is_read_by_index)
+{
+    const auto positions{get_random_positions(5)};
+    const TemporaryFile file{"positions.bin", ""};
+    {
+        PackedPositionWriter writer{file.get_path()};
+        for (const auto &[packed_position, key] : positions)
+        {
+            writer.write(packed_position);
+        }
+    }
+    EXPECT_EQ(positions.size() * sizeof(PackedPosition), std::filesystem::file_size(file.get_path()));
+
+    const PackedPositionReader reader{file.get_path()};
+    ASSERT_EQ(positions.size(), reader.get_num_positions());
+    for (auto position_idx{positions.size()}; position_idx-- > 0;)
+    {
+        EXPECT_EQ(positions[position_idx].packed_position, reader.get_packed_position(position_idx));
+    }
+}
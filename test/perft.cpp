@@ -1,14 +1,17 @@
 #include <gtest/gtest.h>
 
 #include "fen_parser.hpp"
+#include "perft.hpp"
+#include "perft_cache.hpp"
 #include "position.hpp"
+#include "thread_pool.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <span>
 #include <string_view>
 
 void test_position(std::string_view fen, std::span<const std::uint64_t> num_nodes);
-std::uint64_t perft_impl(Position &position, std::uint8_t depth);
 
 TEST(perft, starting_position)
 {
@@ -18,41 +21,62 @@ TEST(perft, starting_position)
     test_position(FEN, NUM_NODES);
 }
 
-void test_position(std::string_view fen, std::span<const std::uint64_t> num_nodes)
+TEST(perft, kiwipete)
 {
-    const FenParser fen_parser{fen};
-    Position position{fen_parser};
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    static const std::vector<std::uint64_t> NUM_NODES{1, 48, 2039, 97862, 4085603, 193690690};
+    test_position(FEN, NUM_NODES);
+}
 
-    for (std::uint8_t depth{0}; depth < num_nodes.size(); ++depth)
-    {
-        EXPECT_EQ(num_nodes[depth], perft_impl(position, depth));
-    }
+TEST(perft, discovered_checks_and_en_passant_pins)
+{
+    static constexpr auto FEN{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"};
+    static const std::vector<std::uint64_t> NUM_NODES{1, 14, 191, 2812, 43238, 674624, 11030083};
+    test_position(FEN, NUM_NODES);
 }
 
-std::uint64_t perft_impl(Position &position, std::uint8_t depth)
+TEST(perft, promotions_out_of_check)
 {
-    if (depth == 0)
-    {
-        return 1;
-    }
+    static constexpr auto FEN{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"};
+    static const std::vector<std::uint64_t> NUM_NODES{1, 6, 264, 9467, 422333, 15833292};
+    test_position(FEN, NUM_NODES);
+}
 
-    const auto moves{position.get_moves()};
-    if (depth == 1)
-    {
-        return moves.size();
-    }
+TEST(perft, pinned_promotions)
+{
+    static constexpr auto FEN{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+    static const std::vector<std::uint64_t> NUM_NODES{1, 44, 1486, 62379, 2103487, 89941194};
+    test_position(FEN, NUM_NODES);
+}
+
+void test_position(std::string_view fen, std::span<const std::uint64_t> num_nodes)
+{
+    const FenParser fen_parser{fen};
+    const Position position{fen_parser};
+
+    static constexpr std::size_t CACHE_MEGABYTES{256};
+    ThreadPool thread_pool{};
+    PerftCache cache{CACHE_MEGABYTES};
+    Perft perft{thread_pool, &cache};
 
-    std::uint64_t node_count{0};
-    for (const auto &move : moves)
+    /*
+    Anything deeper takes far too long even with transpositions cached
+    */
+    static constexpr std::size_t MAX_DEPTH{6};
+
+    /*
+    Too few subtrees transpose any shallower to be sure of a hit
+    */
+    static constexpr std::uint8_t MIN_CACHE_HIT_DEPTH{5};
+    for (std::uint8_t depth{0}; depth < std::min(num_nodes.size(), MAX_DEPTH + 1); ++depth)
     {
-        (void)move;
-        /*
-        TODO
-        */
-        // position.make_move(move);
-        // node_count += perft_impl(position, depth - 1);
-        // position.unmake_move(move);
-    }
+        EXPECT_EQ(num_nodes[depth], perft.count(position, depth));
 
-    return node_count;
+        const auto statistics{perft.get_statistics()};
+        EXPECT_LE(statistics.cache_hits, statistics.cache_probes);
+        if (depth >= MIN_CACHE_HIT_DEPTH)
+        {
+            EXPECT_GT(statistics.cache_hits, 0u) << static_cast<int>(depth);
+        }
+    }
 }
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "pgn_reader.hpp"
+#include "position.hpp"
+#include "temporary_file.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/*
+A game with comments, NAGs, an escape line and nested variations, one from a FEN without a Result tag, one with an
+illegal move followed by a comment that looks like a tag, and one that runs out without a termination marker
+*/
+const std::string GAMES{"[Event \"Test\"]\n"
+                        "[White \"A\"]\n"
+                        "[Result \"1-0\"]\n"
+                        "\n"
+                        "1. e4 {best by test,\n"
+                        "[spanning lines]} e5 2.Nf3 $1 Nc6 (2... d6 3. d4 (3. Bc4) exd4) 3. Bb5 a6 ; to the end\n"
+                        "% escaped\n"
+                        "4. Ba4 1-0\n"
+                        "\n"
+                        "[FEN \"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1\"]\n"
+                        "[SetUp \"1\"]\n"
+                        "\n"
+                        "1. e4 Kd7 2. Kd2 *\r\n"
+                        "\r\n"
+                        "[Result \"0-1\"]\n"
+                        "\n"
+                        "1. e4 e5 2. Ke3 {skipped along with the rest of the game,\n"
+                        "[Event \"but not a tag\"]\n"
+                        "Nf6} Nf6 0-1\n"
+                        "\n"
+                        "[Result \"1/2-1/2\"]\n"
+                        "\n"
+                        "1. d4 d5\n"};
+
+std::string to_string(std::optional<Move> move)
+{
+    std::ostringstream move_string{};
+    if (move.has_value())
+    {
+        move_string << *move;
+    }
+
+    return move_string.str();
+}
+
+std::string find_san_move(std::string_view fen, std::string_view san)
+{
+    return to_string(PgnReader::find_san_move(Position{FenParser{fen}}, san));
+}
+} // namespace
+
+TEST(pgn_reader, finds_san_moves)
+{
+    const std::string start_fen{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+    EXPECT_EQ("E2E4", find_san_move(start_fen, "e4"));
+    EXPECT_EQ("G1F3", find_san_move(start_fen, "Nf3+!?"));
+    EXPECT_EQ("", find_san_move(start_fen, "e5"));
+    EXPECT_EQ("", find_san_move(start_fen, "Nd4"));
+    EXPECT_EQ("", find_san_move(start_fen, "not a move"));
+
+    const std::string knights_fen{"4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1"};
+    EXPECT_EQ("", find_san_move(knights_fen, "Nd2"));
+    EXPECT_EQ("B1D2", find_san_move(knights_fen, "Nbd2"));
+    EXPECT_EQ("F1D2", find_san_move(knights_fen, "Nfd2"));
+    EXPECT_EQ("F1D2", find_san_move(knights_fen, "Nf1d2"));
+
+    const std::string rooks_fen{"4k3/8/8/8/8/R7/8/R3K3 w - - 0 1"};
+    EXPECT_EQ("", find_san_move(rooks_fen, "Ra2"));
+    EXPECT_EQ("A1A2", find_san_move(rooks_fen, "R1a2"));
+    EXPECT_EQ("A3A2", find_san_move(rooks_fen, "R3a2"));
+
+    const std::string promotion_fen{"r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1"};
+    EXPECT_EQ("B7B8q", find_san_move(promotion_fen, "b8=Q"));
+    EXPECT_EQ("B7B8n", find_san_move(promotion_fen, "b8N+"));
+    EXPECT_EQ("B7A8r", find_san_move(promotion_fen, "bxa8=R"));
+    EXPECT_EQ("", find_san_move(promotion_fen, "b8"));
+
+    const std::string castling_fen{"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1"};
+    EXPECT_EQ("E1G1", find_san_move(castling_fen, "O-O"));
+    EXPECT_EQ("E1C1", find_san_move(castling_fen, "0-0-0"));
+    EXPECT_EQ("E8C8", find_san_move("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1", "O-O-O#"));
+
+    const auto en_passant_move{
+        PgnReader::find_san_move(Position{FenParser{"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1"}}, "exd6")};
+    ASSERT_TRUE(en_passant_move.has_value());
+    EXPECT_EQ(MoveFlag::EnPassant, en_passant_move->get_flag());
+}
+
+TEST(pgn_reader, replays_games)
+{
+    const TemporaryFile file{"games.pgn", GAMES};
+    for (const auto read_variations : {false, true})
+    {
+        std::vector<std::pair<std::string, std::size_t>> moves{};
+        std::vector<PgnResult> results{};
+        std::vector<std::size_t> num_plies{};
+        std::vector<ZobristKey> keys{};
+        std::vector<std::string> white_players{};
+        const auto statistics{PgnReader{file.get_path(), PgnOptions{read_variations}}.read(
+            [&moves](const PgnGame &game, const Position &, Move move) {
+                moves.emplace_back(to_string(move), game.variation_depth);
+            },
+            [&](const PgnGame &game, const Position &position) {
+                results.push_back(game.result);
+                num_plies.push_back(game.num_plies);
+                keys.push_back(position.get_key());
+                white_players.emplace_back(game.get_tag("White"));
+            })};
+
+        EXPECT_EQ(3u, statistics.games);
+        EXPECT_EQ(1u, statistics.invalid_games);
+        EXPECT_EQ(statistics.moves, moves.size());
+        EXPECT_EQ((std::vector<PgnResult>{PgnResult::WhiteWin, PgnResult::UnknownResult, PgnResult::Draw}), results);
+        EXPECT_EQ((std::vector<std::size_t>{7, 3, 2}), num_plies);
+        EXPECT_EQ((std::vector<std::string>{"A", "", ""}), white_players);
+
+        const std::vector<ZobristKey> expected_keys{
+            Position{FenParser{"r1bqkbnr/1ppp1ppp/p1n5/4p3/B3P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 1 4"}}.get_key(),
+            Position{FenParser{"8/3k4/8/8/4P3/8/3K4/8 b - - 2 2"}}.get_key(),
+            Position{FenParser{"rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq d6 0 2"}}.get_key(),
+        };
+        EXPECT_EQ(expected_keys, keys);
+
+        std::vector<std::pair<std::string, std::size_t>> expected_moves{
+            {"E2E4", 0}, {"E7E5", 0}, {"G1F3", 0}, {"B8C6", 0},
+        };
+        if (read_variations)
+        {
+            expected_moves.insert(expected_moves.end(), {{"D7D6", 1}, {"D2D4", 1}, {"F1C4", 2}, {"E5D4", 1}});
+        }
+        expected_moves.insert(expected_moves.end(), {{"F1B5", 0},
+                                                     {"A7A6", 0},
+                                                     {"B5A4", 0},
+                                                     {"E2E4", 0},
+                                                     {"E8D7", 0},
+                                                     {"E1D2", 0},
+                                                     {"E2E4", 0},
+                                                     {"E7E5", 0},
+                                                     {"D2D4", 0},
+                                                     {"D7D5", 0}});
+        EXPECT_EQ(expected_moves, moves) << read_variations;
+    }
+}
+
+TEST(pgn_reader, replays_games_longer_than_the_undo_stack)
+{
+    /* The knights go out and back, ending where they started */
+    static constexpr std::size_t NUM_ROUNDS{400};
+    std::string contents{"[Result \"*\"]\n\n"};
+    for (std::size_t round{0}; round < NUM_ROUNDS; ++round)
+    {
+        contents += "Nf3 Nf6 Ng1 Ng8\n";
+    }
+    contents += "*\n";
+    const TemporaryFile file{"long.pgn", contents};
+
+    std::vector<ZobristKey> keys{};
+    const auto statistics{PgnReader{file.get_path()}.read(
+        {}, [&keys](const PgnGame &game, const Position &position) {
+            EXPECT_EQ(4 * NUM_ROUNDS, game.num_plies);
+            keys.push_back(position.get_key());
+        })};
+
+    EXPECT_EQ(1u, statistics.games);
+    EXPECT_EQ(0u, statistics.invalid_games);
+    EXPECT_EQ(4 * NUM_ROUNDS, statistics.moves);
+    EXPECT_EQ(std::vector<ZobristKey>{Position{}.get_key()}, keys);
+}
+
+TEST(pgn_reader, threads_replay_the_same_games)
+{
+    /* Enough to be split into several chunks */
+    static constexpr std::size_t NUM_REPEATS{10000};
+    std::string contents{};
+    for (std::size_t repeat{0}; repeat < NUM_REPEATS; ++repeat)
+    {
+        contents += GAMES;
+        contents += '\n';
+    }
+    const TemporaryFile file{"repeated.pgn", contents};
+    const PgnReader pgn_reader{file.get_path(), PgnOptions{true}};
+
+    std::vector<ZobristKey> keys{};
+    const auto statistics{pgn_reader.read(
+        {}, [&keys](const PgnGame &, const Position &position) { keys.push_back(position.get_key()); })};
+    EXPECT_EQ(3 * NUM_REPEATS, statistics.games);
+    EXPECT_EQ(NUM_REPEATS, statistics.invalid_games);
+
+    ThreadPool thread_pool{4};
+    std::mutex keys_mutex{};
+    std::vector<ZobristKey> thread_keys{};
+    const auto thread_statistics{pgn_reader.read(thread_pool, {}, [&](const PgnGame &, const Position &position) {
+        const std::lock_guard lock{keys_mutex};
+        thread_keys.push_back(position.get_key());
+    })};
+    EXPECT_EQ(statistics.games, thread_statistics.games);
+    EXPECT_EQ(statistics.moves, thread_statistics.moves);
+    EXPECT_EQ(statistics.invalid_games, thread_statistics.invalid_games);
+
+    std::sort(keys.begin(), keys.end());
+    std::sort(thread_keys.begin(), thread_keys.end());
+    EXPECT_TRUE(keys == thread_keys);
+}
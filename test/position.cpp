@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "mirrored_fens.hpp"
+#include "position.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+TEST(position, key_matches_fen_after_en_passant)
+{
+    static constexpr auto FEN{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
+    Position position{FenParser{FEN}};
+    const auto starting_key{position.get_key()};
+    const auto starting_pawn_key{position.get_pawn_key()};
+    const auto starting_evaluation{position.get_evaluation()};
+
+    const std::vector<Move> moves{
+        Move{Square::E2, Square::E4, MoveFlag::DoublePush}, Move{Square::D7, Square::D5, MoveFlag::DoublePush},
+        Move{Square::E4, Square::D5},                       Move{Square::C7, Square::C5, MoveFlag::DoublePush},
+        Move{Square::D5, Square::C6, MoveFlag::EnPassant},
+    };
+    for (const auto move : moves)
+    {
+        position.make_move(move);
+    }
+
+    const Position expected{FenParser{"rnbqkbnr/pp2pppp/2P5/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3"}};
+    EXPECT_EQ(expected.get_key(), position.get_key());
+    EXPECT_EQ(expected.get_pawn_key(), position.get_pawn_key());
+    EXPECT_EQ(expected.get_evaluation(), position.get_evaluation());
+
+    for (auto move_it{moves.rbegin()}; move_it != moves.rend(); ++move_it)
+    {
+        position.unmake_move(*move_it);
+    }
+    EXPECT_EQ(starting_key, position.get_key());
+    EXPECT_EQ(starting_pawn_key, position.get_pawn_key());
+    EXPECT_EQ(starting_evaluation, position.get_evaluation());
+}
+
+TEST(position, key_matches_fen_after_castling_and_promotion)
+{
+    static constexpr auto FEN{"r3k2r/1P6/8/8/8/8/8/R3K2R w KQkq - 0 1"};
+    Position position{FenParser{FEN}};
+    const auto starting_key{position.get_key()};
+    const auto starting_pawn_key{position.get_pawn_key()};
+    const auto starting_evaluation{position.get_evaluation()};
+
+    const std::vector<Move> moves{
+        Move{Square::E1, Square::G1, MoveFlag::Castle},
+        Move{Square::E8, Square::C8, MoveFlag::Castle},
+        Move{Square::B7, Square::A8, MoveFlag::QueenPromotion},
+    };
+    for (const auto move : moves)
+    {
+        position.make_move(move);
+    }
+
+    const Position expected{FenParser{"Q1kr3r/8/8/8/8/8/8/R4RK1 b - - 0 2"}};
+    EXPECT_EQ(expected.get_key(), position.get_key());
+    EXPECT_EQ(expected.get_pawn_key(), position.get_pawn_key());
+    EXPECT_EQ(expected.get_evaluation(), position.get_evaluation());
+
+    for (auto move_it{moves.rbegin()}; move_it != moves.rend(); ++move_it)
+    {
+        position.unmake_move(*move_it);
+    }
+    EXPECT_EQ(starting_key, position.get_key());
+    EXPECT_EQ(starting_pawn_key, position.get_pawn_key());
+    EXPECT_EQ(starting_evaluation, position.get_evaluation());
+}
+
+TEST(position, evaluation_is_symmetric)
+{
+    EXPECT_EQ(0, Position{}.get_evaluation());
+
+    for (const auto &[fen, mirrored_fen] : MIRRORED_FENS)
+    {
+        const Position position{FenParser{fen}};
+        const Position mirrored_position{FenParser{mirrored_fen}};
+        EXPECT_NE(0, position.get_evaluation()) << fen;
+        EXPECT_EQ(position.get_evaluation(), -mirrored_position.get_evaluation()) << fen;
+    }
+
+    /* Nothing but an extra pawn */
+    EXPECT_GT(Position{FenParser{"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"}}.get_evaluation(), 0);
+}
+
+TEST(position, pawn_structure)
+{
+    const FenParser fen_parser{"4k3/3p4/8/4P3/7P/2P5/1P1P4/4K3 w - - 0 1"};
+    const BitBoards<Player::White> white_bit_boards{fen_parser};
+    const BitBoards<Player::Black> black_bit_boards{fen_parser};
+
+    const auto white_pawn_structure{white_bit_boards.get_pawn_structure(black_bit_boards)};
+    EXPECT_EQ(square_to_bit_board(Square::B2) | square_to_bit_board(Square::H4), white_pawn_structure.passed_bit_board);
+    EXPECT_EQ(square_to_bit_board(Square::H4), white_pawn_structure.isolated_bit_board);
+    EXPECT_EQ(0u, white_pawn_structure.doubled_bit_board);
+    EXPECT_EQ(0u, white_pawn_structure.backward_bit_board);
+
+    const auto black_pawn_structure{black_bit_boards.get_pawn_structure(white_bit_boards)};
+    EXPECT_EQ(0u, black_pawn_structure.passed_bit_board);
+    EXPECT_EQ(square_to_bit_board(Square::D7), black_pawn_structure.isolated_bit_board);
+    EXPECT_EQ(square_to_bit_board(Square::D7), black_pawn_structure.backward_bit_board);
+
+    /* Only the pawn behind counts as doubled */
+    const FenParser doubled_fen_parser{"4k3/8/8/8/8/2P5/2P5/4K3 w - - 0 1"};
+    const BitBoards<Player::White> doubled_bit_boards{doubled_fen_parser};
+    EXPECT_EQ(square_to_bit_board(Square::C2),
+              doubled_bit_boards.get_pawn_structure(BitBoards<Player::Black>{doubled_fen_parser}).doubled_bit_board);
+
+    /* Pawns on the second and third ranks in front of each file */
+    const auto pawn_shields{BitBoards<Player::White>{
+        FenParser{"4k3/8/8/8/8/5P2/5PPP/6K1 w - - 0 1"}}.get_pawn_shields()};
+    EXPECT_EQ(3, pawn_shields[File::FF]);
+    EXPECT_EQ(4, pawn_shields[File::FG]);
+    EXPECT_EQ(2, pawn_shields[File::FH]);
+    EXPECT_EQ(0, pawn_shields[File::FA]);
+}
+
+TEST(position, pawn_hash_table_caches_evaluation)
+{
+    PawnHashTable pawn_hash_table{};
+    const Position position{FenParser{"4k3/3p4/8/4P3/7P/2P5/1P1P4/4K3 w - - 0 1"}};
+    const auto evaluation{position.get_evaluation(pawn_hash_table)};
+    EXPECT_EQ(evaluation, position.get_evaluation(pawn_hash_table));
+    EXPECT_EQ(2u, pawn_hash_table.get_statistics().probes);
+    EXPECT_EQ(1u, pawn_hash_table.get_statistics().hits);
+
+    /* The passed pawns are worth more than the weak ones cost */
+    EXPECT_GT(evaluation, position.get_evaluation());
+
+    /* Moving the king keeps the pawn structure */
+    Position moved_position{position};
+    moved_position.make_move(Move{Square::E1, Square::F1});
+    EXPECT_EQ(position.get_pawn_key(), moved_position.get_pawn_key());
+    moved_position.get_evaluation(pawn_hash_table);
+    EXPECT_EQ(2u, pawn_hash_table.get_statistics().hits);
+}
+
+TEST(position, is_legal_matches_generated_moves)
+{
+    static const std::vector<std::string_view> FENS{
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/Pp2P3/2N2Q1p/1PPBBPPP/R3K2R b KQkq a3 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/8/8/K2pP2r/8/8/8/7k w - d6 0 1",
+        "4k3/8/8/8/8/8/3q4/R3K2R w KQ - 0 1",
+    };
+
+    for (const auto fen : FENS)
+    {
+        const Position position{FenParser{fen}};
+        const auto check_info{position.get_check_info()};
+        const auto moves{position.get_moves()};
+
+        for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+        {
+            for (SquareUnderlying to{0}; to < BOARD_SQUARES; ++to)
+            {
+                for (auto flag{MoveFlag::Normal}; flag <= MoveFlag::QueenPromotion; flag = MoveFlag(flag + 1))
+                {
+                    const Move move{from, to, flag};
+                    const auto is_generated{std::find(moves.begin(), moves.end(), move) != moves.end()};
+                    EXPECT_EQ(is_generated, position.is_legal(move, check_info)) << fen << ' ' << move;
+                }
+            }
+        }
+    }
+}
+
+TEST(position, static_exchange_evaluation)
+{
+    struct Exchange
+    {
+        std::string_view fen;
+        Move move;
+        Evaluation expected;
+    };
+
+    const std::vector<Exchange> exchanges{
+        /* Undefended pawn */
+        {"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", Move{Square::E1, Square::E5}, 1},
+        /* The rook behind wins the recapture */
+        {"3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1", Move{Square::D2, Square::D5}, 1},
+        /* Both sides have a rook behind, so the first one is lost for a pawn */
+        {"3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", Move{Square::D2, Square::D5}, -4},
+        /* The queen behind the bishop outlasts the rook and queen, so the knight only gets a pawn */
+        {"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", Move{Square::D3, Square::E5}, -2},
+        /* The king can't recapture once the rook behind the queen defends the square */
+        {"8/8/8/3k4/4p3/8/4Q3/4RK2 w - - 0 1", Move{Square::E2, Square::E4}, 1},
+        {"3r3k/4P3/8/8/8/8/8/K7 w - - 0 1", Move{Square::E7, Square::E8, MoveFlag::QueenPromotion}, -1},
+        {"3r3k/4P3/8/8/8/8/8/K7 w - - 0 1", Move{Square::E7, Square::D8, MoveFlag::QueenPromotion}, 13},
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", Move{Square::E5, Square::D6, MoveFlag::EnPassant}, 1},
+        {"4k3/8/8/8/8/8/8/R3K3 w Q - 0 1", Move{Square::E1, Square::C1, MoveFlag::Castle}, 0},
+    };
+
+    for (const auto &[fen, move, expected] : exchanges)
+    {
+        const Position position{FenParser{fen}};
+        EXPECT_EQ(expected, position.get_static_exchange_evaluation(move)) << fen;
+    }
+}
+
+TEST(position, null_move_flips_player_and_restores)
+{
+    static constexpr auto FEN{"rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3"};
+    Position position{FenParser{FEN}};
+    const auto starting_key{position.get_key()};
+
+    position.make_null_move();
+    const Position expected{FenParser{"rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3"}};
+    EXPECT_EQ(Player::White, position.get_current_player());
+    EXPECT_EQ(expected.get_key(), position.get_key());
+    EXPECT_FALSE(position.is_draw());
+
+    position.unmake_null_move();
+    EXPECT_EQ(Player::Black, position.get_current_player());
+    EXPECT_EQ(starting_key, position.get_key());
+    EXPECT_EQ(Position{FenParser{FEN}}.get_moves().size(), position.get_moves().size());
+}
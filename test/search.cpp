@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include "fen_parser.hpp"
+#include "parallel_search.hpp"
+#include "position.hpp"
+#include "search.hpp"
+#include "thread_pool.hpp"
+#include "transposition_table.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+SearchResult search_fen(std::string_view fen, const SearchLimits &limits, const SearchOptions &options = {})
+{
+    static constexpr std::size_t HASH_MEGABYTES{16};
+    TranspositionTable transposition_table{HASH_MEGABYTES, false};
+    Search search{transposition_table};
+    search.set_options(options);
+
+    return search.search(Position{FenParser{fen}}, limits);
+}
+
+SearchResult parallel_search_fen(std::string_view fen, const SearchLimits &limits)
+{
+    static constexpr std::size_t HASH_MEGABYTES{16};
+    static constexpr std::size_t NUM_THREADS{4};
+    ThreadPool thread_pool{NUM_THREADS};
+    TranspositionTable transposition_table{HASH_MEGABYTES, false};
+    ParallelSearch search{thread_pool, transposition_table};
+
+    return search.search(Position{FenParser{fen}}, limits);
+}
+} // namespace
+
+TEST(search, finds_mate_in_one)
+{
+    const auto result{search_fen("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", SearchLimits{3, std::nullopt, std::nullopt})};
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(Move(Square::A1, Square::A8), *result.best_move);
+    EXPECT_EQ(Search::MATE_SCORE - 1, result.score);
+}
+
+TEST(search, finds_mate_in_two)
+{
+    /*
+    The king has to take away a7 and b7 before the rook can mate on the back rank
+    */
+    const auto result{
+        search_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1", SearchLimits{5, std::nullopt, std::nullopt})};
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(Search::MATE_SCORE - 3, result.score);
+    EXPECT_EQ(3u, result.principal_variation.size());
+}
+
+TEST(search, wins_hanging_queen)
+{
+    const auto result{
+        search_fen("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", SearchLimits{4, std::nullopt, std::nullopt})};
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(Move(Square::D2, Square::D5), *result.best_move);
+}
+
+TEST(search, sees_recapture_beyond_horizon)
+{
+    /*
+    At depth 1 the queen takes the pawn unless quiescence search finds the pawn taking back
+    */
+    const auto result{search_fen("4k3/8/3p4/4p3/8/8/8/4QK2 w - - 0 1", SearchLimits{1, std::nullopt, std::nullopt})};
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_NE(Move(Square::E1, Square::E5), *result.best_move);
+    EXPECT_GE(result.score, 0);
+}
+
+TEST(search, finds_tactics_with_each_pruning_technique_off)
+{
+    std::vector<SearchOptions> options_list(5);
+    options_list[1].use_null_move_pruning = false;
+    options_list[2].use_late_move_reductions = false;
+    options_list[3].use_reverse_futility_pruning = false;
+    options_list[4].use_futility_pruning = false;
+
+    for (const auto &options : options_list)
+    {
+        const auto mate_result{
+            search_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1", SearchLimits{5, std::nullopt, std::nullopt}, options)};
+        EXPECT_EQ(Search::MATE_SCORE - 3, mate_result.score);
+
+        const auto queen_result{
+            search_fen("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", SearchLimits{4, std::nullopt, std::nullopt}, options)};
+        ASSERT_TRUE(queen_result.best_move.has_value());
+        EXPECT_EQ(Move(Square::D2, Square::D5), *queen_result.best_move);
+    }
+}
+
+TEST(search, principal_variation_is_legal)
+{
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    const auto result{search_fen(FEN, SearchLimits{5, std::nullopt, std::nullopt})};
+
+    ASSERT_FALSE(result.principal_variation.empty());
+    EXPECT_EQ(*result.best_move, result.principal_variation.front());
+
+    Position position{FenParser{FEN}};
+    for (const auto move : result.principal_variation)
+    {
+        ASSERT_TRUE(position.is_legal(move, position.get_check_info())) << move;
+        position.make_move(move);
+    }
+}
+
+TEST(search, stalemate_has_no_move)
+{
+    const auto result{search_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", SearchLimits{3, std::nullopt, std::nullopt})};
+
+    EXPECT_FALSE(result.best_move.has_value());
+    EXPECT_EQ(0, result.score);
+}
+
+TEST(search, stops_at_limits)
+{
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+
+    static constexpr std::uint64_t MAX_NODES{100000};
+    const auto nodes_result{search_fen(FEN, SearchLimits{std::nullopt, MAX_NODES, std::nullopt})};
+    EXPECT_TRUE(nodes_result.best_move.has_value());
+    EXPECT_LE(nodes_result.nodes, MAX_NODES + 1024);
+
+    const std::chrono::milliseconds max_time{100};
+    const auto time_result{search_fen(FEN, SearchLimits{std::nullopt, std::nullopt, max_time})};
+    EXPECT_TRUE(time_result.best_move.has_value());
+    EXPECT_LT(time_result.elapsed, std::chrono::milliseconds{500});
+}
+
+TEST(search, refuses_roots_without_room_to_search)
+{
+    /* The knights go out and back, so the history grows while the position stays the same */
+    const std::vector<Move> moves{Move(Square::G1, Square::F3), Move(Square::G8, Square::F6),
+                                  Move(Square::F3, Square::G1), Move(Square::F6, Square::G8)};
+    Position position{};
+    while (position.get_undo_depth() + Search::MAX_PLY < Position::MAX_UNDO_DEPTH)
+    {
+        position.make_move(moves[position.get_undo_depth() % moves.size()]);
+    }
+
+    static constexpr std::size_t HASH_MEGABYTES{16};
+    static constexpr std::size_t NUM_THREADS{2};
+    const SearchLimits limits{1, std::nullopt, std::nullopt};
+    TranspositionTable transposition_table{HASH_MEGABYTES, false};
+    Search search{transposition_table};
+    ThreadPool thread_pool{NUM_THREADS};
+    ParallelSearch parallel_search{thread_pool, transposition_table};
+    EXPECT_TRUE(search.search(position, limits).best_move.has_value());
+    EXPECT_TRUE(parallel_search.search(position, limits).best_move.has_value());
+
+    position.make_move(moves[position.get_undo_depth() % moves.size()]);
+    EXPECT_THROW(search.search(position, limits), std::logic_error);
+    EXPECT_THROW(parallel_search.search(position, limits), std::logic_error);
+}
+
+TEST(search, parallel_finds_mate_in_two)
+{
+    const auto result{
+        parallel_search_fen("k7/8/2K5/8/8/8/8/7R w - - 0 1", SearchLimits{5, std::nullopt, std::nullopt})};
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(Search::MATE_SCORE - 3, result.score);
+}
+
+TEST(search, parallel_principal_variation_is_legal)
+{
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    const auto result{parallel_search_fen(FEN, SearchLimits{6, std::nullopt, std::nullopt})};
+
+    ASSERT_FALSE(result.principal_variation.empty());
+    EXPECT_EQ(6, result.depth);
+
+    Position position{FenParser{FEN}};
+    for (const auto move : result.principal_variation)
+    {
+        ASSERT_TRUE(position.is_legal(move, position.get_check_info())) << move;
+        position.make_move(move);
+    }
+}
+
+TEST(search, parallel_stops_at_limits)
+{
+    static constexpr auto FEN{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+
+    const std::chrono::milliseconds max_time{100};
+    const auto result{parallel_search_fen(FEN, SearchLimits{std::nullopt, std::nullopt, max_time})};
+    EXPECT_TRUE(result.best_move.has_value());
+    EXPECT_LT(result.elapsed, std::chrono::milliseconds{500});
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "slider_attacks.hpp"
+
+#include <bit>
+#include <random>
+
+namespace
+{
+/*
+Deliberately naive so it shares nothing with how the lookups are built
+*/
+BitBoard walk_attacks(SquareUnderlying from, BitBoard occupied_bit_board, int rank_step, int file_step)
+{
+    BitBoard attacks_bit_board{0};
+    auto rank{static_cast<int>(from / BOARD_WIDTH) + rank_step};
+    auto file{static_cast<int>(from % BOARD_WIDTH) + file_step};
+    while (rank >= 0 && rank < BOARD_WIDTH && file >= 0 && file < BOARD_WIDTH)
+    {
+        const auto bit_board{BitBoard{1} << (rank * BOARD_WIDTH + file)};
+        attacks_bit_board |= bit_board;
+        if (occupied_bit_board & bit_board)
+        {
+            break;
+        }
+
+        rank += rank_step;
+        file += file_step;
+    }
+
+    return attacks_bit_board;
+}
+} // namespace
+
+TEST(slider_attacks, empty_board)
+{
+    EXPECT_EQ(BitBoard{0x01010101010101FE}, SliderAttacks::get_rook_attacks_bit_board(Square::A1, 0));
+    EXPECT_EQ(BitBoard{0x8040201008040200}, SliderAttacks::get_bishop_attacks_bit_board(Square::A1, 0));
+    EXPECT_EQ(27, std::popcount(SliderAttacks::get_queen_attacks_bit_board(Square::D4, 0)));
+}
+
+TEST(slider_attacks, between_and_line)
+{
+    EXPECT_EQ(BitBoard{0x0040201008040200}, SliderAttacks::get_between_bit_board(Square::A1, Square::H8));
+    EXPECT_EQ(BitBoard{0x0040201008040200}, SliderAttacks::get_between_bit_board(Square::H8, Square::A1));
+    EXPECT_EQ(BitBoard{0x000000000000007E}, SliderAttacks::get_between_bit_board(Square::H1, Square::A1));
+    EXPECT_EQ(BitBoard{0}, SliderAttacks::get_between_bit_board(Square::A1, Square::B1));
+    EXPECT_EQ(BitBoard{0}, SliderAttacks::get_between_bit_board(Square::A1, Square::B3));
+
+    EXPECT_EQ(BitBoard{0x8040201008040201}, SliderAttacks::get_line_bit_board(Square::C3, Square::E5));
+    EXPECT_EQ(BitBoard{0x0101010101010101}, SliderAttacks::get_line_bit_board(Square::A8, Square::A2));
+    EXPECT_EQ(BitBoard{0}, SliderAttacks::get_line_bit_board(Square::A1, Square::B3));
+}
+
+TEST(slider_attacks, matches_ray_walk_for_random_occupancies)
+{
+    std::mt19937_64 random{0};
+    for (auto iteration{0}; iteration < 10000; ++iteration)
+    {
+        /*
+        Sparse occupancies are more like real positions than uniformly random ones
+        */
+        const auto occupied_bit_board{random() & random()};
+        for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+        {
+            const auto bishop_attacks_bit_board{
+                walk_attacks(from, occupied_bit_board, 1, 1) | walk_attacks(from, occupied_bit_board, 1, -1) |
+                walk_attacks(from, occupied_bit_board, -1, 1) | walk_attacks(from, occupied_bit_board, -1, -1)};
+            const auto rook_attacks_bit_board{
+                walk_attacks(from, occupied_bit_board, 1, 0) | walk_attacks(from, occupied_bit_board, -1, 0) |
+                walk_attacks(from, occupied_bit_board, 0, 1) | walk_attacks(from, occupied_bit_board, 0, -1)};
+
+            ASSERT_EQ(bishop_attacks_bit_board, SliderAttacks::get_bishop_attacks_bit_board(from, occupied_bit_board));
+            ASSERT_EQ(rook_attacks_bit_board, SliderAttacks::get_rook_attacks_bit_board(from, occupied_bit_board));
+        }
+    }
+}
+
+TEST(slider_attacks, pext_matches_magics)
+{
+    if (!SliderAttacks::is_backend_supported(SliderAttacksBackend::Pext))
+    {
+        GTEST_SKIP();
+    }
+
+    std::mt19937_64 random{1};
+    for (auto iteration{0}; iteration < 10000; ++iteration)
+    {
+        const auto occupied_bit_board{random() & random()};
+        for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+        {
+            const auto magic_bishop_attacks_bit_board{
+                SliderAttacks::get_bishop_attacks_bit_board<SliderAttacksBackend::Magics>(from, occupied_bit_board)};
+            const auto magic_rook_attacks_bit_board{
+                SliderAttacks::get_rook_attacks_bit_board<SliderAttacksBackend::Magics>(from, occupied_bit_board)};
+
+            ASSERT_EQ(
+                magic_bishop_attacks_bit_board,
+                SliderAttacks::get_bishop_attacks_bit_board<SliderAttacksBackend::Pext>(from, occupied_bit_board));
+            ASSERT_EQ(magic_rook_attacks_bit_board,
+                      SliderAttacks::get_rook_attacks_bit_board<SliderAttacksBackend::Pext>(from, occupied_bit_board));
+        }
+    }
+}
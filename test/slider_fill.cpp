@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include "slider_attacks.hpp"
+#include "slider_fill.hpp"
+
+#include <random>
+
+namespace
+{
+BitBoard get_lookup_attacks_bit_board(BitBoard diagonal_sliders_bit_board, BitBoard orthogonal_sliders_bit_board,
+                                      BitBoard occupied_bit_board)
+{
+    BitBoard attacks_bit_board{0};
+    for (SquareUnderlying from{0}; from < BOARD_SQUARES; ++from)
+    {
+        const auto from_bit_board{square_to_bit_board(Square{from})};
+        if (diagonal_sliders_bit_board & from_bit_board)
+        {
+            attacks_bit_board |= SliderAttacks::get_bishop_attacks_bit_board(from, occupied_bit_board);
+        }
+        if (orthogonal_sliders_bit_board & from_bit_board)
+        {
+            attacks_bit_board |= SliderAttacks::get_rook_attacks_bit_board(from, occupied_bit_board);
+        }
+    }
+
+    return attacks_bit_board;
+}
+
+template <SliderFillBackend backend> void expect_matches_lookups()
+{
+    std::mt19937_64 random{0};
+    for (auto iteration{0}; iteration < 100000; ++iteration)
+    {
+        const auto occupied_bit_board{random() & random()};
+        const auto diagonal_sliders_bit_board{occupied_bit_board & random() & random()};
+        const auto orthogonal_sliders_bit_board{occupied_bit_board & random() & random()};
+
+        ASSERT_EQ(
+            get_lookup_attacks_bit_board(diagonal_sliders_bit_board, orthogonal_sliders_bit_board, occupied_bit_board),
+            SliderFill::get_attacks_bit_board<backend>(diagonal_sliders_bit_board, orthogonal_sliders_bit_board,
+                                                       occupied_bit_board));
+    }
+}
+} // namespace
+
+TEST(slider_fill, scalar_matches_lookups)
+{
+    expect_matches_lookups<SliderFillBackend::ScalarFill>();
+}
+
+TEST(slider_fill, avx2_matches_lookups)
+{
+    if (!SliderFill::is_backend_supported(SliderFillBackend::Avx2Fill))
+    {
+        GTEST_SKIP();
+    }
+
+    expect_matches_lookups<SliderFillBackend::Avx2Fill>();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+/*
+A file in the temporary directory that's removed again at the end of the test. The process id goes in its name, so
+test binaries running at the same time don't write over each other's files.
+*/
+class TemporaryFile
+{
+  public:
+    TemporaryFile(std::string_view name, const std::string &contents)
+        : path{std::filesystem::temp_directory_path() / (std::string{name} + '_' + std::to_string(getpid()))}
+    {
+        std::ofstream{path, std::ios::binary} << contents;
+    }
+
+    ~TemporaryFile()
+    {
+        std::filesystem::remove(path);
+    }
+
+    TemporaryFile(const TemporaryFile &) = delete;
+    TemporaryFile &operator=(const TemporaryFile &) = delete;
+
+    std::string get_path() const
+    {
+        return path.string();
+    }
+
+  private:
+    std::filesystem::path path;
+};
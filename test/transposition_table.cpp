@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "transposition_table.hpp"
+
+TEST(transposition_table, probe_returns_stored_entry)
+{
+    TranspositionTable transposition_table{1};
+    static constexpr ZobristKey KEY{0x0123456789ABCDEF};
+
+    EXPECT_FALSE(transposition_table.probe(KEY).has_value());
+
+    transposition_table.store(KEY, {Move{Square::E2, Square::E4, MoveFlag::DoublePush}, -123, 45, 7,
+                                    Bound::LowerBound});
+    const auto entry{transposition_table.probe(KEY)};
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_TRUE(entry->move == Move(Square::E2, Square::E4, MoveFlag::DoublePush));
+    EXPECT_EQ(-123, entry->score);
+    EXPECT_EQ(45, entry->static_evaluation);
+    EXPECT_EQ(7, entry->depth);
+    EXPECT_EQ(Bound::LowerBound, entry->bound);
+
+    /*
+    Same bucket, different key
+    */
+    EXPECT_FALSE(transposition_table.probe(KEY ^ (ZobristKey{1} << 63)).has_value());
+}
+
+TEST(transposition_table, replaces_shallowest_entry_when_bucket_full)
+{
+    TranspositionTable transposition_table{1};
+    static constexpr ZobristKey BUCKET_BITS{0x2A};
+    static constexpr auto NUM_KEYS{5};
+
+    /*
+    Keys share the low bits so they all land in one bucket, the shallowest should be evicted by the last store
+    */
+    for (ZobristKey key_idx{0}; key_idx < NUM_KEYS; ++key_idx)
+    {
+        const auto key{BUCKET_BITS | ((key_idx + 1) << 40)};
+        const auto depth{static_cast<std::uint8_t>(key_idx == 1 ? 1 : 10 + key_idx)};
+        transposition_table.store(key, {Move{Square::A2, Square::A3}, 0, 0, depth, Bound::ExactBound});
+    }
+
+    EXPECT_FALSE(transposition_table.probe(BUCKET_BITS | (ZobristKey{2} << 40)).has_value());
+    for (ZobristKey key_idx : {0, 2, 3, 4})
+    {
+        EXPECT_TRUE(transposition_table.probe(BUCKET_BITS | ((key_idx + 1) << 40)).has_value());
+    }
+}